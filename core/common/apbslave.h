@@ -44,11 +44,25 @@ class sr_register_amba_socket : public ::amba::amba_slave_socket<BUSWIDTH>, publ
 
     void b_transport(tlm::tlm_generic_payload& gp, sc_core::sc_time&) {
       ADDR_TYPE address = gp.get_address() - get_base_addr();
-      ADDR_TYPE byteaddr = address & 0x3;
-      address = address & ~0x3;
       ADDR_TYPE length = gp.get_data_length();
       DATA_TYPE *data = reinterpret_cast<DATA_TYPE *>(gp.get_data_ptr());
 
+      // Bursts of whole words are carried out register by register
+      if ((length > 4) && !((address | length) & 0x3)) {
+        for (ADDR_TYPE i = 0; i < (length >> 2); i++) {
+          bus_access(gp, address + (i << 2), 4, data + i);
+        }
+      } else {
+        bus_access(gp, address, length, data);
+      }
+      gp.set_response_status(tlm::TLM_OK_RESPONSE);
+    }
+
+    /// Reads or writes one register of the bank
+    void bus_access(tlm::tlm_generic_payload& gp, ADDR_TYPE address, ADDR_TYPE length, DATA_TYPE *data) {
+      ADDR_TYPE byteaddr = address & 0x3;
+      address = address & ~0x3;
+
       if (gp.is_write()) {
         //*data = 0;
 
@@ -80,7 +94,6 @@ class sr_register_amba_socket : public ::amba::amba_slave_socket<BUSWIDTH>, publ
         *data >>= (byteaddr << 3);
       }
       srInfo()("offset", address)("length", length)("data", data)("write", gp.is_write())("byte", byteaddr)(__PRETTY_FUNCTION__);
-      gp.set_response_status(tlm::TLM_OK_RESPONSE);
     }
 
     /*gs::amba::amba_slave<BUSWIDTH>& operator()() {
@@ -118,6 +118,7 @@ class irqmp_rst_stimuli : sc_core::sc_module {
 
 int sc_main(int argc, char** argv) {
     clock_t cstart, cend;
+    clock_t estart = clock();
     std::string prom_app;
     sr_report_handler::handler = sr_report_handler::default_handler;
 
@@ -211,6 +212,7 @@ int sc_main(int argc, char** argv) {
     gs::gs_param<bool> p_ahbctrl_split("split", false, p_ahbctrl);
     gs::gs_param<bool> p_ahbctrl_fpnpen("fpnpen", true, p_ahbctrl);
     gs::gs_param<bool> p_ahbctrl_mcheck("mcheck", true, p_ahbctrl);
+    gs::gs_param<bool> p_ahbctrl_decoupled("decoupled", false, p_ahbctrl);
 
     AHBCtrl ahbctrl("ahbctrl",
 		    p_ahbctrl_ioaddr,                // The MSB address of the I/O area
@@ -231,6 +233,10 @@ int sc_main(int argc, char** argv) {
     // Set clock
     ahbctrl.set_clk(p_system_clock, SC_NS);
 
+    // LT transfers return their delay to the master instead of waiting;
+    // bus contention is charged as annotated delay
+    ahbctrl.g_decoupled = static_cast<bool>(p_ahbctrl_decoupled);
+
     // AHBSlave - APBCtrl
     // ==================
 
@@ -514,6 +520,10 @@ int sc_main(int argc, char** argv) {
     gs::gs_param<unsigned int> p_mmu_cache_dlram_size("size", 0u, p_mmu_cache_dlram);
     gs::gs_param<unsigned int> p_mmu_cache_dlram_start("start", 0u, p_mmu_cache_dlram);
     gs::gs_param<unsigned int> p_mmu_cache_cached("cached", 0u, p_mmu_cache);
+    gs::gs_param_array p_mmu_cache_wb("wb", p_mmu_cache);
+    gs::gs_param<unsigned int> p_mmu_cache_wb_depth("depth", 4u, p_mmu_cache_wb);
+    gs::gs_param<unsigned int> p_mmu_cache_wb_policy("policy", 0u, p_mmu_cache_wb);
+    gs::gs_param<bool> p_mmu_cache_dmi("dmi", false, p_mmu_cache);
     gs::gs_param<unsigned int> p_mmu_cache_index("index", 0u, p_mmu_cache);
     gs::gs_param_array p_mmu_cache_mmu("mmu", p_mmu_cache);
     gs::gs_param<bool> p_mmu_cache_mmu_en("en", true, p_mmu_cache_mmu);
@@ -522,8 +532,17 @@ int sc_main(int argc, char** argv) {
     gs::gs_param<unsigned int> p_mmu_cache_mmu_tlb_type("tlb_type", 1u, p_mmu_cache_mmu);
     gs::gs_param<unsigned int> p_mmu_cache_mmu_tlb_rep("tlb_rep", 1, p_mmu_cache_mmu);
     gs::gs_param<unsigned int> p_mmu_cache_mmu_mmupgsz("mmupgsz", 0u, p_mmu_cache_mmu);
+    gs::gs_param<bool> p_mmu_cache_mmu_shadow("shadow", false, p_mmu_cache_mmu);
+    gs::gs_param<std::string> p_mmu_cache_trace("trace", "", p_mmu_cache);
 
     gs::gs_param<std::string> p_proc_history("history", "", p_system);
+    gs::gs_param<bool> p_proc_blockcache("blockcache", false, p_system);
+    gs::gs_param<bool> p_proc_predecode("predecode", false, p_system);
+    gs::gs_param<bool> p_proc_fetchbuffer("fetchbuffer", false, p_system);
+    gs::gs_param<bool> p_proc_parallel("parallel", false, p_system);
+    gs::gs_param<unsigned int> p_proc_quantum("quantum", 100, p_system);
+    gs::gs_param<unsigned int> p_proc_maxquantum("maxquantum", 6400, p_system);
+    gs::gs_param<bool> p_proc_adaptivequantum("adaptivequantum", false, p_system);
 
     gs::gs_param_array p_gdb("gdb", p_conf);
     gs::gs_param<bool> p_gdb_en("en", false, p_gdb);
@@ -583,6 +602,49 @@ int sc_main(int argc, char** argv) {
         leon3->g_history = history;
       }
 
+      // Basic block execution engine
+      leon3->cpu.blockCacheEnabled = static_cast<bool>(p_proc_blockcache);
+      leon3->cpu.predecodeEnabled = static_cast<bool>(p_proc_predecode);
+
+      // Issue each quantum on a host worker thread of its own
+      leon3->cpu.parallelEnabled = static_cast<bool>(p_proc_parallel);
+
+      // Quantum in clock cycles; the adaptive quantum grows up to maxquantum
+      // while no interrupts and no snoops occur
+      leon3->cpu.quantumCycles = static_cast<unsigned int>(p_proc_quantum);
+      leon3->cpu.maxQuantumCycles = static_cast<unsigned int>(p_proc_maxquantum);
+      leon3->cpu.adaptiveQuantum = static_cast<bool>(p_proc_adaptivequantum);
+
+      // Instruction fetch line buffer
+      leon3->g_fetchbuffer = static_cast<bool>(p_proc_fetchbuffer);
+
+      // Coalescing write buffer: burst window in words and drain policy
+      // (0 every store on its own, 1 drain when a store does not fit,
+      // 2 drain full windows right away)
+      leon3->g_wbdepth = static_cast<unsigned int>(p_mmu_cache_wb_depth);
+      leon3->g_wbpolicy = static_cast<unsigned int>(p_mmu_cache_wb_policy);
+
+      // Line refills and uncached reads from memory with memcpy (LT only)
+      leon3->g_dmi = static_cast<bool>(p_mmu_cache_dmi);
+
+      // Stores issued on the cpu thread, only if the bus does not wait
+      leon3->g_posted = static_cast<bool>(p_ahbctrl_decoupled);
+
+      // Loads hitting in the data cache on translated pages of cacheable
+      // memory served from host pointers (needs dmi and an enabled mmu)
+      leon3->g_shadow = static_cast<bool>(p_mmu_cache_mmu_shadow);
+
+      // Cache access trace for the cachereplay tool; one file per cpu
+      std::string trace = p_mmu_cache_trace;
+      if(!trace.empty()) {
+        if(p_system_ncpu > 1) {
+          stringstream suffix;
+          suffix << "." << i;
+          trace += suffix.str();
+        }
+        leon3->g_trace = trace;
+      }
+
       connect(irqmp.irq_req, leon3->cpu.IRQ_port.irq_signal, i);
       connect(leon3->cpu.irqAck.initSignal, irqmp.irq_ack, i);
       connect(leon3->cpu.irqAck.run, irqmp.cpu_rst, i);
@@ -1066,9 +1128,11 @@ int sc_main(int argc, char** argv) {
 //    muntrace();
     cend = clock();
 
+    v::report << "Summary" << "Elaboration: " << dec << setprecision(4) << ((double)(cstart - estart) / (double)CLOCKS_PER_SEC * 1000) << "ms" << v::endl;
     v::report << "Summary" << "Start: " << dec << cstart << v::endl;
     v::report << "Summary" << "End:   " << dec << cend << v::endl;
     v::report << "Summary" << "Delta: " << dec << setprecision(4) << ((double)(cend - cstart) / (double)CLOCKS_PER_SEC * 1000) << "ms" << v::endl;
+    v::report << "Summary" << "Simulated: " << sc_core::sc_time_stamp() << v::endl;
     return first_leon->cpu.getInterface().getExitValue();
 }
 /// @}
@@ -0,0 +1,69 @@
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+
+/* Micro-benchmark for the cache model: a sequential sweep which hits in
+   the data cache, a strided sweep which misses on every line and a walk
+   over more lines of one set than the cache has ways, which exercises the
+   tag compare and the replacement of every way. */
+
+#define WORDS 8192
+
+unsigned long buffer[WORDS];
+
+unsigned long sweep(long, long);
+unsigned long conflict(long, long);
+
+unsigned long sweep(stride, words)
+long stride, words;
+{
+ unsigned long sum = 0;
+ long i;
+ for (i = 0; i < words; i += stride) {
+  sum += buffer[i];
+  buffer[i] = sum;
+ }
+ return(sum);
+}
+
+unsigned long conflict(waysize, ways)
+long waysize, ways;
+{
+ unsigned long sum = 0;
+ long i, j;
+ for (i = 0; i < 64; i++) {
+  for (j = 0; j <= ways; j++) {
+   sum += buffer[(j * waysize + i) % WORDS];
+  }
+ }
+ return(sum);
+}
+
+int main()
+{
+ register unsigned long IMax,i,value;
+
+ #ifdef SHORT_BENCH
+ IMax = 20;
+ #else
+ IMax = 200;
+ #endif
+
+ printf("\n");
+ printf("Cache Tag and Replacement Benchmark\n");
+
+ for (i = 0; i < WORDS; i++) {
+  buffer[i] = i;
+ }
+
+ value = 0;
+ for (i = 0; i < IMax; i++) {
+  value += sweep(1, 2048);
+  value += sweep(8, WORDS);
+  value += conflict(1024, 4);
+ }
+
+ printf("\n");
+ printf("The checksum after %ld iterations is: %lu\n",IMax,value);
+  return 0;
+}
@@ -0,0 +1,66 @@
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+
+/* Micro-benchmark for the read miss path of the simulator: a pointer
+   chase along a random cycle through a list which is much larger than
+   the data cache. Every node lives in a cache line of its own, so nearly
+   every load of the chase misses and goes to the SDRAM. */
+
+#define NODES 8192
+
+struct node {
+ struct node *next;
+ unsigned long value;
+ unsigned long pad[6];
+};
+
+struct node list[NODES];
+unsigned int order[NODES];
+
+int main()
+{
+ register unsigned long IMax,i,j,value;
+ register struct node *p;
+ unsigned long seed;
+ unsigned int k,tmp;
+
+ #ifdef SHORT_BENCH
+ IMax = 2;
+ #else
+ IMax = 20;
+ #endif
+
+ printf("\n");
+ printf("Pointer Chasing Benchmark\n");
+
+ /* Random cyclic permutation of the nodes (Sattolo) */
+ seed = 12345;
+ for (k = 0; k < NODES; k++) {
+  order[k] = k;
+ }
+ for (k = NODES - 1; k > 0; k--) {
+  seed = seed * 1103515245UL + 12345UL;
+  j = (seed >> 8) % k;
+  tmp = order[k];
+  order[k] = order[j];
+  order[j] = tmp;
+ }
+ for (k = 0; k < NODES; k++) {
+  list[order[k]].next = &list[order[(k + 1) % NODES]];
+  list[order[k]].value = k;
+ }
+
+ value = 0;
+ p = &list[0];
+ for (i = 0; i < IMax; i++) {
+  for (j = 0; j < NODES; j++) {
+   value += p->value;
+   p = p->next;
+  }
+ }
+
+ printf("\n");
+ printf("The checksum after %ld iterations is: %lu\n",IMax,value);
+  return 0;
+}
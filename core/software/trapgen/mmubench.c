@@ -0,0 +1,71 @@
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+
+/* Micro-benchmark for loads with the SRMMU enabled: the program maps the
+   address space one to one with 16 MB level-1 pages and then repeatedly
+   sums a table which fits into the data cache, so that nearly every load
+   is a cache hit through a valid TLB entry. */
+
+#define WORDS 1024
+
+/* Context table and level-1 page table of the identity mapping */
+unsigned long ctxtable[256] __attribute__((aligned(0x1000)));
+unsigned long pgtable[256] __attribute__((aligned(0x1000)));
+
+unsigned long table[WORDS];
+
+static void mmu_write(unsigned long addr, unsigned long value)
+{
+ asm volatile("sta %0, [%1] 0x19" : : "r" (value), "r" (addr) : "memory");
+}
+
+static void mmu_enable(void)
+{
+ unsigned long i;
+
+ /* PTE: physical page number, cacheable (RAM only), ACC 3 (RWX) */
+ for (i = 0; i < 256; i++) {
+  pgtable[i] = ((i << 24) >> 4) | (3 << 2) | 2;
+  if (i >= 0x40 && i < 0x50) {
+   pgtable[i] |= 1 << 7;
+  }
+ }
+ /* PTD of context 0 */
+ ctxtable[0] = (((unsigned long)pgtable) >> 4) | 1;
+
+ mmu_write(0x100, ((unsigned long)ctxtable) >> 4);
+ mmu_write(0x200, 0);
+ mmu_write(0x000, 1);
+}
+
+int main()
+{
+ register unsigned long IMax,i,j,value;
+
+ #ifdef SHORT_BENCH
+ IMax = 20;
+ #else
+ IMax = 200;
+ #endif
+
+ printf("\n");
+ printf("MMU Load Benchmark\n");
+
+ mmu_enable();
+
+ for (j = 0; j < WORDS; j++) {
+  table[j] = j * 2654435761UL;
+ }
+
+ value = 0;
+ for (i = 0; i < IMax; i++) {
+  for (j = 0; j < WORDS; j++) {
+   value += table[j] ^ i;
+  }
+ }
+
+ printf("\n");
+ printf("The checksum after %ld iterations is: %lu\n",IMax,value);
+  return 0;
+}
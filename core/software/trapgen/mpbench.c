@@ -0,0 +1,103 @@
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+
+/* Scaling benchmark for multi-core platforms: every processor runs the
+   same private integer kernel on its own data, so the simulated work
+   grows linearly with the number of cores. Each processor starts the
+   program from the reset vector; the secondaries are woken through the
+   multiprocessor status register of the interrupt controller. */
+
+asm(
+"	.text\n"
+"	.align 4\n"
+"get_pid:\n"
+"        mov  %asr17, %o0\n"
+"        srl  %o0, 28, %o0\n"
+"        retl\n"
+"        and %o0, 0xf, %o0\n"
+);
+
+int get_pid(void);
+
+#define IRQMP_MPSTAT ((volatile unsigned int *)0x80000210)
+#define MAXCPU 16
+
+/* Initialized so that they are placed in .data and survive the
+   clearing of .bss done by every processor in its startup code */
+volatile int pstart[MAXCPU + 1] = {0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1};
+volatile int pdone[MAXCPU + 1] = {0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1};
+volatile unsigned long presult[MAXCPU + 1] = {0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1};
+
+static void psync(volatile int arr[], int n, int ncpu)
+{
+  int i, go;
+
+  arr[n] = 1;
+  do {
+    go = 1;
+    for (i = 0; i < ncpu; i++)
+      if (!arr[i]) go = 0;
+  } while (!go);
+}
+
+static unsigned long kernel(unsigned long seed, long iterations)
+{
+ unsigned long buf[64];
+ unsigned long x = seed, sum = 0;
+ long i, j;
+
+ for (j = 0; j < 64; j++) {
+  x = x * 1103515245UL + 12345UL;
+  buf[j] = x;
+ }
+ for (i = 0; i < iterations; i++) {
+  for (j = 0; j < 64; j++) {
+   x = buf[(j + x) & 63] ^ (x >> 3);
+   buf[j] += x;
+   sum += (x & 1) ? x : (x >> 1);
+  }
+ }
+ return(sum);
+}
+
+int main()
+{
+ int id, i, ncpu;
+ long IMax;
+ unsigned long value;
+
+ #ifdef SHORT_BENCH
+ IMax = 500;
+ #else
+ IMax = 5000;
+ #endif
+
+ /* The interrupt controller of the platform reports the number of
+    processors in bits 31..28 of the multiprocessor status register */
+ ncpu = (*IRQMP_MPSTAT >> 28) & 0x0f;
+ if (ncpu < 1) ncpu = 1;
+ id = get_pid();
+
+ if (id == 0) {
+  *IRQMP_MPSTAT = (1 << ncpu) - 1;
+ }
+ psync(pstart, id, ncpu);
+
+ presult[id] = kernel(2654435761UL * (id + 1), IMax);
+
+ psync(pdone, id, ncpu);
+ if (id != 0) {
+  for (;;);
+ }
+
+ value = 0;
+ for (i = 0; i < ncpu; i++) {
+  value += presult[i];
+ }
+
+ printf("\n");
+ printf("Multiprocessor Scaling Benchmark on %d processors\n", ncpu);
+ printf("The checksum after %ld iterations is: %lu\n", IMax, value);
+ return 0;
+}
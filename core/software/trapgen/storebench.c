@@ -0,0 +1,57 @@
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+
+/* Micro-benchmark for the store path of the simulator: block fills and
+   copies with the library routines and a recursion which spills its
+   register windows to the stack. Nearly every store of the benchmark
+   goes through the write-through data cache to the bus. */
+
+#define BYTES 4096
+
+char src[BYTES];
+char dst[BYTES];
+
+unsigned long spill(long);
+
+unsigned long spill(x)
+long x;
+{
+ volatile unsigned long local[4];
+ local[0] = x;
+ local[1] = x << 1;
+ local[2] = x << 2;
+ local[3] = x << 3;
+ if (x > 0)
+  return(spill(x-1)+local[0]+local[3]);
+ else
+  return(local[1]+local[2]);
+}
+
+int main()
+{
+ register unsigned long IMax,i,j,value;
+
+ #ifdef SHORT_BENCH
+ IMax = 20;
+ #else
+ IMax = 200;
+ #endif
+
+ printf("\n");
+ printf("Store Benchmark\n");
+
+ value = 0;
+ for (i = 0; i < IMax; i++) {
+  memset(src, (int)i, BYTES);
+  memcpy(dst, src, BYTES);
+  for (j = 0; j < BYTES; j += 256) {
+   value += (unsigned char)dst[j];
+  }
+  value += spill(32);
+ }
+
+ printf("\n");
+ printf("The checksum after %ld iterations is: %lu\n",IMax,value);
+  return 0;
+}
@@ -0,0 +1,60 @@
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+
+/* Micro-benchmark for the control flow of the simulator: the recursion
+   overflows and underflows the register windows on almost every call and
+   return, and the classification loop is dominated by short conditional
+   branches, most of them with annulled delay slots. */
+
+unsigned long depth(long);
+unsigned long classify(unsigned long);
+
+unsigned long depth(x)
+long x;
+{
+ if (x > 0)
+  return(depth(x-1)+x);
+ else
+  return(0);
+}
+
+unsigned long classify(x)
+unsigned long x;
+{
+ unsigned long count = 0;
+ while (x != 0) {
+  if (x & 1)
+   count += 3;
+  else if (x & 2)
+   count += 5;
+  else
+   count++;
+  x >>= 1;
+ }
+ return(count);
+}
+
+int main()
+{
+ register unsigned long IMax,i,value;
+
+ #ifdef SHORT_BENCH
+ IMax = 2000;
+ #else
+ IMax = 20000;
+ #endif
+
+ printf("\n");
+ printf("Window Trap and Branch Benchmark\n");
+
+ value = 0;
+ for (i = 0; i < IMax; i++) {
+  value += depth(32);
+  value += classify(i * 2654435761UL);
+ }
+
+ printf("\n");
+ printf("The checksum after %ld iterations is: %lu\n",IMax,value);
+  return 0;
+}
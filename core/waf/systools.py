@@ -7,7 +7,7 @@ from waflib.Configure import conf
 from waflib import Context
 from waflib import Utils
 from waflib import Utils,Task,Logs,Options
-import os, sys
+import os, sys, re
 
 TESTLOCK = Utils.threading.Lock()
 
@@ -76,7 +76,26 @@ def systest_task_run(self):
     proc = Utils.subprocess.Popen(self.ut_exec, cwd=cwd, env=newenv, 
         stderr=Utils.subprocess.PIPE, stdout=Utils.subprocess.PIPE)
     (stdout, stderr) = proc.communicate()
-    result_tuple = (filename, proc.returncode, stdout, stderr)
+    returncode = proc.returncode
+
+    # Compare the results with the ones of a reference run
+    ref = getattr(self, 'compare_task', None)
+    if ref is not None and returncode == 0:
+        ref_result = getattr(ref.generator, 'utest_result', None)
+        if ref_result is None:
+            # The reference has not been run in this build
+            refproc = Utils.subprocess.Popen(ref.ut_exec, cwd=cwd, env=newenv,
+                stderr=Utils.subprocess.PIPE, stdout=Utils.subprocess.PIPE)
+            (refout, referr) = refproc.communicate()
+            ref_result = (ref.filename, refproc.returncode, refout, referr)
+        mismatch = systest_compare(self.compare_lines, ref_result[2], stdout)
+        if ref_result[1] != 0:
+            mismatch = "reference run failed"
+        if mismatch:
+            returncode = 1
+            stderr = stderr + ("\nResults differ from %s: %s\n" \
+                % (ref.generator.name, mismatch)).encode()
+    result_tuple = (filename, returncode, stdout, stderr)
     self.generator.utest_result = result_tuple
     TESTLOCK.acquire()
 
@@ -92,6 +111,30 @@ def systest_task_run(self):
     finally:
         TESTLOCK.release()
 
+def systest_compare(patterns, expected, actual):
+    """Returns a description of the first difference between the lines of
+    two runs which match one of the patterns, None if they agree"""
+    def results(out):
+        if isinstance(out, bytes):
+            out = out.decode('utf-8', 'replace')
+        lst = []
+        for line in out.splitlines():
+            for pattern in patterns:
+                match = re.search(pattern, line)
+                if match:
+                    lst.append(match.group(0).strip())
+        return lst
+    exp = results(expected)
+    act = results(actual)
+    if not exp:
+        return "no results found in the reference run"
+    for (e, a) in zip(exp, act):
+        if e != a:
+            return "'%s' instead of '%s'" % (a, e)
+    if len(exp) != len(act):
+        return "%d results instead of %d" % (len(act), len(exp))
+    return None
+
 def make_systest(self):
     """Extended Testing support"""
     if not (Options.options.systests and self.env["SYSTESTS"]):
@@ -170,6 +213,21 @@ def make_systest(self):
         test.atstr = atstr
         test.filename = filename
         test.ut_exec = exec_list + param
+        self.utest_task = test
+
+        # compare names the systest whose results have to be reproduced,
+        # compare_lines the regular expressions picking the results from
+        # the output (by default the checksums printed by the benchmarks)
+        ref = getattr(self, 'compare', None)
+        if ref:
+            reftgen = self.bld.get_tgen_by_name(ref)
+            reftgen.post()
+            test.compare_task = reftgen.utest_task
+            lines = getattr(self, 'compare_lines', ['checksum.*'])
+            if isinstance(lines, str):
+                lines = [lines]
+            test.compare_lines = lines
+            test.set_run_after(reftgen.utest_task)
 
 from waflib.TaskGen import feature, after_method, before_method, task_gen
 feature('systest')(make_systest)
@@ -13,6 +13,7 @@
 /// @author Thomas Schuster
 ///
 
+#include <string.h>
 #include <string>
 #include <map>
 #include <utility>
@@ -43,6 +44,7 @@ AHBCtrl::AHBCtrl(
   ahbIN("ahbIN", amba::amba_AHB, ambaLayer, false),
   ahbOUT("ahbOUT", amba::amba_AHB, ambaLayer, false),
   snoop("snoop"),
+  g_decoupled("decoupled", false, m_generics),
   g_ioaddr("ioaddr", ioaddr, m_generics),
   g_iomask("iomask", iomask, m_generics),
   g_cfgaddr("cfgaddr", cfgaddr, m_generics),
@@ -66,6 +68,7 @@ AHBCtrl::AHBCtrl(
   m_total_wait("total_wait", SC_ZERO_TIME, m_counters),
   m_arbitrated("arbitrated", 0ull, m_counters),
   m_max_wait("maximum_waiting_time", SC_ZERO_TIME, m_counters),
+  m_contention("contention_delay", SC_ZERO_TIME, m_counters),
   m_max_wait_master("maximum_waiting_master_id", defmast, m_counters),
   m_idle_count("idle_cycles", 0ull, m_counters),
   m_total_transactions("total_transactions", 0ull, m_counters),
@@ -101,12 +104,20 @@ AHBCtrl::AHBCtrl(
     ahbIN.register_get_direct_mem_ptr((AHBCtrl *)this, &AHBCtrl::get_direct_mem_ptr);
     ahbOUT.register_invalidate_direct_mem_ptr((AHBCtrl *)this, &AHBCtrl::invalidate_direct_mem_ptr);
 
+    // Register snoop thread (decoupled mode)
+    SC_THREAD(SnoopThread);
   }
 
   // Register non blocking transport functions
   if (ambaLayer == amba::amba_AT) {
-    memset(request_map, 0, 16 * sizeof (connection_t));
-    memset(response_map, 0, 16 * sizeof (connection_t));
+    // No transactions in flight
+    for (int i = 0; i < 16; i++) {
+      m_pending_head[i] = NULL;
+      m_pending_tail[i] = NULL;
+      m_pending_request[i] = NULL;
+    }
+    m_requesting = 0;
+    m_free_connections = NULL;
 
     // Register tlm non blocking transport forward path
     ahbIN.register_nb_transport_fw(this, &AHBCtrl::nb_transport_fw, 0);
@@ -154,12 +165,11 @@ AHBCtrl::AHBCtrl(
     ("ambaLayer", ambaLayer)
     ("Created an AHBCtrl with this parameters");
 
-  // initialize the slave_map_cache with some bogus numbers which will trigger MISS
-  slave_info_t tmp;
-  tmp.hindex = 0;
-  tmp.hmask  = ~0;
-  tmp.binding = ~0;
-  slave_map_cache = std::pair<uint32_t, slave_info_t>(~0, tmp);
+  // Nothing is decoded before start_of_simulation
+  memset(m_decode, DECODE_NONE, sizeof(m_decode));
+  memset(m_pnp_rom, 0, PNP_SIZE);
+  m_pnp_addr = 0;
+  m_pnp_mask = 0;
 }
 
 AHBCtrl::AHBCtrl(
@@ -182,6 +192,7 @@ AHBCtrl::AHBCtrl(
   ahbIN("ahbIN", amba::amba_AHB, ambaLayer, false),
   ahbOUT("ahbOUT", amba::amba_AHB, ambaLayer, false),
   snoop("snoop"),
+  g_decoupled("decoupled", false, m_generics),
   g_ioaddr("ioaddr", ioaddr, m_generics),
   g_iomask("iomask", iomask, m_generics),
   g_cfgaddr("cfgaddr", cfgaddr, m_generics),
@@ -207,6 +218,7 @@ AHBCtrl::AHBCtrl(
   m_total_wait("total_wait", SC_ZERO_TIME, m_counters),
   m_arbitrated("arbitrated", 0ull, m_counters),
   m_max_wait("maximum_waiting_time", SC_ZERO_TIME, m_counters),
+  m_contention("contention_delay", SC_ZERO_TIME, m_counters),
   m_max_wait_master("maximum_waiting_master_id", defmast, m_counters),
   m_idle_count("idle_cycles", 0ull, m_counters),
   m_total_transactions("total_transactions", 0ull, m_counters),
@@ -242,12 +254,20 @@ AHBCtrl::AHBCtrl(
     ahbIN.register_get_direct_mem_ptr((AHBCtrl *)this, &AHBCtrl::get_direct_mem_ptr);
     ahbOUT.register_invalidate_direct_mem_ptr((AHBCtrl *)this, &AHBCtrl::invalidate_direct_mem_ptr);
 
+    // Register snoop thread (decoupled mode)
+    SC_THREAD(SnoopThread);
   }
 
   // Register non blocking transport functions
   if (ambaLayer == amba::amba_AT) {
-    memset(request_map, 0, 16 * sizeof (connection_t));
-    memset(response_map, 0, 16 * sizeof (connection_t));
+    // No transactions in flight
+    for (int i = 0; i < 16; i++) {
+      m_pending_head[i] = NULL;
+      m_pending_tail[i] = NULL;
+      m_pending_request[i] = NULL;
+    }
+    m_requesting = 0;
+    m_free_connections = NULL;
 
     // Register tlm non blocking transport forward path
     ahbIN.register_nb_transport_fw(this, &AHBCtrl::nb_transport_fw, 0);
@@ -295,12 +315,11 @@ AHBCtrl::AHBCtrl(
     ("ambaLayer", ambaLayer)
     ("Created an AHBCtrl with this parameters");
 
-  // initialize the slave_map_cache with some bogus numbers which will trigger MISS
-  slave_info_t tmp;
-  tmp.hindex = 0;
-  tmp.hmask  = ~0;
-  tmp.binding = ~0;
-  slave_map_cache = std::pair<uint32_t, slave_info_t>(~0, tmp);
+  // Nothing is decoded before start_of_simulation
+  memset(m_decode, DECODE_NONE, sizeof(m_decode));
+  memset(m_pnp_rom, 0, PNP_SIZE);
+  m_pnp_addr = 0;
+  m_pnp_mask = 0;
 }
 
 // Reset handler
@@ -311,6 +330,11 @@ void AHBCtrl::dorst() {
 // Destructor
 AHBCtrl::~AHBCtrl() {
   GC_UNREGISTER_CALLBACKS();
+
+  // Release the pool of transaction records
+  for (std::vector<connection_t *>::iterator it = m_connection_blocks.begin(); it != m_connection_blocks.end(); it++) {
+    delete[] *it;
+  }
 }
 
 void AHBCtrl::init_generics() {
@@ -399,104 +423,100 @@ void AHBCtrl::setAddressMap(const uint32_t binding, const uint32_t hindex, const
   slave_map.insert(std::pair<uint32_t, slave_info_t>(haddr, tmp));
 }
 
+// Fill the flat decoder table from slave_map
+void AHBCtrl::buildDecodeTable() {
+  memset(m_decode, DECODE_NONE, sizeof(m_decode));
+
+  // Ascending base addresses: where BARs overlap the higher one wins,
+  // as it did for the upper_bound lookup in slave_map.
+  for (std::map<uint32_t, slave_info_t>::iterator it = slave_map.begin(); it != slave_map.end(); it++) {
+    for (uint32_t seg = 0; seg < DECODE_SEGMENTS; seg++) {
+      if (!((seg ^ it->first) & it->second.hmask)) {
+        // There may be up to four BARs per device.
+        // Only store device ID.
+        m_decode[seg] = it->second.binding >> 2;
+      }
+    }
+  }
+
+  // Configuration area (PNP) at 256 byte granularity. Segments containing
+  // it are flagged, is_pnp checks the full address.
+  m_pnp_addr = (static_cast<uint32_t>(g_ioaddr) << 20) | (static_cast<uint32_t>(g_cfgaddr) << 8);
+  m_pnp_mask = (static_cast<uint32_t>(g_iomask) << 20) | (static_cast<uint32_t>(g_cfgmask) << 8);
+  if (g_fpnpen) {
+    for (uint32_t seg = 0; seg < DECODE_SEGMENTS; seg++) {
+      if (!(((seg << 20) ^ m_pnp_addr) & m_pnp_mask & 0xfff00000)) {
+        m_decode[seg] |= DECODE_PNP;
+      }
+    }
+  }
+}
+
 // Find slave index by address
 int AHBCtrl::get_index(const uint32_t address) {
   m_total_transactions++;
 
   // Use 12 bit segment address for decoding
-  uint32_t addr = address >> 20;
-
-  // check cache, otherwise search within map
-  slave_info_t info = slave_map_cache.second;
-  if ( ! ((addr ^ slave_map_cache.first) & info.hmask) ) {
-    // There may be up to four BARs per device.
-    // Only return device ID.
-    m_right_transactions++;
-    return (info.binding) >> 2;
-  }
+  uint32_t index = m_decode[address >> 20] & DECODE_INDEX;
 
-  std::map<uint32_t, slave_info_t>::iterator it = --(slave_map.upper_bound( addr ));
-  info = it->second;
-  if ( ! ((addr ^ it->first) & info.hmask) ) {
-    // MISS in the cache: update cache
-    slave_map_cache = *it;
-  
-    // There may be up to four BARs per device.
-    // Only return device ID.
+  if (index != DECODE_NONE) {
     m_right_transactions++;
-    return (info.binding) >> 2;
+    return index;
   }
 
   // no slave found
   return -1;
 }
 
-// Returns a PNP register from the slave configuration area
-unsigned int AHBCtrl::getPNPReg(const uint32_t address) {
-  uint32_t result;
-
-  m_total_transactions++;
-
-  if ((address >= 0xfffffff0)&&(address <= 0xfffffff3)) return 0x30100000;
-
-  // Calculate address offset in configuration area (slave info starts from 0x800)
-  unsigned int addr   = address - (
-      ((static_cast<uint32_t>(g_ioaddr) << 20) |
-       (static_cast<uint32_t>(g_cfgaddr) << 8)) &
-       ((static_cast<uint32_t>(g_iomask) << 20) | (static_cast<uint32_t>(g_cfgmask) << 8)));
-  srDebug()("addr", addr)("Accessing PNP area");
-
-  // Slave area
-  if (addr >= 0x800) {
-    addr -= 0x800;
-
-    // Calculate index of the device in mSlaves pointer array (32 byte per device)
-    // Shift first to get word addresses.
-    unsigned int device = (addr >> 2) >> 3;
-    // Calculate offset within device information
-    unsigned int offset = (addr >> 2) & 0x7;
-
-    srDebug()("addr", addr)("device", device)("offset", offset)("Access mSlaves");
-
-    if (device >= num_of_slave_bindings) {
-      srWarn()("addr", addr)("device", device)("slavecount", num_of_slave_bindings)("Access to unregistered PNP Slave Register!");
-      return 0;
-    }
-
-    // If the device exists, access deviceinfo (otherwise 0)
-    if (mSlaves[device] != NULL) {
-      result =  mSlaves[device][offset];
-    } else {
-      result = 0;
-    }
+// Fill the ROM image of the configuration area (PNP)
+void AHBCtrl::buildPNPRom() {
+  memset(m_pnp_rom, 0, PNP_SIZE);
 
+  // Master records from 0x000, slave records from 0x800 (32 byte per device)
+  for (uint32_t device = 0; device < 64; device++) {
+    for (uint32_t offset = 0; offset < 8; offset++) {
+      if (mMasters[device] != NULL) {
+        uint32_t reg = mMasters[device][offset];
 #ifdef LITTLE_ENDIAN_BO
-    swap_Endianess(result);
+        swap_Endianess(reg);
 #endif
-    m_right_transactions++;
-    return result;
-  } else {
-    // Calculate index of the device in mMasters pointer array (32 byte per device)
-    unsigned int device = (addr >> 2) >> 3;
-    // Calculate offset within device information
-    unsigned int offset = (addr >> 2) & 0x7;
-
-    if (device >= num_of_master_bindings) {
-      srWarn()("addr", addr)("device", device)("slavecount", num_of_master_bindings)("Access to unregistered PNP Slave Register!");
-      return 0;
+        memcpy(&m_pnp_rom[(device << 5) + (offset << 2)], &reg, 4);
+      }
+      if (mSlaves[device] != NULL) {
+        uint32_t reg = mSlaves[device][offset];
+#ifdef LITTLE_ENDIAN_BO
+        swap_Endianess(reg);
+#endif
+        memcpy(&m_pnp_rom[0x800 + (device << 5) + (offset << 2)], &reg, 4);
+      }
     }
+  }
 
-    if (mMasters[device] != NULL) {
-      result = mMasters[device][offset];
-    } else {
-      result = 0;
-    }
+  // Library build register at 0xfffffff0 (stored in host byte order, as
+  // it has always been returned)
+  if (((m_pnp_addr & m_pnp_mask) | 0xff0) == 0xfffffff0) {
+    uint32_t reg = 0x30100000;
+    memcpy(&m_pnp_rom[0xff0], &reg, 4);
+  }
+}
 
-#ifdef LITTLE_ENDIAN_BO
-    swap_Endianess(result);
-#endif
-    return result;
+// Copies a read of the configuration area from the ROM image
+uint32_t AHBCtrl::readPNP(const uint32_t address, uint8_t *data, const uint32_t length) {
+  uint32_t offset = address & (PNP_SIZE - 1);
+
+  m_total_transactions++;
+  m_right_transactions++;
+  srDebug()("addr", address)("length", length)("Accessing PNP area");
+
+  // The area repeats above 4kB
+  if (offset + length <= PNP_SIZE) {
+    memcpy(data, &m_pnp_rom[offset], length);
+  } else {
+    memcpy(data, &m_pnp_rom[offset], PNP_SIZE - offset);
+    memcpy(data + PNP_SIZE - offset, m_pnp_rom, length - (PNP_SIZE - offset));
   }
+
+  return ((offset & 0x3) + length + 3) >> 2;
 }
 
 // TLM blocking transport function (multi-sock)
@@ -530,6 +550,10 @@ void AHBCtrl::b_transport(uint32_t id,
   // Collect transport statistics
   transport_statistics(trans);
 
+  // Decoupled mode: the transfer is placed on the timeline once its
+  // duration is known (see busySchedule)
+  sc_time start = sc_time_stamp() + delay;
+
   // Extract address from payload
   uint32_t addr   = trans.get_address();
   // Extract length from payload
@@ -537,33 +561,23 @@ void AHBCtrl::b_transport(uint32_t id,
   srDebug()("pointer", reinterpret_cast<size_t>(&trans))("busy", busy)("is_lock", is_lock)("id", id)("lock_master", lock_master)("addr", addr)("delay", delay)(__PRETTY_FUNCTION__);
   
   // Is this an access to configuration area
-  if (g_fpnpen && ((
-          (addr ^ ((static_cast<uint32_t>(g_ioaddr) << 20) |
-                   (static_cast<uint32_t>(g_cfgaddr) << 8))) &
-          ((static_cast<uint32_t>(g_iomask) << 20) |
-           (static_cast<uint32_t>(g_cfgmask) << 8))) == 0)) {
+  if (is_pnp(addr)) {
     // Configuration area is read only
     if (trans.get_command() == tlm::TLM_READ_COMMAND) {
-      // addr = addr - (((g_ioaddr << 20) | (g_cfgaddr << 8)) & ((g_iomask << 20) | (g_cfgmask << 8)));
-      // Extract data pointer from payload
-      uint8_t *data  = trans.get_data_ptr();
-
-      // Get registers from config area
-      for (uint32_t i = 0; i < length; i++) {
-        // uint32_t word = (addr + i) >> 2;
-        uint32_t byte = (addr + i) & 0x3;
-        uint32_t reg = getPNPReg(addr + i);
-        data[i] = (reinterpret_cast<uint8_t *>(&reg))[byte];
-
-        // one cycle delay per 32bit register
-        delay += clock_cycle;
-      }
+      // Copy registers from the ROM image,
+      // one cycle delay per 32bit register
+      delay += clock_cycle * readPNP(addr, trans.get_data_ptr(), length);
 
-      // and return
+      // and return, the image may be read directly from now on
       trans.set_response_status(tlm::TLM_OK_RESPONSE);
+      trans.set_dmi_allowed(true);
 
-      wait(delay);
-      delay = SC_ZERO_TIME;
+      if (g_decoupled) {
+        busySchedule(start, delay);
+      } else {
+        wait(delay);
+        delay = SC_ZERO_TIME;
+      }
 
       msclogger::return_backward(this, &ahbIN, &trans, tlm::TLM_COMPLETED, delay);
 
@@ -624,6 +638,22 @@ void AHBCtrl::b_transport(uint32_t id,
     // Power event end
     // PM::send(this,event_name,0,sc_time_stamp()+delay,id,g_pow_mon);
 
+    if (g_decoupled) {
+      // The bus is occupied until the annotated end of the transfer.
+      // Other caches see the write at that time.
+      busySchedule(start, delay);
+      if (trans.get_command() == tlm::TLM_WRITE_COMMAND) {
+        snoopy.master_id  = id;
+        snoopy.address = addr;
+        snoopy.length = length;
+
+        m_snoop_queue.insert(std::make_pair(sc_time_stamp() + delay, snoopy));
+        m_snoop_event.notify(delay);
+      }
+      busy = false;
+      return;
+    }
+
     wait(delay);
     delay = SC_ZERO_TIME;
     // Broadcast master_id and address for dcache snooping
@@ -649,14 +679,88 @@ void AHBCtrl::b_transport(uint32_t id,
     // Invalid index
     trans.set_response_status(tlm::TLM_ADDRESS_ERROR_RESPONSE);
 
-    wait(delay);
-    delay = SC_ZERO_TIME;
+    if (!g_decoupled) {
+      wait(delay);
+      delay = SC_ZERO_TIME;
+    }
 
     busy = false;
     return;
   }
 }
 
+// Decoupled mode: delays a transfer to the first gap between the occupied
+// intervals at or after its start which is long enough to hold it
+sc_time AHBCtrl::busyStall(const sc_time &start, const sc_time &length) {
+  sc_time ready = start;
+
+  // Intervals which ended before the present cannot be hit any more
+  while (!m_busy.empty() && (m_busy.begin()->second <= sc_time_stamp())) {
+    m_busy.erase(m_busy.begin());
+  }
+
+  // The intervals are disjoint: only the last one starting at or before
+  // the transfer can hold its start
+  std::map<sc_time, sc_time>::iterator it = m_busy.upper_bound(ready);
+  if (it != m_busy.begin()) {
+    std::map<sc_time, sc_time>::iterator prev = it;
+    --prev;
+    if (prev->second > ready) {
+      ready = prev->second;
+    }
+  }
+
+  // Skip the following intervals until the transfer fits in front of one
+  while ((it != m_busy.end()) && (it->first < ready + length)) {
+    if (it->second > ready) {
+      ready = it->second;
+    }
+    ++it;
+  }
+  return ready - start;
+}
+
+// Decoupled mode: moves a transfer of the annotated duration behind the
+// occupied intervals, charges the contention as delay and occupies the bus
+void AHBCtrl::busySchedule(sc_time &start, sc_time &delay) {
+  sc_time end = sc_time_stamp() + delay;
+  sc_time length = (end > start)? end - start : SC_ZERO_TIME;
+  sc_time contention = busyStall(start, length);
+  if (contention != SC_ZERO_TIME) {
+    sc_time tmp = m_contention;
+    m_contention = tmp + contention;
+    delay += contention;
+    start += contention;
+  }
+  busyOccupy(start, sc_time_stamp() + delay);
+}
+
+// Decoupled mode: records the interval occupied by a transfer. Touching
+// intervals are merged, so that the intervals stay disjoint.
+void AHBCtrl::busyOccupy(const sc_time &start, const sc_time &end) {
+  if (end <= start) {
+    return;
+  }
+  sc_time first = start;
+  sc_time last = end;
+  std::map<sc_time, sc_time>::iterator it = m_busy.upper_bound(first);
+  if (it != m_busy.begin()) {
+    std::map<sc_time, sc_time>::iterator prev = it;
+    --prev;
+    if (prev->second >= first) {
+      first = prev->first;
+      it = prev;
+    }
+  }
+  while ((it != m_busy.end()) && (it->first <= last)) {
+    if (it->second > last) {
+      last = it->second;
+    }
+    m_busy.erase(it++);
+  }
+  m_busy[first] = last;
+}
+
 // Non-blocking forward transport function for ahb_slave multi-socket
 // A master may send BEGIN_REQ or END_RESP. The model replies with
 // TLM_ACCEPTED or TLM_COMPLETED, respectively.
@@ -754,13 +858,129 @@ void AHBCtrl::print_requests() {
   v::info << name() << "NEW ARBITER CYCLE:" << v::endl;
 
   for (int i = 0; i < 16; i++) {
-    v::info << name() << "Master " << i << " Transaction: " <<  request_map[i].trans << " State: " <<
-      request_map[i].state << v::endl;
+    for (connection_t *connection = m_pending_head[i]; connection; connection = connection->next) {
+      v::info << name() << "Master " << i << " Transaction: " <<  connection->trans << " State: " <<
+        connection->state << v::endl;
+    }
   }
 
   v::info << name() << " ---------------------------------------------------- " << v::endl;
 }
 
+// Appends a record for a new transaction of a master
+AHBCtrl::connection_t *AHBCtrl::addPendingTransaction(
+    tlm::tlm_generic_payload &trans,  // NOLINT(runtime/references)
+    const uint32_t master_id,
+    const uint32_t slave_id) {
+  connection_t *connection = m_free_connections;
+
+  // Grow the pool by a block of records
+  if (!connection) {
+    connection_t *block = new connection_t[16];
+    m_connection_blocks.push_back(block);
+    for (int i = 1; i < 15; i++) {
+      block[i].next = &block[i + 1];
+    }
+    block[15].next = NULL;
+    m_free_connections = &block[1];
+    connection = &block[0];
+  } else {
+    m_free_connections = connection->next;
+  }
+
+  connection->master_id  = master_id;
+  connection->slave_id   = slave_id;
+  connection->start_time = sc_time_stamp();
+  connection->state      = TRANS_PENDING;
+  connection->trans      = &trans;
+  connection->next       = NULL;
+
+  if (m_pending_tail[master_id]) {
+    m_pending_tail[master_id]->next = connection;
+  } else {
+    m_pending_head[master_id] = connection;
+  }
+  m_pending_tail[master_id] = connection;
+
+  // The master starts to request the bus
+  if (!m_pending_request[master_id]) {
+    m_pending_request[master_id] = connection;
+    m_requesting |= 1 << master_id;
+    m_request_event.notify();
+  }
+
+  return connection;
+}
+
+// Returns the record of a transaction of a master
+AHBCtrl::connection_t *AHBCtrl::getPendingTransaction(
+    tlm::tlm_generic_payload &trans,  // NOLINT(runtime/references)
+    const uint32_t master_id) {
+  connection_t *connection = m_pending_head[master_id];
+
+  // Usually the oldest one
+  while (connection && (connection->trans != &trans)) {
+    connection = connection->next;
+  }
+
+  assert(connection);
+  return connection;
+}
+
+// Removes the record of a completed transaction
+void AHBCtrl::removePendingTransaction(connection_t *connection) {
+  uint32_t master_id = connection->master_id;
+  connection_t *prev = NULL;
+  connection_t *it = m_pending_head[master_id];
+
+  while (it != connection) {
+    prev = it;
+    it = it->next;
+  }
+
+  if (prev) {
+    prev->next = connection->next;
+  } else {
+    m_pending_head[master_id] = connection->next;
+  }
+  if (m_pending_tail[master_id] == connection) {
+    m_pending_tail[master_id] = prev;
+  }
+
+  connection->trans = NULL;
+  connection->next = m_free_connections;
+  m_free_connections = connection;
+}
+
+// Selects the next master to own the address bus, -1 if none
+int32_t AHBCtrl::selectMaster() {
+  // A locked bus stays with its master
+  if (is_lock) {
+    return (m_requesting & (1 << lock_master)) ? lock_master : -1;
+  }
+
+  if (!m_requesting) {
+    return -1;
+  }
+
+  // Priority arbitration
+  if (g_rrobin == 0) {
+    // Master with the highest ID has the highest priority
+    return 31 - __builtin_clz(m_requesting);
+
+    // Round-robin
+  } else {
+    // First requesting master after the robin pointer, wrapping around
+    uint32_t after = m_requesting & ~((2u << robin) - 1);
+
+    robin = __builtin_ctz(after ? after : m_requesting);
+
+    srDebug()("robin", robin)("Selected for robin");
+
+    return robin;
+  }
+}
+
 // Arbitration thread (AT only)
 void AHBCtrl::arbitrate() {
   tlm::tlm_phase phase;
@@ -779,87 +999,52 @@ void AHBCtrl::arbitrate() {
 
   wait(1, SC_PS);
 
+  // Time of the last arbiter cycle
+  sc_core::sc_time cycle_time = sc_time_stamp();
+
   // Arbiter phase shift:
   // --------------------
   while (true) {
-    wait(clock_cycle);
+    if (!m_requesting && (address_bus_owner == -1) && (data_bus_state != WAITSTATES)) {
+      // Nothing to arbitrate and nothing to count until a master requests
+      // the bus. Sleep and resume on the next arbiter cycle.
+      wait(m_request_event);
+
+      sc_dt::uint64 cycles = ((sc_time_stamp() - cycle_time).value() + clock_cycle.value() - 1) / clock_cycle.value();
+      cycle_time += clock_cycle * static_cast<double>(cycles ? cycles : 1);
+      if (cycle_time > sc_time_stamp()) {
+        wait(cycle_time - sc_time_stamp());
+      }
+    } else {
+      wait(clock_cycle);
+      cycle_time = sc_time_stamp();
+    }
 
     // print_requests();
 
     // Last address of current transfer must have been sampled.
     // Last data sample is on the way.
-    // v::debug << name() << " address_bus_owner: " << address_bus_owner << " data_bus_state: "
-    //          << data_bus_state << v::endl;
-    // if (sc_time_stamp() > sc_core::sc_time(83880, SC_NS)) sc_stop();
-
     if ((address_bus_owner == -1) && ((data_bus_state == RESPONSE) || (data_bus_state == IDLE))) {
-      // Priority arbitration
-      if (g_rrobin == 0) {
-        if (!is_lock) {
-          // Master with the highest ID has the highest priority
-          for (int i = 15; i >= 0; i--) {
-            if (request_map[i].state == TRANS_PENDING) {
-              address_bus_owner = i;
-              request_map[i].state = TRANS_SCHEDULED;
-              trans = request_map[i].trans;
-              slave_id = request_map[i].slave_id;
-
-              is_lock = ahbIN.get_extension<amba::amba_lock>(lock, *trans);
-              lock_master = i;
-
-              break;
-            }
-          }
-        } else {
-          if (request_map[lock_master].state == TRANS_PENDING) {
-            address_bus_owner = lock_master;
-            request_map[lock_master].state = TRANS_SCHEDULED;
-            trans = request_map[lock_master].trans;
-            slave_id = request_map[lock_master].slave_id;
-
-            is_lock = ahbIN.get_extension<amba::amba_lock>(lock, *trans);
-          }
-        }
-
-        // Round-robin
-      } else {
-        if (!is_lock) {
-          for (uint32_t i = 0; i < num_of_master_bindings; i++) {
-            robin = (robin + 1) % num_of_master_bindings;
-
-            srDebug()("robin", robin)(__PRETTY_FUNCTION__);
+      int32_t master = selectMaster();
 
-            if (request_map[robin].state == TRANS_PENDING) {
-              srDebug()("robin", robin)("Selected for robin");
+      if (master != -1) {
+        connection_t *connection = m_pending_request[master];
 
-              address_bus_owner = robin;
-              request_map[robin].state = TRANS_SCHEDULED;
-              trans = request_map[robin].trans;
-              slave_id = request_map[robin].slave_id;
+        address_bus_owner = master;
+        connection->state = TRANS_SCHEDULED;
+        trans = connection->trans;
+        slave_id = connection->slave_id;
 
-              is_lock = ahbIN.get_extension<amba::amba_lock>(lock, *trans);
-
-              lock_master = robin;
-
-              break;
-            }
-          }
-        } else {
-          if (request_map[lock_master].state == TRANS_PENDING) {
-            srDebug()("robin", robin)("Selected for robin");
-
-            address_bus_owner = lock_master;
-            request_map[lock_master].state = TRANS_SCHEDULED;
-            trans = request_map[lock_master].trans;
-            slave_id = request_map[lock_master].slave_id;
-
-            is_lock = ahbIN.get_extension<amba::amba_lock>(lock, *trans);
-          }
+        // Further transactions of the master keep requesting
+        m_pending_request[master] = connection->next;
+        if (!connection->next) {
+          m_requesting &= ~(1 << master);
         }
-      }
 
-      if (address_bus_owner != -1) {
-        waiting_time = sc_time_stamp() - request_map[address_bus_owner].start_time;
+        is_lock = ahbIN.get_extension<amba::amba_lock>(lock, *trans);
+        lock_master = master;
+
+        waiting_time = sc_time_stamp() - connection->start_time;
 
         // Statistic
         if (waiting_time > m_max_wait) {
@@ -875,15 +1060,8 @@ void AHBCtrl::arbitrate() {
 
         // Is this an access to the configuration area
         if (slave_id == 16) {
-          uint32_t addr = trans->get_address();
-          uint8_t *data  = trans->get_data_ptr();
-
-          // Get registers from config area
-          for (uint32_t i = 0; i < trans->get_data_length(); i++) {
-            uint32_t byte = (addr + i) & 0x3;
-            uint32_t reg = getPNPReg(addr + i);
-            data[i] = (reinterpret_cast<uint8_t *>(&reg))[byte];
-          }
+          // Copy registers from the ROM image
+          readPNP(trans->get_address(), trans->get_data_ptr(), trans->get_data_length());
 
           // Set TLM response
           trans->set_response_status(tlm::TLM_OK_RESPONSE);
@@ -932,7 +1110,6 @@ void AHBCtrl::AcceptThread() {
   int slave_id = 16;
 
   payload_t *trans;
-  connection_t connection;
 
   while (true) {
     wait(m_AcceptPEQ.get_event());
@@ -944,12 +1121,7 @@ void AHBCtrl::AcceptThread() {
       ahbIN.get_extension<amba::amba_id>(master_id, *trans);
 
       // Is PNP access
-      if (g_fpnpen && ((
-              (trans->get_address() ^
-                ((static_cast<uint32_t>(g_ioaddr) << 20) |
-                 (static_cast<uint32_t>(g_cfgaddr) << 8))) &
-              ((static_cast<uint32_t>(g_iomask) << 20) |
-               (static_cast<uint32_t>(g_cfgmask) << 8))) == 0)) {
+      if (is_pnp(trans->get_address())) {
         if (trans->get_command() == tlm::TLM_WRITE_COMMAND) {
           srWarn()("PNP area is read-only. Write operation ignored");
         }
@@ -965,15 +1137,8 @@ void AHBCtrl::AcceptThread() {
         dec << slave_id << " Address: " << hex << trans->get_address() << v::endl;
 
       if (slave_id >= 0) {
-        // Initialize connection record
-        connection.master_id  = master_id->value;
-        connection.slave_id   = slave_id;
-        connection.start_time = sc_time_stamp();
-        connection.state      = TRANS_PENDING;
-        connection.trans      = trans;
-
-        request_map[master_id->value] = connection;
-        response_map[master_id->value] = connection;
+        // Queue connection record for arbitration
+        addPendingTransaction(*trans, master_id->value, slave_id);
       } else {
         v::error << name() << "DECODING ERROR" << v::endl;
       }
@@ -987,7 +1152,7 @@ void AHBCtrl::RequestThread() {
   t_snoop snoopy;
 
   payload_t *trans;
-  connection_t connection;
+  connection_t *connection;
 
   tlm::tlm_phase phase;
 #ifndef NDEBUG // assert specific macro
@@ -1003,7 +1168,7 @@ void AHBCtrl::RequestThread() {
       amba::amba_id *master_id;
       ahbIN.get_extension<amba::amba_id>(master_id, *trans);
 
-      connection = request_map[master_id->value];
+      connection = getPendingTransaction(*trans, master_id->value);
 
       // Broadcast master_id and address for dcache snooping
       if (trans->get_command() == tlm::TLM_WRITE_COMMAND) {
@@ -1030,13 +1195,13 @@ void AHBCtrl::RequestThread() {
         v::endl;
 
       // Backward arrow for msc
-      msclogger::backward(this, &ahbIN, trans, phase, delay, connection.master_id);
+      msclogger::backward(this, &ahbIN, trans, phase, delay, connection->master_id);
 
 
 #ifdef NDEBUG // assert specific macro
-      ahbIN[connection.master_id]->nb_transport_bw(*trans, phase, delay);
+      ahbIN[connection->master_id]->nb_transport_bw(*trans, phase, delay);
 #else
-      status = ahbIN[connection.master_id]->nb_transport_bw(*trans, phase, delay);
+      status = ahbIN[connection->master_id]->nb_transport_bw(*trans, phase, delay);
       assert(status == tlm::TLM_ACCEPTED);
 #endif
     }
@@ -1045,7 +1210,7 @@ void AHBCtrl::RequestThread() {
 
 void AHBCtrl::ResponseThread() {
   payload_t *trans;
-  connection_t connection;
+  connection_t *connection;
 
   tlm::tlm_phase phase;
 #ifndef NDEBUG // assert specific macro
@@ -1061,7 +1226,7 @@ void AHBCtrl::ResponseThread() {
       amba::amba_id *master_id;
       ahbIN.get_extension<amba::amba_id>(master_id, *trans);
 
-      connection = response_map[master_id->value];
+      connection = getPendingTransaction(*trans, master_id->value);
 
       // Data bus is response mode (data is being transferred)
       data_bus_state = RESPONSE;
@@ -1074,12 +1239,12 @@ void AHBCtrl::ResponseThread() {
         v::endl;
 
       // Backward arrow for msc
-      msclogger::backward(this, &ahbIN, trans, phase, delay, connection.master_id);
+      msclogger::backward(this, &ahbIN, trans, phase, delay, connection->master_id);
 
 #ifdef NDEBUG // assert specific macro
-      ahbIN[connection.master_id]->nb_transport_bw(*trans, phase, delay);
+      ahbIN[connection->master_id]->nb_transport_bw(*trans, phase, delay);
 #else
-      status = ahbIN[connection.master_id]->nb_transport_bw(*trans, phase, delay);
+      status = ahbIN[connection->master_id]->nb_transport_bw(*trans, phase, delay);
       assert((status == tlm::TLM_ACCEPTED) || (status == tlm::TLM_UPDATED));
 #endif
 
@@ -1094,7 +1259,7 @@ void AHBCtrl::ResponseThread() {
 // Send END_RESP to slave
 void AHBCtrl::EndResponseThread() {
   payload_t *trans;
-  connection_t connection;
+  connection_t *connection;
 
   tlm::tlm_phase phase;
 #ifndef NDEBUG // assert specific macro
@@ -1112,16 +1277,19 @@ void AHBCtrl::EndResponseThread() {
       amba::amba_id *master_id;
       ahbIN.get_extension<amba::amba_id>(master_id, *trans);
 
-      connection = response_map[master_id->value];
+      connection = getPendingTransaction(*trans, master_id->value);
 
       // Is PNP access
-      if (connection.slave_id == 16) {
+      if (connection->slave_id == 16) {
         // Data bus is now idle
         data_bus_state = IDLE;
 
         v::debug << name() << "Release " << trans << " Ref-Count before calling release " << trans->get_ref_count() <<
           v::endl;
 
+        // Transaction completed, recycle its record
+        removePendingTransaction(connection);
+
         // Decrement reference counter
         trans->release();
       } else {
@@ -1136,18 +1304,21 @@ void AHBCtrl::EndResponseThread() {
           v::endl;
 
         // Forward arrow for msc
-        msclogger::forward(this, &ahbOUT, trans, phase, delay, connection.slave_id);
+        msclogger::forward(this, &ahbOUT, trans, phase, delay, connection->slave_id);
 
 #ifdef NDEBUG // assert specific macro
-        ahbOUT[connection.slave_id]->nb_transport_fw(*trans, phase, delay);
+        ahbOUT[connection->slave_id]->nb_transport_fw(*trans, phase, delay);
 #else
-        status = ahbOUT[connection.slave_id]->nb_transport_fw(*trans, phase, delay);
+        status = ahbOUT[connection->slave_id]->nb_transport_fw(*trans, phase, delay);
         assert((status == tlm::TLM_ACCEPTED) || (status == tlm::TLM_COMPLETED));
 #endif
 
         v::debug << name() << "Release " << trans << " Ref-Count before calling release " << trans->get_ref_count() <<
           v::endl;
 
+        // Transaction completed, recycle its record
+        removePendingTransaction(connection);
+
         // Decrement reference counter
         trans->release();
       }
@@ -1155,6 +1326,27 @@ void AHBCtrl::EndResponseThread() {
   }
 }
 
+// Broadcast snoops of decoupled writes at their completion time
+void AHBCtrl::SnoopThread() {
+  while (true) {
+    wait(m_snoop_event);
+
+    // Deliver all snoops which are due
+    while (!m_snoop_queue.empty() && (m_snoop_queue.begin()->first <= sc_time_stamp())) {
+      t_snoop snoopy = m_snoop_queue.begin()->second;
+      m_snoop_queue.erase(m_snoop_queue.begin());
+
+      // Send to signal socket
+      snoop.write(snoopy);
+    }
+
+    // Wake up for the next one
+    if (!m_snoop_queue.empty()) {
+      m_snoop_event.notify(m_snoop_queue.begin()->first - sc_time_stamp());
+    }
+  }
+}
+
 // Set up slave map and collect plug & play information
 void AHBCtrl::start_of_simulation() {
   // Get number of bindings at master socket (number of connected slaves)
@@ -1294,6 +1486,14 @@ void AHBCtrl::start_of_simulation() {
     }
   }
 
+  // Build the flat decoder from the slave map
+  buildDecodeTable();
+
+  // Materialize the configuration area
+  if (g_fpnpen) {
+    buildPNPRom();
+  }
+
   // Check memory map for overlaps
   if (g_mcheck) {
     checkMemMap();
@@ -1375,55 +1575,66 @@ void AHBCtrl::end_of_simulation() {
     v::report << name() << " * " << v::endl;
   }
 
+  if ((m_ambaLayer == amba::amba_LT) && g_decoupled) {
+    sc_time contention = m_contention;
+
+    v::report << name() << " * Decoupled contention delay: " << contention << " (" << contention / clock_cycle <<
+      " cycles)" << v::endl;
+    v::report << name() << " * " << v::endl;
+  }
+
   v::report << name() << " * AHB Master interface reports: " << v::endl;
   print_transport_statistics(name());
 
   v::report << name() << " ******************************************** " << v::endl;
 }
 
-struct ahb_check_slave_type {
-  uint32_t start;
-  uint32_t end;
-  uint32_t index;
-};
 // Check the memory map for overlaps
 void AHBCtrl::checkMemMap() {
-  std::map<uint32_t, ahb_check_slave_type> slaves;
-  typedef std::map<uint32_t, ahb_check_slave_type>::iterator iter_t;
-  struct ahb_check_slave_type last;
-  last.start = 0;
-  last.end = 0;
-  last.index = ~0;
-
   for (std::map<uint32_t, slave_info_t>::iterator iter = slave_map.begin(); iter != slave_map.end(); iter++) {
-    uint32_t start_addr = (iter->first & iter->second.hmask) << 20;
-    uint32_t size = (((~iter->second.hmask) & 0xFFF) + 1) << 20;
-    struct ahb_check_slave_type obj;
-    obj.start = start_addr;
-    obj.end = start_addr + size - 1;
-    obj.index = iter->second.binding >> 2;
-    slaves.insert(std::make_pair(start_addr, obj));
-  }
-  for (iter_t iter = slaves.begin(); iter != slaves.end(); iter++) {
-    // First Slave need it in last to start
-    if (last.index != ~0u) {
-      // All other elements
-      // See if the last element is begining and end befor the current
-      if ((last.start >= iter->second.start) || (last.end >= iter->second.start)) {
-        uint32_t a = 0;
-        socket_t *other_socket = ahbOUT.get_other_side(last.index, a);
-        sc_core::sc_object *obj = other_socket->get_parent();
-
-        other_socket = ahbOUT.get_other_side(iter->second.index, a);
-        sc_core::sc_object *obj2 = other_socket->get_parent();
-
-        v::error << name() << "Overlap in AHB memory mapping." << v::endl;
-        v::error << name() << obj->name() << ": " << v::uint32 << last.start << " - " << v::uint32 << last.end << endl;
-        v::error << name() << obj2->name() << ": " << v::uint32 << iter->second.start << " - " << v::uint32 <<
-          iter->second.end << endl;
+    uint32_t start = (iter->first & iter->second.hmask) << 20;
+    uint32_t end = start + ((((~iter->second.hmask) & 0xFFF) + 1) << 20) - 1;
+    uint32_t index = iter->second.binding >> 2;
+
+    // First segment of the BAR decoded to another slave (per slave)
+    uint32_t shadowed[16];
+    bool overlap = false;
+    // BAR shares a segment with the configuration area
+    bool pnp = false;
+    for (uint32_t i = 0; i < 16; i++) {
+      shadowed[i] = ~0u;
+    }
+
+    for (uint32_t seg = 0; seg < DECODE_SEGMENTS; seg++) {
+      if (!((seg ^ iter->first) & iter->second.hmask)) {
+        uint32_t other = m_decode[seg] & DECODE_INDEX;
+        if ((other != index) && (shadowed[other] == ~0u)) {
+          shadowed[other] = seg;
+          overlap = true;
+        }
+        if (m_decode[seg] & DECODE_PNP) {
+          pnp = true;
+        }
+      }
+    }
+
+    uint32_t a = 0;
+    sc_core::sc_object *obj = ahbOUT.get_other_side(index, a)->get_parent();
+    if (overlap) {
+      for (uint32_t other = 0; other < num_of_slave_bindings; other++) {
+        if (shadowed[other] != ~0u) {
+          sc_core::sc_object *obj2 = ahbOUT.get_other_side(other, a)->get_parent();
+
+          v::error << name() << "Overlap in AHB memory mapping." << v::endl;
+          v::error << name() << obj->name() << ": " << v::uint32 << start << " - " << v::uint32 << end << endl;
+          v::error << name() << obj2->name() << ": decodes " << v::uint32 << (shadowed[other] << 20) << endl;
+        }
       }
     }
-    last = iter->second;
+    if (pnp) {
+      v::warn << name() << obj->name() << ": " << v::uint32 << start << " - " << v::uint32 << end <<
+        " overlaps the configuration area at " << v::uint32 << (m_pnp_addr & m_pnp_mask) << endl;
+    }
   }
 }
 
@@ -1441,23 +1652,11 @@ unsigned int AHBCtrl::transport_dbg(uint32_t id, tlm::tlm_generic_payload &trans
   uint32_t length = trans.get_data_length();
   uint8_t *data  = trans.get_data_ptr();
 
-  if (g_fpnpen &&
-      (((addr ^ ((static_cast<uint32_t>(g_ioaddr) << 20) |
-                 (static_cast<uint32_t>(g_cfgaddr) << 8))) &
-        ((static_cast<uint32_t>(g_iomask) << 20) |
-         (static_cast<uint32_t>(g_cfgmask) << 8))) == 0)) {
+  if (is_pnp(addr)) {
     // Configuration area is read only
     if (trans.get_command() == tlm::TLM_READ_COMMAND) {
-      // addr = addr - (((g_ioaddr << 20) | (g_cfgaddr << 8)) & ((g_iomask << 20) | (g_cfgmask << 8)));
-      // Extract data pointer from payload
-
-      // Get registers from config area
-      for (uint32_t i = 0; i < length; i++) {
-        // uint32_t word = (addr + i) >> 2;
-        uint32_t byte = (addr + i) & 0x3;
-        uint32_t reg = getPNPReg(addr + i);
-        data[i] = (reinterpret_cast<uint8_t *>(&reg))[byte];
-      }
+      // Copy registers from the ROM image
+      readPNP(addr, data, length);
 
       trans.set_response_status(tlm::TLM_OK_RESPONSE);
       return length;
@@ -1502,14 +1701,19 @@ unsigned int AHBCtrl::transport_dbg(uint32_t id, tlm::tlm_generic_payload &trans
 bool AHBCtrl::get_direct_mem_ptr(unsigned int index, tlm::tlm_generic_payload& trans, tlm::tlm_dmi& dmi_data) {
   // Extract address from payload
   uint32_t addr   = trans.get_address();
-  // Extract length from payload
-  if (g_fpnpen && (((addr ^ ((static_cast<uint32_t>(g_ioaddr) << 20) |
-                    (static_cast<uint32_t>(g_cfgaddr) << 8))) &
-                   ((static_cast<uint32_t>(g_iomask) << 20) |
-                    (static_cast<uint32_t>(g_cfgmask) << 8))) == 0)) {
-    // Configuration area is read only
-    trans.set_response_status(tlm::TLM_ADDRESS_ERROR_RESPONSE);
-    return false;
+  if (is_pnp(addr)) {
+    // Configuration area is read only. Grant the aligned part of the area
+    // around the address, at most the 4kB of the ROM image.
+    uint32_t size = ((~m_pnp_mask) & (PNP_SIZE - 1)) + 1;
+    uint32_t start = addr & ~(size - 1);
+
+    dmi_data.allow_read();
+    dmi_data.set_dmi_ptr(&m_pnp_rom[start & (PNP_SIZE - 1)]);
+    dmi_data.set_start_address(start);
+    dmi_data.set_end_address(start + size - 1);
+    dmi_data.set_read_latency(SC_ZERO_TIME);
+    dmi_data.set_write_latency(SC_ZERO_TIME);
+    return true;
   }
 
   // Find slave by address / returns slave index or -1 for not mapped
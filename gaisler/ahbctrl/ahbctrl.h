@@ -21,6 +21,7 @@
 #include "core/common/sr_param.h"
 #include <tlm.h>
 #include <map>
+#include <vector>
 
 #include "core/common/ahbdevice.h"
 #include "core/common/clkdevice.h"
@@ -45,6 +46,10 @@ class AHBCtrl : public BaseModule<DefaultBase>, public CLKDevice {
     /// Broadcast of master_id and write address for dcache snooping
     signal<t_snoop>::out snoop;
 
+    /// Temporally decoupled LT mode: b_transport returns the annotated
+    /// delay to the master instead of waiting for it (only LT)
+    sr_param<bool> g_decoupled;
+
     // Public functions
     // ----------------
 
@@ -85,6 +90,9 @@ class AHBCtrl : public BaseModule<DefaultBase>, public CLKDevice {
 
     void EndResponseThread();
 
+    /// Broadcasts the snoops of decoupled writes at their completion time
+    void SnoopThread();
+
     /// Collect common transport statistics.
     void transport_statistics(tlm::tlm_generic_payload &gp);  // NOLINT(runtime/references)
 
@@ -195,6 +203,19 @@ class AHBCtrl : public BaseModule<DefaultBase>, public CLKDevice {
     // Shows if bus is busy in LT mode
     bool busy;
 
+    /// Decoupled LT mode: intervals [start, end) in which the bus is
+    /// occupied on the timeline, keyed by start. Masters run ahead of each
+    /// other, so transfers are not entered in time order. A transfer is
+    /// delayed only if its start falls into one of the intervals.
+    std::map<sc_time, sc_time> m_busy;
+
+    /// Decoupled LT mode: snoops waiting for the completion time of their
+    /// write
+    std::multimap<sc_time, t_snoop> m_snoop_queue;
+
+    /// Notified for the earliest snoop in the queue
+    sc_event m_snoop_event;
+
     typedef tlm::tlm_generic_payload payload_t;
     typedef gs::socket::bindability_base<tlm::tlm_base_protocol_types> socket_t;
 
@@ -209,7 +230,26 @@ class AHBCtrl : public BaseModule<DefaultBase>, public CLKDevice {
 
     /// Address decoder table (slave index, (bar addr, mask))
     std::map<uint32_t, slave_info_t> slave_map;
-    std::pair<uint32_t, slave_info_t> slave_map_cache;
+
+    /// Number of 1MB segments in the AHB address space
+    static const uint32_t DECODE_SEGMENTS = 4096;
+
+    /// Decode table entry of a segment without slave
+    static const uint8_t DECODE_NONE = 0x7f;
+
+    /// Mask selecting the slave index of a decode table entry
+    static const uint8_t DECODE_INDEX = 0x7f;
+
+    /// Flag of segments overlapping the configuration area (PNP)
+    static const uint8_t DECODE_PNP = 0x80;
+
+    /// Flat address decoder: slave index per 1MB segment, built from
+    /// slave_map in start_of_simulation
+    uint8_t m_decode[DECODE_SEGMENTS];
+
+    /// Address and mask of the configuration area (PNP)
+    uint32_t m_pnp_addr;
+    uint32_t m_pnp_mask;
 
     /// Connection state:
     //  -----------------
@@ -220,19 +260,34 @@ class AHBCtrl : public BaseModule<DefaultBase>, public CLKDevice {
     enum DbusStateType {IDLE, RESPONSE, WAITSTATES};
 
     /// Keeps track on where the transactions have been coming from
-    typedef struct {
+    typedef struct connection_s {
       unsigned int master_id;
       unsigned int slave_id;
       sc_time start_time;
       TransStateType state;
       payload_t *trans;
+      /// Next transaction of the same master (or next free record)
+      struct connection_s *next;
     } connection_t;
 
-    connection_t request_map[16];
-    connection_t response_map[16];
+    /// Records of the transactions of each master from BEGIN_REQ to
+    /// END_RESP, oldest first. The transfers of a master complete in order.
+    connection_t *m_pending_head[16];
+    connection_t *m_pending_tail[16];
+
+    /// Oldest record of each master waiting for arbitration
+    connection_t *m_pending_request[16];
+
+    /// Bit i is set while master i waits for arbitration
+    uint32_t m_requesting;
+
+    /// Notified when a master starts to request the bus
+    sc_event m_request_event;
 
-    std::map<payload_t *, connection_t> pending_map;
-    std::map<payload_t *, connection_t>::iterator pm_itr;
+    /// Records not in use. The pool grows on demand, records are
+    /// never returned to the heap before destruction.
+    connection_t *m_free_connections;
+    std::vector<connection_t *> m_connection_blocks;
 
     /// Array of slave device information (PNP)
     const uint32_t *mSlaves[64];
@@ -240,6 +295,14 @@ class AHBCtrl : public BaseModule<DefaultBase>, public CLKDevice {
     /// Array of master device information (PNP)
     const uint32_t *mMasters[64];
 
+    /// Size of the configuration area (PNP)
+    static const uint32_t PNP_SIZE = 0x1000;
+
+    /// ROM image of the configuration area in bus byte order, built from
+    /// mMasters and mSlaves in start_of_simulation. Served to readers with
+    /// memcpy and read-only through DMI.
+    uint8_t m_pnp_rom[PNP_SIZE];
+
     int32_t address_bus_owner;
     DbusStateType data_bus_state;
 
@@ -263,6 +326,9 @@ class AHBCtrl : public BaseModule<DefaultBase>, public CLKDevice {
     /// Maximum waiting time in arbiter
     sr_param<sc_time> m_max_wait;
 
+    /// Delay charged to decoupled LT transfers for an occupied bus
+    sr_param<sc_time> m_contention;
+
     /// ID of the master with the maximum waiting time
     sr_param<uint64_t> m_max_wait_master;  // NOLINT(runtime/int)
 
@@ -366,16 +432,53 @@ class AHBCtrl : public BaseModule<DefaultBase>, public CLKDevice {
     /// Helper function for creating slave map decoder entries
     void setAddressMap(const uint32_t binding, const uint32_t hindex, const uint32_t haddr, const uint32_t hmask);
 
+    /// Fill the flat decoder table from slave_map
+    void buildDecodeTable();
+
     /// Get slave index for a given address
     int get_index(const uint32_t address);
 
-    /// Returns a PNP register from the slave configuration area
-    unsigned int getPNPReg(const uint32_t address);
+    /// True if the address is in the configuration area (PNP)
+    bool is_pnp(const uint32_t address) const {
+      return (m_decode[address >> 20] & DECODE_PNP) && !((address ^ m_pnp_addr) & m_pnp_mask);
+    }
+
+    /// Decoupled LT mode: moves the start of a transfer of the given
+    /// length to the first free gap which holds all of it. Returns the
+    /// contention delay.
+    sc_time busyStall(const sc_time &start, const sc_time &length);
+
+    /// Decoupled LT mode: places a transfer which started at start and
+    /// ends at the annotated delay on the timeline. Adds the contention
+    /// to delay and start.
+    void busySchedule(sc_time &start, sc_time &delay);
+
+    /// Decoupled LT mode: enters a transfer into the occupied intervals
+    void busyOccupy(const sc_time &start, const sc_time &end);
 
-    /// Keeps track of master-payload relation
-    void addPendingTransaction(
+    /// Fill the ROM image of the configuration area (PNP)
+    void buildPNPRom();
+
+    /// Copies a read of the configuration area (PNP) from the ROM image.
+    /// Returns the number of 32bit registers touched.
+    uint32_t readPNP(const uint32_t address, uint8_t *data, const uint32_t length);
+
+    /// Appends a record for a new transaction of a master
+    connection_t *addPendingTransaction(
+        tlm::tlm_generic_payload &trans,  // NOLINT(runtime/references)
+        const uint32_t master_id,
+        const uint32_t slave_id);
+
+    /// Returns the record of a transaction of a master
+    connection_t *getPendingTransaction(
         tlm::tlm_generic_payload &trans,  // NOLINT(runtime/references)
-        connection_t connection);
+        const uint32_t master_id);
+
+    /// Removes the record of a completed transaction
+    void removePendingTransaction(connection_t *connection);
+
+    /// Selects the next master to own the address bus, -1 if none
+    int32_t selectMaster();
 
     /// Check memory map for overlaps
     void checkMemMap();
@@ -285,7 +285,8 @@ bool AHBMem::get_direct_mem_ptr(tlm::tlm_generic_payload& trans, tlm::tlm_dmi& d
   dmi_data.set_dmi_ptr(m_storage->get_dmi_ptr());
   dmi_data.set_start_address(0);
   dmi_data.set_end_address(get_ahb_bar_size(0));
-  dmi_data.set_read_latency(SC_ZERO_TIME);
+  // Wait states of an access, the words are charged by the initiator
+  dmi_data.set_read_latency(clock_cycle * g_wait_states);
   dmi_data.set_write_latency(SC_ZERO_TIME);
   v::info << name() << "allow_dmi_rw is: " << v::uint32 << m_storage->allow_dmi_rw() << v::endl;
   return m_storage->allow_dmi_rw();
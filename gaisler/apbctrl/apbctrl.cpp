@@ -12,10 +12,12 @@
 /// @author Thomas Schuster
 ///
 
+#include <string.h>
 #include <map>
 #include <utility>
 
 #include "gaisler/apbctrl/apbctrl.h"
+#include "core/common/apbslave.h"
 #include "core/common/vendian.h"
 #include "core/common/verbose.h"
 #include "core/common/sr_report.h"
@@ -49,6 +51,7 @@ APBCtrl::APBCtrl(
   g_pow_mon("pow_mon", pow_mon, m_generics),
   m_ambaLayer(ambaLayer),
   num_of_bindings(0),
+  m_burst_slaves(0),
   m_total_transactions("total_transactions", 0ull, m_counters),
   m_right_transactions("successful_transactions", 0ull, m_counters),
   sta_power_norm("sta_power_norm", 2.11e+6, m_power),  // Normalized static power input
@@ -75,12 +78,16 @@ APBCtrl::APBCtrl(
     ("ambaLayer", ambaLayer)
     ("Created an APBCtrl with this parameters");
 
-  // initialize the slave_map_cache with some bogus numbers which will trigger MISS
-  slave_info_t tmp;
-  tmp.pindex = 0;
-  tmp.pmask  = ~0;
-  tmp.binding = ~0;
-  slave_map_cache = std::pair<uint32_t, slave_info_t>(~0, tmp);
+  // Nothing is decoded before start_of_simulation
+  memset(m_decode, DECODE_NONE, sizeof(m_decode));
+  memset(m_pnp_rom, 0, PNP_SIZE);
+
+  // Pointers to deviceinfo fields will be set in start_of_simulation
+  for (int i = 0; i < 16; i++) {
+    mSlaves[i] = NULL;
+  }
+
+  ahb.register_get_direct_mem_ptr(this, &APBCtrl::get_direct_mem_ptr);
 }
 
 // Reset handler
@@ -115,53 +122,94 @@ void APBCtrl::setAddressMap(const uint32_t binding, const uint32_t pindex, const
   slave_map.insert(std::pair<uint32_t, slave_info_t>(paddr, tmp));
 }
 
+/// Fill the flat decoder table from slave_map
+void APBCtrl::buildDecodeTable() {
+  memset(m_decode, DECODE_NONE, sizeof(m_decode));
+
+  // Ascending base addresses: where slaves overlap the higher one wins,
+  // as it did for the upper_bound lookup in slave_map.
+  for (std::map<uint32_t, slave_info_t>::iterator it = slave_map.begin(); it != slave_map.end(); it++) {
+    for (uint32_t seg = 0; seg < DECODE_SEGMENTS; seg++) {
+      if (!((seg ^ it->first) & it->second.pmask)) {
+        m_decode[seg] = it->second.binding;
+      }
+    }
+  }
+
+  // The configuration area takes precedence over the slaves
+  for (uint32_t seg = 0; seg < DECODE_SEGMENTS; seg++) {
+    if (!(((seg << 8) ^ m_pnpbase) & m_pnpbase)) {
+      m_decode[seg] |= DECODE_PNP;
+    }
+  }
+}
+
 /// Find slave index by address
 int APBCtrl::get_index(const uint32_t address) {
   // Use 12 bit segment address for decoding
-  uint32_t addr = (address >> 8) & 0xfff;
-
-  slave_info_t info = slave_map_cache.second;
-  if ( ! ((addr ^ slave_map_cache.first) & info.pmask) ) {
-    // APB: Device == BAR)
-    m_right_transactions++;
-    return slave_map_cache.second.binding;
-  }
+  uint32_t index = m_decode[(address >> 8) & 0xfff] & DECODE_INDEX;
 
-  std::map<uint32_t, slave_info_t>::iterator it = --(slave_map.upper_bound( addr ));
-  info = it->second;
-  if ( ! ((addr ^ it->first) & info.pmask) ) {
-    // MISS in the cache: update cache
-    slave_map_cache = *it;
-    
+  if (index != DECODE_NONE) {
     // APB: Device == BAR)
     m_right_transactions++;
-    return it->second.binding;
+    return index;
   }
 
   // no slave found
   return -1;
 }
 
-// Returns a PNP register from the APB configuration area (upper 4kb of address space)
-uint32_t APBCtrl::getPNPReg(const uint32_t address) {
-  // Calculate address offset in configuration area
-  uint32_t addr = address - (get_ahb_bar_addr(0) + m_pnpbase);
-  // Calculate index of the device in mSlaves pointer array (8 byte per device)
-  uint32_t device = (addr >> 2) >> 1;
-  // Calculate offset within device information
-  uint32_t offset = (addr >> 2) & 0x1;
+// Fill the ROM image of the APB configuration area
+void APBCtrl::buildPNPRom() {
+  memset(m_pnp_rom, 0, PNP_SIZE);
 
-  if ((device < 16) && (mSlaves[device] != NULL)) {
-    m_right_transactions++;
-    uint32_t result = mSlaves[device][offset];
+  // 8 byte per device
+  for (uint32_t device = 0; device < 16; device++) {
+    if (mSlaves[device] != NULL) {
+      for (uint32_t offset = 0; offset < 2; offset++) {
+        uint32_t reg = mSlaves[device][offset];
 #ifdef LITTLE_ENDIAN_BO
-    swap_Endianess(result);
+        swap_Endianess(reg);
 #endif
-    return result;
+        memcpy(&m_pnp_rom[(device << 3) + (offset << 2)], &reg, 4);
+      }
+    }
+  }
+}
+
+// Copies a read of the APB configuration area from the ROM image
+uint32_t APBCtrl::readPNP(const uint32_t address, uint8_t *data, const uint32_t length) {
+  uint32_t offset = address & (PNP_SIZE - 1);
+
+  m_right_transactions++;
+
+  if (offset + length <= PNP_SIZE) {
+    memcpy(data, &m_pnp_rom[offset], length);
   } else {
-    v::debug << name() << "Access to not existing PNP Register!" << v::endl;
-    return 0;
+    v::debug << name() << "Read beyond the PNP area!" << v::endl;
+    memcpy(data, &m_pnp_rom[offset], PNP_SIZE - offset);
+    memset(data + PNP_SIZE - offset, 0, length - (PNP_SIZE - offset));
   }
+
+  return ((offset & 0x3) + length + 3) >> 2;
+}
+
+// Grants read-only direct access to the ROM image of the configuration area
+bool APBCtrl::get_direct_mem_ptr(tlm::tlm_generic_payload& trans, tlm::tlm_dmi& dmi_data) {
+  uint32_t addr = trans.get_address();
+
+  // The slaves never grant direct access
+  if (!(m_decode[(addr >> 8) & 0xfff] & DECODE_PNP)) {
+    return false;
+  }
+
+  dmi_data.allow_read();
+  dmi_data.set_dmi_ptr(m_pnp_rom);
+  dmi_data.set_start_address(addr & ~(PNP_SIZE - 1));
+  dmi_data.set_end_address((addr & ~(PNP_SIZE - 1)) + PNP_SIZE - 1);
+  dmi_data.set_read_latency(SC_ZERO_TIME);
+  dmi_data.set_write_latency(SC_ZERO_TIME);
+  return true;
 }
 
 // Functional part of the model (decoding logic)
@@ -172,6 +220,7 @@ uint32_t APBCtrl::exec_func(
 
   payload_t * apb_gp = NULL;
   unsigned int i = 0;
+  unsigned int burst = 0;
   m_total_transactions++;
   transport_statistics(ahb_gp);
 
@@ -184,22 +233,16 @@ uint32_t APBCtrl::exec_func(
       
   // Is this an access to the configuration area
   // The configuration area is always in the upper 0xFF000 area
-  if (((addr ^ m_pnpbase) & m_pnpbase) == 0) {
+  if (m_decode[(addr >> 8) & 0xfff] & DECODE_PNP) {
     // Configuration area is read only
 
     if (ahb_gp.get_command() == tlm::TLM_READ_COMMAND) {
-      // addr = addr - ((m_pnpbase) & (m_pnpbase));
-      for (uint32_t i = 0; i < length; i++) {
-        // uint32_t word = (addr + i) >> 2;
-        uint32_t byte = (addr + i) & 0x3;
-        uint32_t reg = getPNPReg(addr + i);
-
-        data[i] = (reinterpret_cast<uint8_t *>(&reg))[byte];
-
-        delay += clock_cycle;
-      }
+      // One cycle per 32bit register
+      delay += clock_cycle * readPNP(addr, data, length);
 
+      // The image may be read directly from now on
       ahb_gp.set_response_status(tlm::TLM_OK_RESPONSE);
+      ahb_gp.set_dmi_allowed(true);
     } else {
       v::error << name() << " Forbidden write to APBCTRL configuration area (PNP)!" << v::endl;
       ahb_gp.set_response_status(tlm::TLM_COMMAND_ERROR_RESPONSE);
@@ -208,23 +251,40 @@ uint32_t APBCtrl::exec_func(
     return ahb_gp.get_data_length();
   }
 
-  // Split up transaction into multiple 32bit APB accesses
-  for (i = 0;i < length; i+=4) {
+  // Split up transaction into APB accesses. Consecutive words of a slave
+  // taking multi-word accesses are forwarded as one burst, all others as
+  // single 32bit accesses.
+  for (i = 0; i < length; i += burst) {
 
     // Find slave by address / returns slave index or -1 for not mapped
     int index = get_index(addr+i);  
 
+    burst = (length <= 4) ? length : 4;
+
     // For valid slave index
     if(index >= 0) {
 
+      // Extend the burst up to the first segment of another slave
+      if ((m_burst_slaves & (1 << index)) && (length > 4) && !((addr | length) & 0x3)) {
+        burst = length - i;
+        for (uint32_t seg = (((addr + i) | 0xff) + 1) - addr; seg < length; seg += 0x100) {
+          if ((m_decode[((addr + seg) >> 8) & 0xfff] & DECODE_INDEX) != static_cast<uint32_t>(index)) {
+            burst = seg - i;
+            break;
+          }
+        }
+      }
+
       // -- For Debug only --
-      uint32_t a = 0;
-      socket_t *other_socket = apb.get_other_side(index, a);
-      sc_core::sc_object *obj = other_socket->get_parent();
+      if (v::debug) {
+        uint32_t a = 0;
+        socket_t *other_socket = apb.get_other_side(index, a);
+        sc_core::sc_object *obj = other_socket->get_parent();
 
-      v::debug << name() << "Forwarding request to APB slave:" << obj->name()
-         << "@0x" << hex << v::setfill('0') << v::setw(8)
-         << ((ahb_gp.get_address() & 0x000fffff)+i) << endl;
+        v::debug << name() << "Forwarding request to APB slave:" << obj->name()
+           << "@0x" << hex << v::setfill('0') << v::setw(8)
+           << ((ahb_gp.get_address() & 0x000fffff)+i) << endl;
+      }
       // --------------------
 
       // Take APB transaction from pool
@@ -239,7 +299,7 @@ uint32_t APBCtrl::exec_func(
       apb_gp->set_command(ahb_gp.get_command());
       // Substract the base address of the bridge
       apb_gp->set_address((ahb_gp.get_address() & 0x000fffff)+i);
-      apb_gp->set_data_length(( length <=4 ) ? length : 4); 
+      apb_gp->set_data_length(burst);
       apb_gp->set_byte_enable_ptr(ahb_gp.get_byte_enable_ptr());
       apb_gp->set_data_ptr(ahb_gp.get_data_ptr()+i);
 
@@ -252,15 +312,16 @@ uint32_t APBCtrl::exec_func(
 
         apb[index]->b_transport(*apb_gp, delay);
 
-        // Add delay for APB setup cycle
-        delay += clock_cycle;
+        // Add delay for APB setup cycle, one per word
+        uint32_t words = (burst > 4) ? (burst >> 2) : 1;
+        delay += clock_cycle * words;
 
         // Power Calculation
         if (g_pow_mon) {
           if (ahb_gp.get_command() == tlm::TLM_READ_COMMAND) {
-            dyn_reads += (ahb_gp.get_data_length() >> 2) + 1;
+            dyn_reads += ((ahb_gp.get_data_length() >> 2) + 1) * words;
           } else {
-            dyn_writes += (ahb_gp.get_data_length() >> 2) + 1;
+            dyn_writes += ((ahb_gp.get_data_length() >> 2) + 1) * words;
           }
         }
       } else {
@@ -335,6 +396,11 @@ void APBCtrl::start_of_simulation() {
       // Map device information into PNP region
       mSlaves[sbusid] = deviceinfo;
 
+      // The register sockets of APBSlave take bursts of words
+      if (dynamic_cast<APBSlave *>(obj)) {
+        m_burst_slaves |= 1 << i;
+      }
+
       // check 'type'filed of bar[i] (must be != 0)
       if (slave->get_apb_type()) {
         // get base address and mask from BAR
@@ -352,6 +418,12 @@ void APBCtrl::start_of_simulation() {
     }
   }
 
+  // Build the flat decoder from the slave map
+  buildDecodeTable();
+
+  // Materialize the configuration area
+  buildPNPRom();
+
   // End of decoder initialization
   v::info << name() << "******************************************************************************* " << v::endl;
 
@@ -426,50 +498,52 @@ sc_core::sc_time APBCtrl::get_clock() {
   return clock_cycle;
 }
 
-struct apb_check_slave_type {
-  uint32_t start;
-  uint32_t end;
-  uint32_t index;
-};
-
 // Check the memory map for overlaps
 void APBCtrl::checkMemMap() {
-  map<uint32_t, apb_check_slave_type> slaves;
-  typedef map<uint32_t, apb_check_slave_type>::iterator iter_t;
-  struct apb_check_slave_type last;
-  last.start = 0;
-  last.end = 0;
-  last.index = ~0;
-
   for (std::map<uint32_t, slave_info_t>::iterator iter = slave_map.begin(); iter != slave_map.end(); iter++) {
-    uint32_t start_addr = (iter->first & iter->second.pmask) << 12;
-    uint32_t size = ((~iter->second.pmask & 0xFFF) + 1) << 12;
-    struct apb_check_slave_type obj;
-    obj.start = start_addr;
-    obj.end = start_addr + size - 1;
-    obj.index = iter->second.pindex;
-    slaves.insert(make_pair(start_addr, obj));
-  }
-  for (iter_t iter = slaves.begin(); iter != slaves.end(); iter++) {
-    // First Slave need it in last to start
-    if (last.index != ~0u) {
-      // All other elements
-      // See if the last element is begining and end befor the current
-      if ((last.start >= iter->second.start) || (last.end >= iter->second.start)) {
-        uint32_t a = 0;
-        socket_t *other_socket = apb.get_other_side(last.index, a);
-        sc_core::sc_object *obj = other_socket->get_parent();
+    uint32_t start = (iter->first & iter->second.pmask) << 8;
+    uint32_t end = start + ((((~iter->second.pmask) & 0xFFF) + 1) << 8) - 1;
+    uint32_t index = iter->second.binding;
+
+    // First segment of the slave range decoded to another slave (per slave)
+    uint32_t shadowed[16];
+    bool overlap = false;
+    // Slave range shares a segment with the configuration area
+    bool pnp = false;
+    for (uint32_t i = 0; i < 16; i++) {
+      shadowed[i] = ~0u;
+    }
 
-        other_socket = apb.get_other_side(iter->second.index, a);
-        sc_core::sc_object *obj2 = other_socket->get_parent();
+    for (uint32_t seg = 0; seg < DECODE_SEGMENTS; seg++) {
+      if (!((seg ^ iter->first) & iter->second.pmask)) {
+        uint32_t other = m_decode[seg] & DECODE_INDEX;
+        if ((other != index) && (shadowed[other] == ~0u)) {
+          shadowed[other] = seg;
+          overlap = true;
+        }
+        if (m_decode[seg] & DECODE_PNP) {
+          pnp = true;
+        }
+      }
+    }
 
-        v::error << name() << "Overlap in AHB memory mapping." << v::endl;
-        v::error << name() << obj->name() << " " << v::uint32 << last.start << " - " << v::uint32 << last.end << endl;
-        v::error << name() << obj2->name() << " " << v::uint32 << iter->second.start << " - " << v::uint32 <<
-        iter->second.end << endl;
+    uint32_t a = 0;
+    sc_core::sc_object *obj = apb.get_other_side(index, a)->get_parent();
+    if (overlap) {
+      for (uint32_t other = 0; other < num_of_bindings; other++) {
+        if (shadowed[other] != ~0u) {
+          sc_core::sc_object *obj2 = apb.get_other_side(other, a)->get_parent();
+
+          v::error << name() << "Overlap in APB memory mapping." << v::endl;
+          v::error << name() << obj->name() << " " << v::uint32 << start << " - " << v::uint32 << end << endl;
+          v::error << name() << obj2->name() << " decodes " << v::uint32 << (shadowed[other] << 8) << endl;
+        }
       }
     }
-    last = iter->second;
+    if (pnp) {
+      v::warn << name() << obj->name() << " " << v::uint32 << start << " - " << v::uint32 << end <<
+        " overlaps the configuration area at " << v::uint32 << m_pnpbase << endl;
+    }
   }
 }
 
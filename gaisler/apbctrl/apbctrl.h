@@ -46,11 +46,21 @@ class APBCtrl : public AHBSlave<>, public CLKDevice {
     /// Helper function for creating slave map decoder entries
     void setAddressMap(const uint32_t binding, const uint32_t pindex, const uint32_t paddr, const uint32_t pmask);
 
+    /// Fill the flat decoder table from slave_map
+    void buildDecodeTable();
+
     /// Get slave index for a given address
     int get_index(const uint32_t address);
 
-    /// Returns a PNP register from the APB configuration area (upper 4kb of address space)
-    unsigned int getPNPReg(const uint32_t address);
+    /// Fill the ROM image of the APB configuration area (upper 4kb of address space)
+    void buildPNPRom();
+
+    /// Copies a read of the APB configuration area from the ROM image.
+    /// Returns the number of 32bit registers touched.
+    uint32_t readPNP(const uint32_t address, uint8_t *data, const uint32_t length);
+
+    /// Grants read-only direct access to the ROM image of the configuration area
+    bool get_direct_mem_ptr(tlm::tlm_generic_payload& trans, tlm::tlm_dmi& dmi_data);
 
     /// Reset Callback
     void dorst();
@@ -124,6 +134,13 @@ class APBCtrl : public AHBSlave<>, public CLKDevice {
     /// Array of slave device information (PNP)
     const uint32_t *mSlaves[16];
 
+    /// Size of the configuration area (PNP)
+    static const uint32_t PNP_SIZE = 0x1000;
+
+    /// ROM image of the configuration area in bus byte order, built from
+    /// mSlaves in start_of_simulation
+    uint8_t m_pnp_rom[PNP_SIZE];
+
     typedef struct {
       uint32_t pindex;
       uint32_t pmask;
@@ -132,7 +149,22 @@ class APBCtrl : public AHBSlave<>, public CLKDevice {
 
     /// Address decoder table (slave index, (bar addr, mask))
     std::map<uint32_t, slave_info_t> slave_map;
-    std::pair<uint32_t, slave_info_t> slave_map_cache;
+
+    /// Number of 256 byte segments in the 1MB bridge area
+    static const uint32_t DECODE_SEGMENTS = 4096;
+
+    /// Decode table entry of a segment without slave
+    static const uint8_t DECODE_NONE = 0x7f;
+
+    /// Mask selecting the slave index of a decode table entry
+    static const uint8_t DECODE_INDEX = 0x7f;
+
+    /// Flag of segments in the configuration area (PNP)
+    static const uint8_t DECODE_PNP = 0x80;
+
+    /// Flat address decoder: slave index per 256 byte segment, built from
+    /// slave_map in start_of_simulation
+    uint8_t m_decode[DECODE_SEGMENTS];
 
     // Event queue for AT mode
     tlm_utils::peq_with_get<tlm::tlm_generic_payload> m_AcceptPEQ;
@@ -162,6 +194,9 @@ class APBCtrl : public AHBSlave<>, public CLKDevice {
     /// Number of slaves bound at the APB side
     uint32_t num_of_bindings;
 
+    /// Bit i is set if the slave of binding i takes multi-word accesses
+    uint32_t m_burst_slaves;
+
     // *****************************************************
     // Performance Counters
 
@@ -42,186 +42,201 @@
 #include <list>
 
 using namespace leon3_funclt_trap;
+leon3_funclt_trap::RegisterWindow::RegisterWindow() : base(0){
+    for(int i = 0; i < NUM_WINDOW_SLOTS; i++){
+        this->regs[i] = NULL;
+        this->values[i] = NULL;
+    }
+}
+
+void leon3_funclt_trap::RegisterWindow::setRegisters( Reg32_3 * winRegs, unsigned \
+    int numRegs ) throw(){
+    for(int i = 0; i < NUM_WINDOW_SLOTS; i++){
+        this->regs[i] = &winRegs[i % numRegs];
+        this->values[i] = this->regs[i]->getStorage();
+    }
+}
+
 void leon3_funclt_trap::Alias::immediateWrite( const unsigned int & value ) throw(){
-    this->reg->immediateWrite(value);
+    this->getReg()->immediateWrite(value);
 }
 
 unsigned int leon3_funclt_trap::Alias::readNewValue() throw(){
-    return this->reg->readNewValue();
+    return this->getReg()->readNewValue();
 }
 
 unsigned int leon3_funclt_trap::Alias::operator ~() throw(){
-    return ~(*this->reg + this->offset);
+    return ~(this->readTarget() + this->offset);
 }
 
 unsigned int leon3_funclt_trap::Alias::operator +( const Alias & other ) const throw(){
-    return ((*this->reg + this->offset) + *other.reg);
+    return ((this->readTarget() + this->offset) + other.readTarget());
 }
 
 unsigned int leon3_funclt_trap::Alias::operator -( const Alias & other ) const throw(){
-    return ((*this->reg + this->offset) - *other.reg);
+    return ((this->readTarget() + this->offset) - other.readTarget());
 }
 
 unsigned int leon3_funclt_trap::Alias::operator *( const Alias & other ) const throw(){
-    return ((*this->reg + this->offset) * *other.reg);
+    return ((this->readTarget() + this->offset) * other.readTarget());
 }
 
 unsigned int leon3_funclt_trap::Alias::operator /( const Alias & other ) const throw(){
-    return ((*this->reg + this->offset) / *other.reg);
+    return ((this->readTarget() + this->offset) / other.readTarget());
 }
 
 unsigned int leon3_funclt_trap::Alias::operator |( const Alias & other ) const throw(){
-    return ((*this->reg + this->offset) | *other.reg);
+    return ((this->readTarget() + this->offset) | other.readTarget());
 }
 
 unsigned int leon3_funclt_trap::Alias::operator &( const Alias & other ) const throw(){
-    return ((*this->reg + this->offset) & *other.reg);
+    return ((this->readTarget() + this->offset) & other.readTarget());
 }
 
 unsigned int leon3_funclt_trap::Alias::operator ^( const Alias & other ) const throw(){
-    return ((*this->reg + this->offset) ^ *other.reg);
+    return ((this->readTarget() + this->offset) ^ other.readTarget());
 }
 
 unsigned int leon3_funclt_trap::Alias::operator <<( const Alias & other ) const throw(){
-    return ((*this->reg + this->offset) << *other.reg);
+    return ((this->readTarget() + this->offset) << other.readTarget());
 }
 
 unsigned int leon3_funclt_trap::Alias::operator >>( const Alias & other ) const throw(){
-    return ((*this->reg + this->offset) >> *other.reg);
+    return ((this->readTarget() + this->offset) >> other.readTarget());
 }
 
 Alias & leon3_funclt_trap::Alias::operator =( const Alias & other ) throw(){
-    *this->reg = *other.reg;
+    *this = other.readTarget();
     return *this;
 }
 
 Alias & leon3_funclt_trap::Alias::operator +=( const Alias & other ) throw(){
-    *this->reg += *other.reg;
+    *this += other.readTarget();
     return *this;
 }
 
 Alias & leon3_funclt_trap::Alias::operator -=( const Alias & other ) throw(){
-    *this->reg -= *other.reg;
+    *this -= other.readTarget();
     return *this;
 }
 
 Alias & leon3_funclt_trap::Alias::operator *=( const Alias & other ) throw(){
-    *this->reg *= *other.reg;
+    *this *= other.readTarget();
     return *this;
 }
 
 Alias & leon3_funclt_trap::Alias::operator /=( const Alias & other ) throw(){
-    *this->reg /= *other.reg;
+    *this /= other.readTarget();
     return *this;
 }
 
 Alias & leon3_funclt_trap::Alias::operator |=( const Alias & other ) throw(){
-    *this->reg |= *other.reg;
+    *this |= other.readTarget();
     return *this;
 }
 
 Alias & leon3_funclt_trap::Alias::operator &=( const Alias & other ) throw(){
-    *this->reg &= *other.reg;
+    *this &= other.readTarget();
     return *this;
 }
 
 Alias & leon3_funclt_trap::Alias::operator ^=( const Alias & other ) throw(){
-    *this->reg ^= *other.reg;
+    *this ^= other.readTarget();
     return *this;
 }
 
 Alias & leon3_funclt_trap::Alias::operator <<=( const Alias & other ) throw(){
-    *this->reg <<= *other.reg;
+    *this <<= other.readTarget();
     return *this;
 }
 
 Alias & leon3_funclt_trap::Alias::operator >>=( const Alias & other ) throw(){
-    *this->reg >>= *other.reg;
+    *this >>= other.readTarget();
     return *this;
 }
 
 bool leon3_funclt_trap::Alias::operator <( const Register & other ) const throw(){
-    return ((*this->reg + this->offset) < other);
+    return ((this->readTarget() + this->offset) < other);
 }
 
 bool leon3_funclt_trap::Alias::operator >( const Register & other ) const throw(){
-    return ((*this->reg + this->offset) > other);
+    return ((this->readTarget() + this->offset) > other);
 }
 
 bool leon3_funclt_trap::Alias::operator <=( const Register & other ) const throw(){
-    return ((*this->reg + this->offset) <= other);
+    return ((this->readTarget() + this->offset) <= other);
 }
 
 bool leon3_funclt_trap::Alias::operator >=( const Register & other ) const throw(){
-    return ((*this->reg + this->offset) >= other);
+    return ((this->readTarget() + this->offset) >= other);
 }
 
 bool leon3_funclt_trap::Alias::operator ==( const Register & other ) const throw(){
-    return ((*this->reg + this->offset) == other);
+    return ((this->readTarget() + this->offset) == other);
 }
 
 bool leon3_funclt_trap::Alias::operator !=( const Register & other ) const throw(){
-    return ((*this->reg + this->offset) != other);
+    return ((this->readTarget() + this->offset) != other);
 }
 
 Alias & leon3_funclt_trap::Alias::operator =( const Register & other ) throw(){
-    *this->reg = other;
+    *this->getReg() = other;
     return *this;
 }
 
 Alias & leon3_funclt_trap::Alias::operator +=( const Register & other ) throw(){
-    *this->reg += other;
+    *this->getReg() += other;
     return *this;
 }
 
 Alias & leon3_funclt_trap::Alias::operator -=( const Register & other ) throw(){
-    *this->reg -= other;
+    *this->getReg() -= other;
     return *this;
 }
 
 Alias & leon3_funclt_trap::Alias::operator *=( const Register & other ) throw(){
-    *this->reg *= other;
+    *this->getReg() *= other;
     return *this;
 }
 
 Alias & leon3_funclt_trap::Alias::operator /=( const Register & other ) throw(){
-    *this->reg /= other;
+    *this->getReg() /= other;
     return *this;
 }
 
 Alias & leon3_funclt_trap::Alias::operator |=( const Register & other ) throw(){
-    *this->reg |= other;
+    *this->getReg() |= other;
     return *this;
 }
 
 Alias & leon3_funclt_trap::Alias::operator &=( const Register & other ) throw(){
-    *this->reg &= other;
+    *this->getReg() &= other;
     return *this;
 }
 
 Alias & leon3_funclt_trap::Alias::operator ^=( const Register & other ) throw(){
-    *this->reg ^= other;
+    *this->getReg() ^= other;
     return *this;
 }
 
 Alias & leon3_funclt_trap::Alias::operator <<=( const Register & other ) throw(){
-    *this->reg <<= other;
+    *this->getReg() <<= other;
     return *this;
 }
 
 Alias & leon3_funclt_trap::Alias::operator >>=( const Register & other ) throw(){
-    *this->reg >>= other;
+    *this->getReg() >>= other;
     return *this;
 }
 
 std::ostream & leon3_funclt_trap::Alias::operator <<( std::ostream & stream ) const \
     throw(){
-    stream << *this->reg + this->offset;
+    stream << this->readTarget() + this->offset;
     return stream;
 }
 
 void leon3_funclt_trap::Alias::directSetAlias( Alias & newAlias ) throw(){
-    this->reg = newAlias.reg;
+    this->copyTarget(newAlias);
     this->offset = newAlias.offset;
     if(this->referringAliases != NULL){
         this->referringAliases->referredAliases.remove(this);
@@ -232,6 +247,8 @@ void leon3_funclt_trap::Alias::directSetAlias( Alias & newAlias ) throw(){
 
 void leon3_funclt_trap::Alias::directSetAlias( Register & newAlias ) throw(){
     this->reg = &newAlias;
+    this->value = newAlias.getStorage();
+    this->window = NULL;
     if(this->referringAliases != NULL){
         this->referringAliases->referredAliases.remove(this);
     }
@@ -239,16 +256,16 @@ void leon3_funclt_trap::Alias::directSetAlias( Register & newAlias ) throw(){
 }
 
 leon3_funclt_trap::Alias::Alias( Register * reg, unsigned int offset ) : reg(reg), \
-    offset(offset), defaultOffset(0){
+    value(reg != NULL ? reg->getStorage() : NULL), window(NULL), windowIndex(0), offset(offset), defaultOffset(0){
     this->referringAliases = NULL;
 }
 
-leon3_funclt_trap::Alias::Alias() : offset(0), defaultOffset(0){
+leon3_funclt_trap::Alias::Alias() : value(NULL), window(NULL), windowIndex(0), offset(0), defaultOffset(0){
     this->referringAliases = NULL;
 }
 
 leon3_funclt_trap::Alias::Alias( Alias * initAlias, unsigned int offset ) : reg(initAlias->reg), \
-    offset(initAlias->offset + offset), defaultOffset(offset){
+    value(initAlias->value), window(initAlias->window), windowIndex(initAlias->windowIndex), offset(initAlias->offset + offset), defaultOffset(offset){
     initAlias->referredAliases.push_back(this);
     this->referringAliases = initAlias;
 }
@@ -44,68 +44,196 @@
 
 #define FUNC_MODEL
 #define LT_IF
+#define NUM_WINDOW_SLOTS 136
 namespace leon3_funclt_trap{
 
+    /// Windowed view of the WINREGS bank. The windowed aliases (REGS[8..31]
+    /// and everything bound to them) address the bank relative to the
+    /// current window base, so a window switch only moves the base instead
+    /// of rebinding every alias. The table repeats the first registers of the
+    /// bank after its end, so that the ins of the last window (which are the
+    /// outs of window 0) need no wrap-around on access.
+    class RegisterWindow{
+        private:
+        Register * regs[NUM_WINDOW_SLOTS];
+        unsigned int * values[NUM_WINDOW_SLOTS];
+        unsigned int base;
+
+        public:
+        RegisterWindow();
+        void setRegisters( Reg32_3 * winRegs, unsigned int numRegs ) throw();
+        inline void setCwp( unsigned int cwp ) throw(){
+            this->base = (cwp*16) % (NUM_WINDOW_SLOTS - 8);
+        }
+        inline Register & getRegister( unsigned int index ) const throw(){
+            return *this->regs[this->base + index];
+        }
+        /// Returns the storage of the register, or NULL if the access must be
+        /// notified to scireg callbacks.
+        inline unsigned int * getDirect( unsigned int index ) const throw(){
+            unsigned int pos = this->base + index;
+            if(this->regs[pos]->hasCallbacks()){
+                return NULL;
+            }
+            return this->values[pos];
+        }
+    };
+
     class Alias{
         private:
         Register * reg;
+        unsigned int * value;
+        RegisterWindow * window;
+        unsigned int windowIndex;
         unsigned int offset;
         unsigned int defaultOffset;
         std::list< Alias * > referredAliases;
         Alias * referringAliases;
 
+        /// The register storage is accessed directly, without going through
+        /// the virtual operators of Register, unless the register has no
+        /// storage or scireg callbacks have to be notified of the access.
+        inline unsigned int * directValue() const throw(){
+            if(this->window != NULL){
+                return this->window->getDirect(this->windowIndex);
+            }
+            if(this->value != NULL && !this->reg->hasCallbacks()){
+                return this->value;
+            }
+            return NULL;
+        }
+        inline unsigned int readTarget() const throw(){
+            const unsigned int * direct = this->directValue();
+            if(direct != NULL){
+                return *direct;
+            }
+            return *this->getReg();
+        }
+        inline void copyTarget( const Alias & other ) throw(){
+            this->reg = other.reg;
+            this->value = other.value;
+            this->window = other.window;
+            this->windowIndex = other.windowIndex;
+        }
+
         public:
         ~Alias();
         Alias( Alias * initAlias, unsigned int offset = 0 );
         Alias();
         Alias( Register * reg, unsigned int offset = 0 );
         inline InnerField & operator []( int bitField ) throw(){
-            return (*this->reg)[bitField];
+            return (*this->getReg())[bitField];
         }
         void immediateWrite( const unsigned int & value ) throw();
         unsigned int readNewValue() throw();
         inline Register * getReg() const throw(){
+            if(this->window != NULL){
+                return &this->window->getRegister(this->windowIndex);
+            }
             return this->reg;
         }
+        inline RegisterWindow * getWindow() const throw(){
+            return this->window;
+        }
         unsigned int operator ~() throw();
         inline Alias & operator =( const unsigned int & other ) throw(){
-            *this->reg = other;
+            unsigned int * direct = this->directValue();
+            if(direct != NULL){
+                *direct = other;
+            }
+            else{
+                *this->getReg() = other;
+            }
             return *this;
         }
         inline Alias & operator +=( const unsigned int & other ) throw(){
-            *this->reg += other;
+            unsigned int * direct = this->directValue();
+            if(direct != NULL){
+                *direct += other;
+            }
+            else{
+                *this->getReg() += other;
+            }
             return *this;
         }
         inline Alias & operator -=( const unsigned int & other ) throw(){
-            *this->reg -= other;
+            unsigned int * direct = this->directValue();
+            if(direct != NULL){
+                *direct -= other;
+            }
+            else{
+                *this->getReg() -= other;
+            }
             return *this;
         }
         inline Alias & operator *=( const unsigned int & other ) throw(){
-            *this->reg *= other;
+            unsigned int * direct = this->directValue();
+            if(direct != NULL){
+                *direct *= other;
+            }
+            else{
+                *this->getReg() *= other;
+            }
             return *this;
         }
         inline Alias & operator /=( const unsigned int & other ) throw(){
-            *this->reg /= other;
+            unsigned int * direct = this->directValue();
+            if(direct != NULL){
+                *direct /= other;
+            }
+            else{
+                *this->getReg() /= other;
+            }
             return *this;
         }
         inline Alias & operator |=( const unsigned int & other ) throw(){
-            *this->reg |= other;
+            unsigned int * direct = this->directValue();
+            if(direct != NULL){
+                *direct |= other;
+            }
+            else{
+                *this->getReg() |= other;
+            }
             return *this;
         }
         inline Alias & operator &=( const unsigned int & other ) throw(){
-            *this->reg &= other;
+            unsigned int * direct = this->directValue();
+            if(direct != NULL){
+                *direct &= other;
+            }
+            else{
+                *this->getReg() &= other;
+            }
             return *this;
         }
         inline Alias & operator ^=( const unsigned int & other ) throw(){
-            *this->reg ^= other;
+            unsigned int * direct = this->directValue();
+            if(direct != NULL){
+                *direct ^= other;
+            }
+            else{
+                *this->getReg() ^= other;
+            }
             return *this;
         }
         inline Alias & operator <<=( const unsigned int & other ) throw(){
-            *this->reg <<= other;
+            unsigned int * direct = this->directValue();
+            if(direct != NULL){
+                *direct <<= other;
+            }
+            else{
+                *this->getReg() <<= other;
+            }
             return *this;
         }
         inline Alias & operator >>=( const unsigned int & other ) throw(){
-            *this->reg >>= other;
+            unsigned int * direct = this->directValue();
+            if(direct != NULL){
+                *direct >>= other;
+            }
+            else{
+                *this->getReg() >>= other;
+            }
             return *this;
         }
         unsigned int operator +( const Alias & other ) const throw();
@@ -128,31 +256,31 @@ namespace leon3_funclt_trap{
         Alias & operator <<=( const Alias & other ) throw();
         Alias & operator >>=( const Alias & other ) throw();
         inline unsigned int operator +( const Register & other ) const throw(){
-            return ((*this->reg + this->offset) + other);
+            return ((this->readTarget() + this->offset) + other);
         }
         inline unsigned int operator -( const Register & other ) const throw(){
-            return ((*this->reg + this->offset) - other);
+            return ((this->readTarget() + this->offset) - other);
         }
         inline unsigned int operator *( const Register & other ) const throw(){
-            return ((*this->reg + this->offset) * other);
+            return ((this->readTarget() + this->offset) * other);
         }
         inline unsigned int operator /( const Register & other ) const throw(){
-            return ((*this->reg + this->offset) / other);
+            return ((this->readTarget() + this->offset) / other);
         }
         inline unsigned int operator |( const Register & other ) const throw(){
-            return ((*this->reg + this->offset) | other);
+            return ((this->readTarget() + this->offset) | other);
         }
         inline unsigned int operator &( const Register & other ) const throw(){
-            return ((*this->reg + this->offset) & other);
+            return ((this->readTarget() + this->offset) & other);
         }
         inline unsigned int operator ^( const Register & other ) const throw(){
-            return ((*this->reg + this->offset) ^ other);
+            return ((this->readTarget() + this->offset) ^ other);
         }
         inline unsigned int operator <<( const Register & other ) const throw(){
-            return ((*this->reg + this->offset) << other);
+            return ((this->readTarget() + this->offset) << other);
         }
         inline unsigned int operator >>( const Register & other ) const throw(){
-            return ((*this->reg + this->offset) >> other);
+            return ((this->readTarget() + this->offset) >> other);
         }
         bool operator <( const Register & other ) const throw();
         bool operator >( const Register & other ) const throw();
@@ -171,17 +299,17 @@ namespace leon3_funclt_trap{
         Alias & operator <<=( const Register & other ) throw();
         Alias & operator >>=( const Register & other ) throw();
         inline operator unsigned int() const throw(){
-            return *this->reg + this->offset;
+            return this->readTarget() + this->offset;
         }
         std::ostream & operator <<( std::ostream & stream ) const throw();
         inline void updateAlias( Alias & newAlias, unsigned int newOffset ) throw(){
-            this->reg = newAlias.reg;
+            this->copyTarget(newAlias);
             this->offset = newAlias.offset + newOffset;
             this->defaultOffset = newOffset;
             std::list<Alias *>::iterator referredIter, referredEnd;
             for(referredIter = this->referredAliases.begin(), referredEnd = this->referredAliases.end(); \
                 referredIter != referredEnd; referredIter++){
-                (*referredIter)->newReferredAlias(newAlias.reg, newAlias.offset + newOffset);
+                (*referredIter)->newReferredAlias(newAlias, newAlias.offset + newOffset);
             }
             if(this->referringAliases != NULL){
                 this->referringAliases->referredAliases.remove(this);
@@ -192,11 +320,11 @@ namespace leon3_funclt_trap{
         inline void updateAlias( Alias & newAlias ) throw(){
             this->offset = newAlias.offset;
             this->defaultOffset = 0;
-            this->reg = newAlias.reg;
+            this->copyTarget(newAlias);
             std::list<Alias *>::iterator referredIter, referredEnd;
             for(referredIter = this->referredAliases.begin(), referredEnd = this->referredAliases.end(); \
                 referredIter != referredEnd; referredIter++){
-                (*referredIter)->newReferredAlias(newAlias.reg, newAlias.offset);
+                (*referredIter)->newReferredAlias(newAlias, newAlias.offset);
             }
             if(this->referringAliases != NULL){
                 this->referringAliases->referredAliases.remove(this);
@@ -206,12 +334,14 @@ namespace leon3_funclt_trap{
         }
         inline void updateAlias( Register & newAlias, unsigned int newOffset ) throw(){
             this->reg = &newAlias;
+            this->value = newAlias.getStorage();
+            this->window = NULL;
             this->offset = newOffset;
             this->defaultOffset = 0;
             std::list<Alias *>::iterator referredIter, referredEnd;
             for(referredIter = this->referredAliases.begin(), referredEnd = this->referredAliases.end(); \
                 referredIter != referredEnd; referredIter++){
-                (*referredIter)->newReferredAlias(&newAlias, newOffset);
+                (*referredIter)->newReferredAlias(*this, newOffset);
             }
             if(this->referringAliases != NULL){
                 this->referringAliases->referredAliases.remove(this);
@@ -222,10 +352,31 @@ namespace leon3_funclt_trap{
             this->offset = 0;
             this->defaultOffset = 0;
             this->reg = &newAlias;
+            this->value = newAlias.getStorage();
+            this->window = NULL;
+            std::list<Alias *>::iterator referredIter, referredEnd;
+            for(referredIter = this->referredAliases.begin(), referredEnd = this->referredAliases.end(); \
+                referredIter != referredEnd; referredIter++){
+                (*referredIter)->newReferredAlias(*this);
+            }
+            if(this->referringAliases != NULL){
+                this->referringAliases->referredAliases.remove(this);
+            }
+            this->referringAliases = NULL;
+        }
+        /// Binds the alias to slot index of the register window: the alias
+        /// then follows the window base and needs no rebinding on CWP changes.
+        inline void updateAlias( RegisterWindow & newWindow, unsigned int index ) throw(){
+            this->offset = 0;
+            this->defaultOffset = 0;
+            this->reg = NULL;
+            this->value = NULL;
+            this->window = &newWindow;
+            this->windowIndex = index;
             std::list<Alias *>::iterator referredIter, referredEnd;
             for(referredIter = this->referredAliases.begin(), referredEnd = this->referredAliases.end(); \
                 referredIter != referredEnd; referredIter++){
-                (*referredIter)->newReferredAlias(&newAlias);
+                (*referredIter)->newReferredAlias(*this);
             }
             if(this->referringAliases != NULL){
                 this->referringAliases->referredAliases.remove(this);
@@ -234,22 +385,22 @@ namespace leon3_funclt_trap{
         }
         void directSetAlias( Alias & newAlias ) throw();
         void directSetAlias( Register & newAlias ) throw();
-        inline void newReferredAlias( Register * newAlias, unsigned int newOffset ) throw(){
-            this->reg = newAlias;
+        inline void newReferredAlias( const Alias & target, unsigned int newOffset ) throw(){
+            this->copyTarget(target);
             this->offset = newOffset + this->defaultOffset;
             std::list<Alias *>::iterator referredIter, referredEnd;
             for(referredIter = this->referredAliases.begin(), referredEnd = this->referredAliases.end(); \
                 referredIter != referredEnd; referredIter++){
-                (*referredIter)->newReferredAlias(newAlias, newOffset);
+                (*referredIter)->newReferredAlias(target, newOffset);
             }
         }
-        inline void newReferredAlias( Register * newAlias ) throw(){
+        inline void newReferredAlias( const Alias & target ) throw(){
             this->offset = this->defaultOffset;
-            this->reg = newAlias;
+            this->copyTarget(target);
             std::list<Alias *>::iterator referredIter, referredEnd;
             for(referredIter = this->referredAliases.begin(), referredEnd = this->referredAliases.end(); \
                 referredIter != referredEnd; referredIter++){
-                (*referredIter)->newReferredAlias(newAlias);
+                (*referredIter)->newReferredAlias(target);
             }
         }
     };
@@ -0,0 +1,169 @@
+/***************************************************************************\
+ *
+ *
+ *         _/        _/_/_/_/    _/_/    _/      _/   _/_/_/
+ *        _/        _/        _/    _/  _/_/    _/         _/
+ *       _/        _/_/_/    _/    _/  _/  _/  _/     _/_/
+ *      _/        _/        _/    _/  _/    _/_/         _/
+ *     _/_/_/_/  _/_/_/_/    _/_/    _/      _/   _/_/_/
+ *
+ *
+ *
+ *
+ *   This file is part of LEON3.
+ *
+ *   LEON3 is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the
+ *   Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *   or see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *
+ *   (c) 2026 agent
+ *
+\***************************************************************************/
+
+
+
+#include "gaisler/leon3/intunit/blockcache.hpp"
+#include "gaisler/leon3/intunit/instructions.hpp"
+
+using namespace leon3_funclt_trap;
+leon3_funclt_trap::BasicBlock::BasicBlock( unsigned int startPC, unsigned int asi ) : \
+    startPC(startPC), asi(asi), endPC(startPC), size(0), nextVictim(0){
+    this->next[0] = NULL;
+    this->next[1] = NULL;
+}
+
+leon3_funclt_trap::BasicBlock::~BasicBlock(){
+    for(unsigned int i = 0; i < this->instrs.size(); i++){
+        delete this->instrs[i];
+    }
+}
+
+void leon3_funclt_trap::BasicBlock::chain( BasicBlock * block ) throw(){
+    if(block == NULL || this->successor(block->startPC, block->asi) != NULL){
+        return;
+    }
+    if(this->next[0] == NULL){
+        this->next[0] = block;
+    } else if(this->next[1] == NULL){
+        this->next[1] = block;
+    } else {
+        this->next[this->nextVictim] = block;
+        this->nextVictim ^= 1;
+    }
+}
+
+leon3_funclt_trap::BlockCache::BlockCache( unsigned int maxBlockSize ) : maxBlockSize(maxBlockSize), \
+    translations(0), invalidations(0), epoch(0){
+
+}
+
+leon3_funclt_trap::BlockCache::~BlockCache(){
+    this->flush();
+    this->collect();
+}
+
+void leon3_funclt_trap::BlockCache::insert( BasicBlock * block ) throw(){
+    vmap< unsigned int, BasicBlock * >::iterator it = this->blocks.find(block->startPC);
+    if(it != this->blocks.end()){
+        this->retired.push_back(it->second);
+        it->second = block;
+        this->unchain();
+        this->epoch++;
+    } else {
+        this->blocks.insert(std::pair< unsigned int, BasicBlock * >(block->startPC, block));
+    }
+    this->translations++;
+}
+
+void leon3_funclt_trap::BlockCache::invalidate( unsigned int start, unsigned int end ) throw(){
+    unsigned int dropped = this->retired.size();
+    vmap< unsigned int, BasicBlock * >::iterator it = this->blocks.begin();
+    while(it != this->blocks.end()){
+        if(it->second->startPC < end && it->second->endPC > start){
+            this->retired.push_back(it->second);
+            this->blocks.erase(it++);
+        } else {
+            ++it;
+        }
+    }
+    if(this->retired.size() != dropped){
+        this->invalidations += this->retired.size() - dropped;
+        this->unchain();
+        this->epoch++;
+    }
+}
+
+void leon3_funclt_trap::BlockCache::flush() throw(){
+    vmap< unsigned int, BasicBlock * >::iterator it;
+    for(it = this->blocks.begin(); it != this->blocks.end(); ++it){
+        this->retired.push_back(it->second);
+    }
+    this->invalidations += this->blocks.size();
+    this->blocks.clear();
+    this->epoch++;
+}
+
+void leon3_funclt_trap::BlockCache::collect() throw(){
+    for(unsigned int i = 0; i < this->retired.size(); i++){
+        delete this->retired[i];
+    }
+    this->retired.clear();
+}
+
+void leon3_funclt_trap::BlockCache::unchain() throw(){
+    vmap< unsigned int, BasicBlock * >::iterator it;
+    for(it = this->blocks.begin(); it != this->blocks.end(); ++it){
+        it->second->next[0] = NULL;
+        it->second->next[1] = NULL;
+    }
+}
+
+bool leon3_funclt_trap::BlockCache::hasDelaySlot( int instrId ) throw(){
+    switch(instrId){
+        case 117: // BRANCH
+        case 118: // CALL
+        case 119: // JUMP_imm
+        case 120: // JUMP_reg
+        case 121: // RETT_imm
+        case 122: // RETT_reg
+            return true;
+        default:
+            return false;
+    }
+}
+
+bool leon3_funclt_trap::BlockCache::endsBlock( int instrId ) throw(){
+    switch(instrId){
+        case 123: // TRAP_imm
+        case 124: // TRAP_reg
+        case 132: // WRITEasr_reg
+        case 133: // WRITEasr_imm
+        case 134: // WRITEpsr_reg
+        case 135: // WRITEpsr_imm
+        case 136: // WRITEwim_reg
+        case 137: // WRITEwim_imm
+        case 138: // WRITEtbr_reg
+        case 139: // WRITEtbr_imm
+        case 141: // UNIMP
+        case 142: // FLUSH_reg
+        case 143: // FLUSH_imm
+        case 144: // InvalidInstr
+            return true;
+        default:
+            return hasDelaySlot(instrId);
+    }
+}
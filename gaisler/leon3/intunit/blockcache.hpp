@@ -0,0 +1,148 @@
+/***************************************************************************\
+ *
+ *
+ *         _/        _/_/_/_/    _/_/    _/      _/   _/_/_/
+ *        _/        _/        _/    _/  _/_/    _/         _/
+ *       _/        _/_/_/    _/    _/  _/  _/  _/     _/_/
+ *      _/        _/        _/    _/  _/    _/_/         _/
+ *     _/_/_/_/  _/_/_/_/    _/_/    _/      _/   _/_/_/
+ *
+ *
+ *
+ *
+ *   This file is part of LEON3.
+ *
+ *   LEON3 is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the
+ *   Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *   or see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *
+ *   (c) 2026 agent
+ *
+\***************************************************************************/
+
+
+#ifndef LT_BLOCKCACHE_HPP
+#define LT_BLOCKCACHE_HPP
+
+#include "gaisler/leon3/intunit/instructions.hpp"
+#include "core/common/vmap.h"
+#include <vector>
+
+#define FUNC_MODEL
+#define LT_IF
+namespace leon3_funclt_trap{
+
+    /// Straight-line sequence of pre-decoded instructions starting at
+    /// startPC. A block ends after the delay slot of a control transfer
+    /// instruction, after any instruction which changes the processor state
+    /// relevant for fetching (PSR, WIM, TBR, ASRs, FLUSH), at a 4KB page
+    /// boundary or when the maximum block size is reached. Interrupts are
+    /// only taken between blocks, so an interrupt may wait for up to the
+    /// maximum block size (64 instructions by default) plus a delay slot.
+    /// A block is bound to the fetch ASI it was translated for. Changes of
+    /// the MMU context or of the page tables are covered by the memory,
+    /// which drops all blocks on writes to the MMU registers and on TLB
+    /// flushes.
+    class BasicBlock{
+
+        public:
+        BasicBlock( unsigned int startPC, unsigned int asi );
+        ~BasicBlock();
+        /// Returns the chained successor starting at pc, NULL if not chained
+        inline BasicBlock * successor( unsigned int pc, unsigned int asi ) const throw(){
+            if(this->next[0] != NULL && this->next[0]->startPC == pc && this->next[0]->asi == asi){
+                return this->next[0];
+            }
+            if(this->next[1] != NULL && this->next[1]->startPC == pc && this->next[1]->asi == asi){
+                return this->next[1];
+            }
+            return NULL;
+        }
+        /// Remembers block as direct successor of this block
+        void chain( BasicBlock * block ) throw();
+        /// Address of the first instruction of the block
+        unsigned int startPC;
+        /// Fetch ASI (user or supervisor) the block was translated for
+        unsigned int asi;
+        /// Address following the last instruction of the block
+        unsigned int endPC;
+        /// Number of instructions in the block
+        unsigned int size;
+        /// Pre-bound instruction objects, owned by the block
+        std::vector< Instruction * > instrs;
+        /// Raw instruction words the block was decoded from
+        std::vector< unsigned int > bitStrings;
+        /// Set for the instructions whose fetch was timed while translating
+        /// the block; their first execution is not charged for it again
+        std::vector< bool > fetchTimed;
+        /// Taken and fall-through successors
+        BasicBlock * next[2];
+        /// Round robin pointer for replacing successors
+        unsigned int nextVictim;
+    };
+
+    /// PC indexed store of basic blocks
+    class BlockCache{
+
+        public:
+        BlockCache( unsigned int maxBlockSize = 64 );
+        ~BlockCache();
+        /// Returns the block starting at pc, NULL if not translated yet or
+        /// translated for another ASI
+        inline BasicBlock * find( unsigned int pc, unsigned int asi ) throw(){
+            vmap< unsigned int, BasicBlock * >::iterator it = this->blocks.find(pc);
+            if(it != this->blocks.end() && it->second->asi == asi){
+                return it->second;
+            }
+            return NULL;
+        }
+        /// Adds a freshly translated block to the cache
+        void insert( BasicBlock * block ) throw();
+        /// Drops all blocks overlapping [start, end)
+        void invalidate( unsigned int start, unsigned int end ) throw();
+        /// Drops all blocks
+        void flush() throw();
+        /// Deletes the blocks dropped since the last call; must only be
+        /// called while no block is executing
+        void collect() throw();
+        /// True if instruction instrId has to terminate a block
+        static bool endsBlock( int instrId ) throw();
+        /// True if instruction instrId has a delay slot
+        static bool hasDelaySlot( int instrId ) throw();
+        /// Maximum number of instructions in one block
+        unsigned int maxBlockSize;
+        /// Number of translated blocks
+        unsigned long long translations;
+        /// Number of invalidated blocks
+        unsigned long long invalidations;
+        /// Incremented whenever blocks are dropped; chains into older
+        /// blocks must not be followed once it changed
+        unsigned int epoch;
+
+        private:
+        /// Unchains every block from the ones in retired
+        void unchain() throw();
+        vmap< unsigned int, BasicBlock * > blocks;
+        /// Dropped blocks waiting for deletion
+        std::vector< BasicBlock * > retired;
+    };
+
+};
+
+
+
+#endif
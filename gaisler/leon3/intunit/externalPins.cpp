@@ -44,6 +44,7 @@ using namespace leon3_funclt_trap;
 void leon3_funclt_trap::PinTLM_out_32::on_run(const bool &run, const sc_time &delay) throw() {
   if(!run) {
       stopped = true;
+      powerdown = false;
       status =  false;
   } else {
       stopped = false;
@@ -67,10 +68,10 @@ void leon3_funclt_trap::PinTLM_out_32::send_pin_req(const unsigned int &value) t
 leon3_funclt_trap::PinTLM_out_32::PinTLM_out_32(sc_module_name portName) : sc_module(portName),
   // In stand-alone mode do not wait for run-bit to be set
   #ifdef LEON3_STANDALONE
-    initSignal("ack"), status("status"), run(&leon3_funclt_trap::PinTLM_out_32::on_run, "run"), stopped(false) {
+    initSignal("ack"), status("status"), run(&leon3_funclt_trap::PinTLM_out_32::on_run, "run"), stopped(false), powerdown(false) {
     status.write(true);
   #else
-    initSignal("ack"), status("status"), run(&leon3_funclt_trap::PinTLM_out_32::on_run, "run"), stopped(true) {
+    initSignal("ack"), status("status"), run(&leon3_funclt_trap::PinTLM_out_32::on_run, "run"), stopped(true), powerdown(false) {
     status.write(false);
   #endif
   end_module();
@@ -66,6 +66,12 @@ namespace leon3_funclt_trap{
         /// Needed to halt the main processor loop
         bool stopped;
 
+        /// Set by a write to %asr19; the processor halts until the next
+        /// interrupt or until it is started again. The flag is checked
+        /// after every instruction, also on the worker thread, but only
+        /// at the end of a translated basic block in block cache mode
+        bool powerdown;
+
         /// Needed to start the main processor loop
         sc_event start;
     };
@@ -53,16 +53,14 @@ bool leon3_funclt_trap::Instruction::IncrementRegWindow() throw(){
     {
         unsigned int newCwp;
 
-        newCwp = ((unsigned int)(PSR[key_CWP] + 1)) % NUM_REG_WIN;
+        newCwp = ((unsigned int)(PSR.field<key_CWP>() + 1)) % NUM_REG_WIN;
         if(((0x01 << (newCwp)) & WIM) != 0){
             return false;
         }
         PSR = (PSR & 0xFFFFFFE0) | newCwp;
         #ifndef ACC_MODEL
-        //Functional model: we simply immediately update the alias
-        for(int i = 8; i < 32; i++){
-            REGS[i].updateAlias(WINREGS[(newCwp*16 + i - 8) & 0x7f]);
-        }
+        //Functional model: we simply move the base of the register window
+        REGS[8].getWindow()->setCwp(newCwp);
         #else
         //Cycle accurate model: we have to update the alias using the pipeline register
         //We update the aliases for this stage and for all the preceding ones (we are in the
@@ -80,16 +78,14 @@ bool leon3_funclt_trap::Instruction::DecrementRegWindow() throw(){
     {
         unsigned int newCwp;
 
-        newCwp = ((unsigned int)(PSR[key_CWP] - 1)) % NUM_REG_WIN;
+        newCwp = ((unsigned int)(PSR.field<key_CWP>() - 1)) % NUM_REG_WIN;
         if(((0x01 << (newCwp)) & WIM) != 0){
             return false;
         }
         PSR = (PSR & 0xFFFFFFE0) | newCwp;
         #ifndef ACC_MODEL
-        //Functional model: we simply immediately update the alias
-        for(int i = 8; i < 32; i++){
-            REGS[i].updateAlias(WINREGS[(newCwp*16 + i - 8) & 0x7f]);
-        }
+        //Functional model: we simply move the base of the register window
+        REGS[8].getWindow()->setCwp(newCwp);
         #else
         //Cycle accurate model: we have to update the alias using the pipeline register
         //We update the aliases for this stage and for all the preceding ones (we are in the
@@ -114,7 +110,7 @@ int leon3_funclt_trap::Instruction::SignExtend( unsigned int bitSeq, unsigned in
 void leon3_funclt_trap::Instruction::RaiseException( unsigned int pcounter, unsigned \
     int npcounter, unsigned int exceptionId, unsigned int customTrapOffset ){
 
-    if(PSR[key_ET] == 0){
+    if(PSR.field<key_ET>() == 0){
         /* 7.5 Trap Definition
           If ET=0 and a precise trap occurs, the processor enters the error_mode state and
           halts execution. If ET=0 and an interrupt request or an interrupting or deferred
@@ -132,15 +128,13 @@ void leon3_funclt_trap::Instruction::RaiseException( unsigned int pcounter, unsi
         }
     } else {
         unsigned int curPSR = PSR;
-        curPSR = (curPSR & 0xffffffbf) | (PSR[key_S] << 6);
+        curPSR = (curPSR & 0xffffffbf) | (PSR.field<key_S>() << 6);
         curPSR = (curPSR & 0xffffff7f) | 0x00000080;
         curPSR &= 0xffffffdf;
-        unsigned int newCwp = ((unsigned int)(PSR[key_CWP] - 1)) % NUM_REG_WIN;
+        unsigned int newCwp = ((unsigned int)(PSR.field<key_CWP>() - 1)) % NUM_REG_WIN;
         #ifndef ACC_MODEL
-        //Functional model: we simply immediately update the alias
-        for(int i = 8; i < 32; i++){
-            REGS[i].updateAlias(WINREGS[(newCwp*16 + i - 8) & 0x7f]);
-        }
+        //Functional model: we simply move the base of the register window
+        REGS[8].getWindow()->setCwp(newCwp);
         #else
         //Cycle accurate model: we have to update the alias using the pipeline register
         //We update the aliases for this stage and for all the preceding ones (we are in the
@@ -166,118 +160,118 @@ void leon3_funclt_trap::Instruction::RaiseException( unsigned int pcounter, unsi
             case RESET:{
             }break;
             case DATA_STORE_ERROR:{
-                TBR[key_TT] = 0x2b;
+                TBR.setField<key_TT>(0x2b);
             }break;
             case INSTR_ACCESS_MMU_MISS:{
-                TBR[key_TT] = 0x3c;
+                TBR.setField<key_TT>(0x3c);
             }break;
             case INSTR_ACCESS_ERROR:{
-                TBR[key_TT] = 0x21;
+                TBR.setField<key_TT>(0x21);
             }break;
             case R_REGISTER_ACCESS_ERROR:{
-                TBR[key_TT] = 0x20;
+                TBR.setField<key_TT>(0x20);
             }break;
             case INSTR_ACCESS_EXC:{
-                TBR[key_TT] = 0x01;
+                TBR.setField<key_TT>(0x01);
             }break;
             case PRIVILEDGE_INSTR:{
-                TBR[key_TT] = 0x03;
+                TBR.setField<key_TT>(0x03);
             }break;
             case ILLEGAL_INSTR:{
-                TBR[key_TT] = 0x02;
+                TBR.setField<key_TT>(0x02);
             }break;
             case FP_DISABLED:{
-                TBR[key_TT] = 0x04;
+                TBR.setField<key_TT>(0x04);
             }break;
             case CP_DISABLED:{
-                TBR[key_TT] = 0x24;
+                TBR.setField<key_TT>(0x24);
             }break;
             case UNIMPL_FLUSH:{
-                TBR[key_TT] = 0x25;
+                TBR.setField<key_TT>(0x25);
             }break;
             case WATCHPOINT_DETECTED:{
-                TBR[key_TT] = 0x0b;
+                TBR.setField<key_TT>(0x0b);
             }break;
             case WINDOW_OVERFLOW:{
-                TBR[key_TT] = 0x05;
+                TBR.setField<key_TT>(0x05);
             }break;
             case WINDOW_UNDERFLOW:{
-                TBR[key_TT] = 0x06;
+                TBR.setField<key_TT>(0x06);
             }break;
             case MEM_ADDR_NOT_ALIGNED:{
-                TBR[key_TT] = 0x07;
+                TBR.setField<key_TT>(0x07);
             }break;
             case FP_EXCEPTION:{
-                TBR[key_TT] = 0x08;
+                TBR.setField<key_TT>(0x08);
             }break;
             case CP_EXCEPTION:{
-                TBR[key_TT] = 0x28;
+                TBR.setField<key_TT>(0x28);
             }break;
             case DATA_ACCESS_ERROR:{
-                TBR[key_TT] = 0x29;
+                TBR.setField<key_TT>(0x29);
             }break;
             case DATA_ACCESS_MMU_MISS:{
-                TBR[key_TT] = 0x2c;
+                TBR.setField<key_TT>(0x2c);
             }break;
             case DATA_ACCESS_EXC:{
-                TBR[key_TT] = 0x09;
+                TBR.setField<key_TT>(0x09);
             }break;
             case TAG_OVERFLOW:{
-                TBR[key_TT] = 0x0a;
+                TBR.setField<key_TT>(0x0a);
             }break;
             case DIV_ZERO:{
-                TBR[key_TT] = 0x2a;
+                TBR.setField<key_TT>(0x2a);
             }break;
             case TRAP_INSTRUCTION:{
-                TBR[key_TT] = 0x80 + customTrapOffset;
+                TBR.setField<key_TT>(0x80 + customTrapOffset);
             }break;
             case IRQ_LEV_15:{
-                TBR[key_TT] = 0x1f;
+                TBR.setField<key_TT>(0x1f);
             }break;
             case IRQ_LEV_14:{
-                TBR[key_TT] = 0x1e;
+                TBR.setField<key_TT>(0x1e);
             }break;
             case IRQ_LEV_13:{
-                TBR[key_TT] = 0x1d;
+                TBR.setField<key_TT>(0x1d);
             }break;
             case IRQ_LEV_12:{
-                TBR[key_TT] = 0x1c;
+                TBR.setField<key_TT>(0x1c);
             }break;
             case IRQ_LEV_11:{
-                TBR[key_TT] = 0x1b;
+                TBR.setField<key_TT>(0x1b);
             }break;
             case IRQ_LEV_10:{
-                TBR[key_TT] = 0x1a;
+                TBR.setField<key_TT>(0x1a);
             }break;
             case IRQ_LEV_9:{
-                TBR[key_TT] = 0x19;
+                TBR.setField<key_TT>(0x19);
             }break;
             case IRQ_LEV_8:{
-                TBR[key_TT] = 0x18;
+                TBR.setField<key_TT>(0x18);
             }break;
             case IRQ_LEV_7:{
-                TBR[key_TT] = 0x17;
+                TBR.setField<key_TT>(0x17);
             }break;
             case IRQ_LEV_6:{
-                TBR[key_TT] = 0x16;
+                TBR.setField<key_TT>(0x16);
             }break;
             case IRQ_LEV_5:{
-                TBR[key_TT] = 0x15;
+                TBR.setField<key_TT>(0x15);
             }break;
             case IRQ_LEV_4:{
-                TBR[key_TT] = 0x14;
+                TBR.setField<key_TT>(0x14);
             }break;
             case IRQ_LEV_3:{
-                TBR[key_TT] = 0x13;
+                TBR.setField<key_TT>(0x13);
             }break;
             case IRQ_LEV_2:{
-                TBR[key_TT] = 0x12;
+                TBR.setField<key_TT>(0x12);
             }break;
             case IRQ_LEV_1:{
-                TBR[key_TT] = 0x11;
+                TBR.setField<key_TT>(0x11);
             }break;
             case IMPL_DEP_EXC:{
-                TBR[key_TT] = 0x60 + customTrapOffset;
+                TBR.setField<key_TT>(0x60 + customTrapOffset);
             }break;
             default:{
             }break;
@@ -303,7 +297,7 @@ void leon3_funclt_trap::Instruction::RaiseException( unsigned int pcounter, unsi
 
 bool leon3_funclt_trap::Instruction::checkIncrementWin() const throw(){
 
-    unsigned int newCwp = ((unsigned int)(PSR[key_CWP] + 1)) % NUM_REG_WIN;
+    unsigned int newCwp = ((unsigned int)(PSR.field<key_CWP>() + 1)) % NUM_REG_WIN;
     if(((0x01 << (newCwp)) & WIM) != 0){
         return false;
     }
@@ -314,7 +308,7 @@ bool leon3_funclt_trap::Instruction::checkIncrementWin() const throw(){
 
 bool leon3_funclt_trap::Instruction::checkDecrementWin() const throw(){
 
-    unsigned int newCwp = ((unsigned int)(PSR[key_CWP] - 1)) % NUM_REG_WIN;
+    unsigned int newCwp = ((unsigned int)(PSR.field<key_CWP>() - 1)) % NUM_REG_WIN;
     if(((0x01 << (newCwp)) & WIM) != 0){
         return false;
     }
@@ -331,6 +325,7 @@ leon3_funclt_trap::Instruction::Instruction( Reg32_0 & PSR, Reg32_1 & WIM, Reg32
     FP(FP), LR(LR), SP(SP), PCR(PCR), REGS(REGS), instrMem(instrMem), dataMem(dataMem), \
     irqAck(irqAck), NUM_REG_WIN(8), PIPELINED_MULT(false){
     this->totalInstrCycles = 0;
+    this->annulled = false;
 }
 
 leon3_funclt_trap::Instruction::~Instruction(){
@@ -718,7 +713,7 @@ unsigned int leon3_funclt_trap::LDSB_imm::behavior(){
 
     address = rs1 + SignExtend(simm13, 13);
 
-    readValue = SignExtend(dataMem.read_byte(address, 0xA | (PSR[key_S]? 1 : 0), 0, 0), 8);
+    readValue = SignExtend(dataMem.read_byte(address, 0xA | (PSR.field<key_S>()? 1 : 0), 0, 0), 8);
 
     rd = readValue;
     this->IncrementPC();
@@ -777,17 +772,15 @@ unsigned int leon3_funclt_trap::WRITEpsr_imm::behavior(){
     // Note how we filter writes to EF and EC fields since we do not
     // have neither a co-processor nor the FPU
     result = ((rs1 ^ SignExtend(simm13, 13)) & 0x00FFCFFF) | 0xF3000000;
-    supervisorException = (PSR[key_S] == 0);
+    supervisorException = (PSR.field<key_S>() == 0);
     illegalCWP = (result & 0x0000001f) >= NUM_REG_WIN;
 
     if(!(supervisorException || illegalCWP)){
         PSR = result;
         int newCwp = result & 0x0000001f;
         #ifndef ACC_MODEL
-        //Functional model: we simply immediately update the alias
-        for(int i = 8; i < 32; i++){
-            REGS[i].updateAlias(WINREGS[(newCwp*16 + i - 8) & 0x7f]);
-        }
+        //Functional model: we simply move the base of the register window
+        REGS[8].getWindow()->setCwp(newCwp);
         #else
         //Cycle accurate model: we have to update the alias using the pipeline register
         //We update the aliases for this stage and for all the preceding ones (we are in the
@@ -802,9 +795,11 @@ unsigned int leon3_funclt_trap::WRITEpsr_imm::behavior(){
 
     if(supervisorException){
         RaiseException(pcounter, npcounter, PRIVILEDGE_INSTR);
+        return this->totalInstrCycles;
     }
     if(illegalCWP){
         RaiseException(pcounter, npcounter, ILLEGAL_INSTR);
+        return this->totalInstrCycles;
     }
     return this->totalInstrCycles;
 }
@@ -975,6 +970,7 @@ unsigned int leon3_funclt_trap::READpsr::behavior(){
 
     if(!supervisor){
         RaiseException(pcounter, npcounter, PRIVILEDGE_INSTR);
+        return this->totalInstrCycles;
     }
 
     rd = psr_temp;
@@ -1205,7 +1201,7 @@ unsigned int leon3_funclt_trap::LDSBA_reg::behavior(){
     npcounter = NPC;
 
     address = rs1 + rs2;
-    supervisor = PSR[key_S];
+    supervisor = PSR.field<key_S>();
 
     #ifdef ACC_MODEL
     if(!supervisor){
@@ -1226,6 +1222,7 @@ unsigned int leon3_funclt_trap::LDSBA_reg::behavior(){
 
     if(!supervisor){
         RaiseException(pcounter, npcounter, PRIVILEDGE_INSTR);
+        return this->totalInstrCycles;
     }
 
     rd = readValue;
@@ -1295,10 +1292,11 @@ unsigned int leon3_funclt_trap::LDUH_imm::behavior(){
     }
     #endif
 
-    readValue = dataMem.read_half(address, 0xA | (PSR[key_S]? 1 : 0), 0, 0);
+    readValue = dataMem.read_half(address, 0xA | (PSR.field<key_S>()? 1 : 0), 0, 0);
 
     if(notAligned){
         RaiseException(pcounter, npcounter, MEM_ADDR_NOT_ALIGNED);
+        return this->totalInstrCycles;
     }
 
     rd = readValue;
@@ -1356,7 +1354,7 @@ unsigned int leon3_funclt_trap::STA_reg::behavior(){
 
     address = rs1 + rs2;
     toWrite = rd;
-    supervisor = PSR[key_S];
+    supervisor = PSR.field<key_S>();
 
     notAligned = (address & 0x00000003) != 0;
     #ifdef ACC_MODEL
@@ -1375,9 +1373,11 @@ unsigned int leon3_funclt_trap::STA_reg::behavior(){
 
     if(!supervisor){
         RaiseException(pcounter, npcounter, PRIVILEDGE_INSTR);
+        return this->totalInstrCycles;
     }
     if(notAligned){
         RaiseException(pcounter, npcounter, MEM_ADDR_NOT_ALIGNED);
+        return this->totalInstrCycles;
     }
     this->IncrementPC();
     return this->totalInstrCycles;
@@ -1494,7 +1494,7 @@ unsigned int leon3_funclt_trap::LDSHA_reg::behavior(){
     npcounter = NPC;
 
     address = rs1 + rs2;
-    supervisor = PSR[key_S];
+    supervisor = PSR.field<key_S>();
 
     notAligned = (address & 0x00000001) != 0;
     #ifdef ACC_MODEL
@@ -1516,9 +1516,11 @@ unsigned int leon3_funclt_trap::LDSHA_reg::behavior(){
 
     if(!supervisor){
         RaiseException(pcounter, npcounter, PRIVILEDGE_INSTR);
+        return this->totalInstrCycles;
     }
     if(notAligned){
         RaiseException(pcounter, npcounter, MEM_ADDR_NOT_ALIGNED);
+        return this->totalInstrCycles;
     }
 
     rd = readValue;
@@ -1581,7 +1583,7 @@ unsigned int leon3_funclt_trap::STBA_reg::behavior(){
 
     address = rs1 + rs2;
     toWrite = (unsigned char)(rd & 0x000000FF);
-    supervisor = PSR[key_S];
+    supervisor = PSR.field<key_S>();
 
     #ifdef ACC_MODEL
     if(!supervisor){
@@ -1599,6 +1601,7 @@ unsigned int leon3_funclt_trap::STBA_reg::behavior(){
 
     if(!supervisor){
         RaiseException(pcounter, npcounter, PRIVILEDGE_INSTR);
+        return this->totalInstrCycles;
     }
     this->IncrementPC();
     return this->totalInstrCycles;
@@ -1667,7 +1670,7 @@ unsigned int leon3_funclt_trap::ST_imm::behavior(){
     #endif
 
     if(!notAligned){
-        dataMem.write_word(address, toWrite, 0xA | (PSR[key_S]? 1 : 0), 0, 0);
+        dataMem.write_word(address, toWrite, 0xA | (PSR.field<key_S>()? 1 : 0), 0, 0);
     }
     else{
         flush();
@@ -1676,6 +1679,7 @@ unsigned int leon3_funclt_trap::ST_imm::behavior(){
 
     if(notAligned){
         RaiseException(pcounter, npcounter, MEM_ADDR_NOT_ALIGNED);
+        return this->totalInstrCycles;
     }
     this->IncrementPC();
     return this->totalInstrCycles;
@@ -1731,10 +1735,11 @@ unsigned int leon3_funclt_trap::READtbr::behavior(){
     this->IncrementPC();
 
     tbr_temp = TBR;
-    supervisor = PSR[key_S];
+    supervisor = PSR.field<key_S>();
 
     if(!supervisor){
         RaiseException(pcounter, npcounter, PRIVILEDGE_INSTR);
+        return this->totalInstrCycles;
     }
 
     rd = tbr_temp;
@@ -1810,6 +1815,7 @@ unsigned int leon3_funclt_trap::UDIVcc_imm::behavior(){
 
     if(exception){
         RaiseException(pcounter, npcounter, DIV_ZERO);
+        return this->totalInstrCycles;
     }
     this->WB_plain(this->rd, this->rd_bit, this->result);
     return this->totalInstrCycles;
@@ -1868,7 +1874,7 @@ unsigned int leon3_funclt_trap::SWAPA_reg::behavior(){
 
     address = rs1 + rs2;
     toWrite = rd;
-    supervisor = PSR[key_S];
+    supervisor = PSR.field<key_S>();
 
     notAligned = (address & 0x00000003) != 0;
     #ifdef ACC_MODEL
@@ -1888,9 +1894,11 @@ unsigned int leon3_funclt_trap::SWAPA_reg::behavior(){
 
     if(!supervisor){
         RaiseException(pcounter, npcounter, PRIVILEDGE_INSTR);
+        return this->totalInstrCycles;
     }
     if(notAligned){
         RaiseException(pcounter, npcounter, MEM_ADDR_NOT_ALIGNED);
+        return this->totalInstrCycles;
     }
 
     rd = readValue;
@@ -1954,7 +1962,7 @@ unsigned int leon3_funclt_trap::ADDXcc_imm::behavior(){
     rs2_op = SignExtend(simm13, 13);
 
     #ifndef ACC_MODEL
-    result = rs1_op + rs2_op + PSR[key_ICC_c];
+    result = rs1_op + rs2_op + PSR.field<key_ICC_c>();
     #else
     //I read the register of the execute stage since this
     //is the one containing the bypass value
@@ -2017,7 +2025,7 @@ unsigned int leon3_funclt_trap::STB_imm::behavior(){
     address = rs1 + SignExtend(simm13, 13);
     toWrite = (unsigned char)(rd & 0x000000FF);
 
-    dataMem.write_byte(address, toWrite, 0xA | (PSR[key_S]? 1 : 0), 0, 0);
+    dataMem.write_byte(address, toWrite, 0xA | (PSR.field<key_S>()? 1 : 0), 0, 0);
     stall(1);
     this->IncrementPC();
     return this->totalInstrCycles;
@@ -2074,7 +2082,7 @@ unsigned int leon3_funclt_trap::SUBXcc_imm::behavior(){
     rs2_op = SignExtend(simm13, 13);
 
     #ifndef ACC_MODEL
-    result = rs1_op - rs2_op - PSR[key_ICC_c];
+    result = rs1_op - rs2_op - PSR.field<key_ICC_c>();
     #else
     result = rs1_op - rs2_op - PSR_execute[key_ICC_c];
     #endif
@@ -2145,7 +2153,7 @@ unsigned int leon3_funclt_trap::STH_reg::behavior(){
     #endif
 
     if(!notAligned){
-        dataMem.write_half(address, toWrite, 0xA | (PSR[key_S]? 1 : 0), 0, 0);
+        dataMem.write_half(address, toWrite, 0xA | (PSR.field<key_S>()? 1 : 0), 0, 0);
     }
     else{
         flush();
@@ -2154,6 +2162,7 @@ unsigned int leon3_funclt_trap::STH_reg::behavior(){
 
     if(notAligned){
         RaiseException(pcounter, npcounter, MEM_ADDR_NOT_ALIGNED);
+        return this->totalInstrCycles;
     }
     this->IncrementPC();
     return this->totalInstrCycles;
@@ -2269,6 +2278,10 @@ unsigned int leon3_funclt_trap::WRITEasr_imm::behavior(){
     Y = result;
 
     ASR[rd] = result;
+    if(rd == 19){
+        // Power-down
+        irqAck.powerdown = true;
+    }
     return this->totalInstrCycles;
 }
 
@@ -2387,8 +2400,8 @@ unsigned int leon3_funclt_trap::LDSTUB_reg::behavior(){
 
     address = rs1 + rs2;
 
-    readValue = dataMem.read_byte(address, 0xA | (PSR[key_S]? 1 : 0), 0, 0);
-    dataMem.write_byte(address, 0xff, 0xA | (PSR[key_S]? 1 : 0), 0, 0);
+    readValue = dataMem.read_byte(address, 0xA | (PSR.field<key_S>()? 1 : 0), 0, 0);
+    dataMem.write_byte(address, 0xff, 0xA | (PSR.field<key_S>()? 1 : 0), 0, 0);
     stall(2);
 
     rd = readValue;
@@ -2571,6 +2584,10 @@ unsigned int leon3_funclt_trap::WRITEasr_reg::behavior(){
     Y = result;
 
     ASR[rd] = result;
+    if(rd == 19){
+        // Power-down
+        irqAck.powerdown = true;
+    }
     return this->totalInstrCycles;
 }
 
@@ -2633,10 +2650,11 @@ unsigned int leon3_funclt_trap::LD_reg::behavior(){
     }
     #endif
 
-    readValue = dataMem.read_word(address, 0xA | (PSR[key_S]? 1 : 0), 0, 0);
+    readValue = dataMem.read_word(address, 0xA | (PSR.field<key_S>()? 1 : 0), 0, 0);
 
     if(notAligned){
         RaiseException(pcounter, npcounter, MEM_ADDR_NOT_ALIGNED);
+        return this->totalInstrCycles;
     }
 
     rd = readValue;
@@ -2705,7 +2723,7 @@ unsigned int leon3_funclt_trap::ST_reg::behavior(){
     #endif
 
     if(!notAligned){
-        dataMem.write_word(address, toWrite, 0xA | (PSR[key_S]? 1 : 0), 0, 0);
+        dataMem.write_word(address, toWrite, 0xA | (PSR.field<key_S>()? 1 : 0), 0, 0);
     }
     else{
         flush();
@@ -2714,6 +2732,7 @@ unsigned int leon3_funclt_trap::ST_reg::behavior(){
 
     if(notAligned){
         RaiseException(pcounter, npcounter, MEM_ADDR_NOT_ALIGNED);
+        return this->totalInstrCycles;
     }
     this->IncrementPC();
     return this->totalInstrCycles;
@@ -2846,7 +2865,7 @@ unsigned int leon3_funclt_trap::LDD_reg::behavior(){
     #endif
 
     if(!notAligned){
-        readValue = dataMem.read_dword(address, 0xA | (PSR[key_S]? 1 : 0), 0, 0);
+        readValue = dataMem.read_dword(address, 0xA | (PSR.field<key_S>()? 1 : 0), 0, 0);
         stall(1);
     }
     #ifdef ACC_MODEL
@@ -2857,6 +2876,7 @@ unsigned int leon3_funclt_trap::LDD_reg::behavior(){
 
     if(notAligned){
         RaiseException(pcounter, npcounter, MEM_ADDR_NOT_ALIGNED);
+        return this->totalInstrCycles;
     }
 
     if(rd_bit % 2 == 0){
@@ -2992,10 +3012,11 @@ unsigned int leon3_funclt_trap::LDUH_reg::behavior(){
     }
     #endif
 
-    readValue = dataMem.read_half(address, 0xA | (PSR[key_S]? 1 : 0), 0, 0);
+    readValue = dataMem.read_half(address, 0xA | (PSR.field<key_S>()? 1 : 0), 0, 0);
 
     if(notAligned){
         RaiseException(pcounter, npcounter, MEM_ADDR_NOT_ALIGNED);
+        return this->totalInstrCycles;
     }
 
     rd = readValue;
@@ -3144,6 +3165,7 @@ unsigned int leon3_funclt_trap::SAVE_imm::behavior(){
 
     if(!okNewWin){
         RaiseException(pcounter, npcounter, WINDOW_OVERFLOW);
+        return this->totalInstrCycles;
     }
 
     if(okNewWin){
@@ -3211,7 +3233,7 @@ unsigned int leon3_funclt_trap::MULScc_reg::behavior(){
     #else
     unsigned int yNew = (((unsigned int)Y_execute) >> 1) | (rs1_op << 31);
     #endif
-    rs1_op = ((PSR[key_ICC_n] ^ PSR[key_ICC_v]) << 31) | (((unsigned int)rs1_op) >> 1);
+    rs1_op = ((PSR.field<key_ICC_n>() ^ PSR.field<key_ICC_v>()) << 31) | (((unsigned int)rs1_op) >> 1);
     result = rs1_op;
     #ifndef ACC_MODEL
     unsigned int yOld = Y;
@@ -3354,7 +3376,7 @@ unsigned int leon3_funclt_trap::STD_imm::behavior(){
     #endif
 
     if(!notAligned){
-        dataMem.write_dword(address, toWrite, 0xA | (PSR[key_S]? 1 : 0), 0, 0);
+        dataMem.write_dword(address, toWrite, 0xA | (PSR.field<key_S>()? 1 : 0), 0, 0);
     }
     else{
         flush();
@@ -3363,6 +3385,7 @@ unsigned int leon3_funclt_trap::STD_imm::behavior(){
 
     if(notAligned){
         RaiseException(pcounter, npcounter, MEM_ADDR_NOT_ALIGNED);
+        return this->totalInstrCycles;
     }
     this->IncrementPC();
     return this->totalInstrCycles;
@@ -3419,7 +3442,7 @@ unsigned int leon3_funclt_trap::SUBXcc_reg::behavior(){
     rs2_op = rs2;
 
     #ifndef ACC_MODEL
-    result = rs1_op - rs2_op - PSR[key_ICC_c];
+    result = rs1_op - rs2_op - PSR.field<key_ICC_c>();
     #else
     result = rs1_op - rs2_op - PSR_execute[key_ICC_c];
     #endif
@@ -3483,7 +3506,7 @@ unsigned int leon3_funclt_trap::ADDX_imm::behavior(){
     rs2_op = SignExtend(simm13, 13);
 
     #ifndef ACC_MODEL
-    result = rs1_op + rs2_op + PSR[key_ICC_c];
+    result = rs1_op + rs2_op + PSR.field<key_ICC_c>();
     #else
     //I read the register of the execute stage since this
     //is the one containing the bypass value
@@ -3557,13 +3580,14 @@ unsigned int leon3_funclt_trap::SWAP_imm::behavior(){
         flush();
     }
     else{
-        readValue = dataMem.read_word(address, 0xA | (PSR[key_S]? 1 : 0), 0, 1);
-        dataMem.write_word(address, toWrite, 0xA | (PSR[key_S]? 1 : 0), 0, 0);
+        readValue = dataMem.read_word(address, 0xA | (PSR.field<key_S>()? 1 : 0), 0, 1);
+        dataMem.write_word(address, toWrite, 0xA | (PSR.field<key_S>()? 1 : 0), 0, 0);
     }
     stall(2);
 
     if(notAligned){
         RaiseException(pcounter, npcounter, MEM_ADDR_NOT_ALIGNED);
+        return this->totalInstrCycles;
     }
 
     rd = readValue;
@@ -3791,6 +3815,7 @@ unsigned int leon3_funclt_trap::FLUSH_imm::behavior(){
     this->totalInstrCycles = 0;
     this->IncrementPC();
 
+    this->instrMem.flush_instr(rs1 + SignExtend(simm13, 13));
     return this->totalInstrCycles;
 }
 
@@ -3910,7 +3935,7 @@ unsigned int leon3_funclt_trap::STH_imm::behavior(){
     #endif
 
     if(!notAligned){
-        dataMem.write_half(address, toWrite, 0xA | (PSR[key_S]? 1 : 0), 0, 0);
+        dataMem.write_half(address, toWrite, 0xA | (PSR.field<key_S>()? 1 : 0), 0, 0);
     }
     else{
         flush();
@@ -3919,6 +3944,7 @@ unsigned int leon3_funclt_trap::STH_imm::behavior(){
 
     if(notAligned){
         RaiseException(pcounter, npcounter, MEM_ADDR_NOT_ALIGNED);
+        return this->totalInstrCycles;
     }
     this->IncrementPC();
     return this->totalInstrCycles;
@@ -3974,10 +4000,11 @@ unsigned int leon3_funclt_trap::WRITEwim_imm::behavior(){
     this->IncrementPC();
 
     result = rs1 ^ SignExtend(simm13, 13);
-    raiseException = (PSR[key_S] == 0);
+    raiseException = (PSR.field<key_S>() == 0);
 
     if(raiseException){
         RaiseException(pcounter, npcounter, PRIVILEDGE_INSTR);
+        return this->totalInstrCycles;
     }
 
     if(!raiseException){
@@ -4051,7 +4078,7 @@ unsigned int leon3_funclt_trap::LDD_imm::behavior(){
     #endif
 
     if(!notAligned){
-        readValue = dataMem.read_dword(address, 0xA | (PSR[key_S]? 1 : 0), 0, 0);
+        readValue = dataMem.read_dword(address, 0xA | (PSR.field<key_S>()? 1 : 0), 0, 0);
         stall(1);
     }
     #ifdef ACC_MODEL
@@ -4062,6 +4089,7 @@ unsigned int leon3_funclt_trap::LDD_imm::behavior(){
 
     if(notAligned){
         RaiseException(pcounter, npcounter, MEM_ADDR_NOT_ALIGNED);
+        return this->totalInstrCycles;
     }
 
     if(rd_bit % 2 == 0){
@@ -4184,7 +4212,7 @@ unsigned int leon3_funclt_trap::LDUHA_reg::behavior(){
     npcounter = NPC;
 
     address = rs1 + rs2;
-    supervisor = PSR[key_S];
+    supervisor = PSR.field<key_S>();
 
     notAligned = (address & 0x00000001) != 0;
     #ifdef ACC_MODEL
@@ -4206,9 +4234,11 @@ unsigned int leon3_funclt_trap::LDUHA_reg::behavior(){
 
     if(!supervisor){
         RaiseException(pcounter, npcounter, PRIVILEDGE_INSTR);
+        return this->totalInstrCycles;
     }
     if(notAligned){
         RaiseException(pcounter, npcounter, MEM_ADDR_NOT_ALIGNED);
+        return this->totalInstrCycles;
     }
 
     rd = readValue;
@@ -4429,6 +4459,7 @@ unsigned int leon3_funclt_trap::SDIV_imm::behavior(){
 
     if(exception){
         RaiseException(pcounter, npcounter, DIV_ZERO);
+        return this->totalInstrCycles;
     }
     this->WB_plain(this->rd, this->rd_bit, this->result);
     return this->totalInstrCycles;
@@ -4498,6 +4529,7 @@ unsigned int leon3_funclt_trap::TSUBccTV_imm::behavior(){
 
     if(temp_V){
         RaiseException(pcounter, npcounter, TAG_OVERFLOW);
+        return this->totalInstrCycles;
     }
     this->WB_tv(this->rd, this->rd_bit, this->result, this->temp_V);
     return this->totalInstrCycles;
@@ -4554,6 +4586,7 @@ unsigned int leon3_funclt_trap::FLUSH_reg::behavior(){
     this->totalInstrCycles = 0;
     this->IncrementPC();
 
+    this->instrMem.flush_instr(rs1 + rs2);
     return this->totalInstrCycles;
 }
 
@@ -4666,9 +4699,9 @@ unsigned int leon3_funclt_trap::RETT_imm::behavior(){
     npcounter = NPC;
 
     targetAddr = rs1 + SignExtend(simm13, 13);
-    newCwp = ((unsigned int)(PSR[key_CWP] + 1)) % NUM_REG_WIN;
-    exceptionEnabled = PSR[key_ET];
-    supervisor = PSR[key_S];
+    newCwp = ((unsigned int)(PSR.field<key_CWP>() + 1)) % NUM_REG_WIN;
+    exceptionEnabled = PSR.field<key_ET>();
+    supervisor = PSR.field<key_S>();
     invalidWin = ((0x01 << (newCwp)) & WIM) != 0;
     notAligned = (targetAddr & 0x00000003) != 0;
     if(!exceptionEnabled && supervisor && !invalidWin && !notAligned){
@@ -4693,7 +4726,7 @@ unsigned int leon3_funclt_trap::RETT_imm::behavior(){
         flush();
     }
     else{
-        PSR.immediateWrite((PSR & 0xFFFFFF40) | (newCwp | 0x20 | (PSR[key_PS] << 7)));
+        PSR.immediateWrite((PSR & 0xFFFFFF40) | (newCwp | 0x20 | (PSR.field<key_PS>() << 7)));
         stall(2);
     }
 
@@ -4706,9 +4739,11 @@ unsigned int leon3_funclt_trap::RETT_imm::behavior(){
     if(exceptionEnabled){
         if(supervisor){
             RaiseException(pcounter, npcounter, ILLEGAL_INSTR);
+            return this->totalInstrCycles;
         }
         else{
             RaiseException(pcounter, npcounter, PRIVILEDGE_INSTR);
+            return this->totalInstrCycles;
         }
     }
     else if(!supervisor || invalidWin || notAligned){
@@ -4718,10 +4753,8 @@ unsigned int leon3_funclt_trap::RETT_imm::behavior(){
     }
     else{
         #ifndef ACC_MODEL
-        //Functional model: we simply immediately update the alias
-        for(int i = 8; i < 32; i++){
-            REGS[i].updateAlias(WINREGS[(newCwp*16 + i - 8) & 0x7f]);
-        }
+        //Functional model: we simply move the base of the register window
+        REGS[8].getWindow()->setCwp(newCwp);
         #else
         //Cycle accurate model: we have to update the alias using the pipeline register
         //We update the aliases for this stage and for all the preceding ones (we are in the
@@ -4823,6 +4856,7 @@ unsigned int leon3_funclt_trap::SDIVcc_reg::behavior(){
 
     if(exception){
         RaiseException(pcounter, npcounter, DIV_ZERO);
+        return this->totalInstrCycles;
     }
     this->WB_plain(this->rd, this->rd_bit, this->result);
     return this->totalInstrCycles;
@@ -4939,10 +4973,10 @@ unsigned int leon3_funclt_trap::TRAP_imm::behavior(){
     npcounter = NPC;
 
     #ifndef ACC_MODEL
-    bool icc_z = PSR[key_ICC_z];
-    bool icc_n = PSR[key_ICC_n];
-    bool icc_v = PSR[key_ICC_v];
-    bool icc_c = PSR[key_ICC_c];
+    bool icc_z = PSR.field<key_ICC_z>();
+    bool icc_n = PSR.field<key_ICC_n>();
+    bool icc_v = PSR.field<key_ICC_v>();
+    bool icc_c = PSR.field<key_ICC_c>();
     #else
     bool icc_z = PSR_execute[key_ICC_z];
     bool icc_n = PSR_execute[key_ICC_n];
@@ -5091,10 +5125,11 @@ unsigned int leon3_funclt_trap::WRITEtbr_imm::behavior(){
     this->IncrementPC();
 
     result = rs1 ^ SignExtend(simm13, 13);
-    raiseException = (PSR[key_S] == 0);
+    raiseException = (PSR.field<key_S>() == 0);
 
     if(raiseException){
         RaiseException(pcounter, npcounter, PRIVILEDGE_INSTR);
+        return this->totalInstrCycles;
     }
 
     if(!raiseException){
@@ -5151,7 +5186,7 @@ unsigned int leon3_funclt_trap::LDUB_reg::behavior(){
 
     address = rs1 + rs2;
 
-    readValue = dataMem.read_byte(address, 0xA | (PSR[key_S]? 1 : 0), 0, 0);
+    readValue = dataMem.read_byte(address, 0xA | (PSR.field<key_S>()? 1 : 0), 0, 0);
 
     rd = readValue;
     this->IncrementPC();
@@ -5241,6 +5276,7 @@ unsigned int leon3_funclt_trap::RESTORE_reg::behavior(){
 
     if(!okNewWin){
         RaiseException(pcounter, npcounter, WINDOW_UNDERFLOW);
+        return this->totalInstrCycles;
     }
 
     if(okNewWin){
@@ -5306,7 +5342,7 @@ unsigned int leon3_funclt_trap::ADDXcc_reg::behavior(){
     rs2_op = rs2;
 
     #ifndef ACC_MODEL
-    result = rs1_op + rs2_op + PSR[key_ICC_c];
+    result = rs1_op + rs2_op + PSR.field<key_ICC_c>();
     #else
     //I read the register of the execute stage since this
     //is the one containing the bypass value
@@ -5370,7 +5406,7 @@ unsigned int leon3_funclt_trap::STB_reg::behavior(){
     address = rs1 + rs2;
     toWrite = (unsigned char)(rd & 0x000000FF);
 
-    dataMem.write_byte(address, toWrite, 0xA | (PSR[key_S]? 1 : 0), 0, 0);
+    dataMem.write_byte(address, toWrite, 0xA | (PSR.field<key_S>()? 1 : 0), 0, 0);
     stall(1);
     this->IncrementPC();
     return this->totalInstrCycles;
@@ -5666,10 +5702,11 @@ unsigned int leon3_funclt_trap::READwim::behavior(){
     this->IncrementPC();
 
     wim_temp = WIM;
-    supervisor = PSR[key_S];
+    supervisor = PSR.field<key_S>();
 
     if(!supervisor){
         RaiseException(pcounter, npcounter, PRIVILEDGE_INSTR);
+        return this->totalInstrCycles;
     }
 
     rd = wim_temp;
@@ -5719,8 +5756,8 @@ unsigned int leon3_funclt_trap::LDSTUB_imm::behavior(){
 
     address = rs1 + SignExtend(simm13, 13);
 
-    readValue = dataMem.read_byte(address, 0xA | (PSR[key_S]? 1 : 0), 0, 0);
-    dataMem.write_byte(address, 0xff, 0xA | (PSR[key_S]? 1 : 0), 0, 0);
+    readValue = dataMem.read_byte(address, 0xA | (PSR.field<key_S>()? 1 : 0), 0, 0);
+    dataMem.write_byte(address, 0xff, 0xA | (PSR.field<key_S>()? 1 : 0), 0, 0);
     stall(2);
 
     rd = readValue;
@@ -5840,7 +5877,7 @@ unsigned int leon3_funclt_trap::LDSB_reg::behavior(){
 
     address = rs1 + rs2;
 
-    readValue = SignExtend(dataMem.read_byte(address, 0xA | (PSR[key_S]? 1 : 0), 0, 0), 8);
+    readValue = SignExtend(dataMem.read_byte(address, 0xA | (PSR.field<key_S>()? 1 : 0), 0, 0), 8);
 
     rd = readValue;
     this->IncrementPC();
@@ -5969,6 +6006,7 @@ unsigned int leon3_funclt_trap::TSUBccTV_reg::behavior(){
 
     if(temp_V){
         RaiseException(pcounter, npcounter, TAG_OVERFLOW);
+        return this->totalInstrCycles;
     }
     this->WB_tv(this->rd, this->rd_bit, this->result, this->temp_V);
     return this->totalInstrCycles;
@@ -6143,7 +6181,7 @@ unsigned int leon3_funclt_trap::LDSH_reg::behavior(){
     #endif
 
     if(!notAligned){
-        readValue = SignExtend(dataMem.read_half(address, 0xA | (PSR[key_S]? 1 : 0), 0, 0), 16);
+        readValue = SignExtend(dataMem.read_half(address, 0xA | (PSR.field<key_S>()? 1 : 0), 0, 0), 16);
     }
     #ifdef ACC_MODEL
     else{
@@ -6153,6 +6191,7 @@ unsigned int leon3_funclt_trap::LDSH_reg::behavior(){
 
     if(notAligned){
         RaiseException(pcounter, npcounter, MEM_ADDR_NOT_ALIGNED);
+        return this->totalInstrCycles;
     }
 
     rd = readValue;
@@ -6236,6 +6275,7 @@ unsigned int leon3_funclt_trap::UDIVcc_reg::behavior(){
 
     if(exception){
         RaiseException(pcounter, npcounter, DIV_ZERO);
+        return this->totalInstrCycles;
     }
     this->WB_plain(this->rd, this->rd_bit, this->result);
     return this->totalInstrCycles;
@@ -6365,7 +6405,7 @@ unsigned int leon3_funclt_trap::STD_reg::behavior(){
     #endif
 
     if(!notAligned){
-        dataMem.write_dword(address, toWrite, 0xA | (PSR[key_S]? 1 : 0), 0, 0);
+        dataMem.write_dword(address, toWrite, 0xA | (PSR.field<key_S>()? 1 : 0), 0, 0);
     }
     else{
         flush();
@@ -6374,6 +6414,7 @@ unsigned int leon3_funclt_trap::STD_reg::behavior(){
 
     if(notAligned){
         RaiseException(pcounter, npcounter, MEM_ADDR_NOT_ALIGNED);
+        return this->totalInstrCycles;
     }
     this->IncrementPC();
     return this->totalInstrCycles;
@@ -6501,6 +6542,7 @@ unsigned int leon3_funclt_trap::TADDccTV_imm::behavior(){
 
     if(temp_V){
         RaiseException(pcounter, npcounter, TAG_OVERFLOW);
+        return this->totalInstrCycles;
     }
     this->WB_tv(this->rd, this->rd_bit, this->result, this->temp_V);
     return this->totalInstrCycles;
@@ -6560,10 +6602,11 @@ unsigned int leon3_funclt_trap::WRITEtbr_reg::behavior(){
     this->IncrementPC();
 
     result = rs1 ^ rs2;
-    raiseException = (PSR[key_S] == 0);
+    raiseException = (PSR.field<key_S>() == 0);
 
     if(raiseException){
         RaiseException(pcounter, npcounter, PRIVILEDGE_INSTR);
+        return this->totalInstrCycles;
     }
 
     if(!raiseException){
@@ -6624,7 +6667,7 @@ unsigned int leon3_funclt_trap::SUBX_reg::behavior(){
     rs2_op = rs2;
 
     #ifndef ACC_MODEL
-    result = rs1_op - rs2_op - PSR[key_ICC_c];
+    result = rs1_op - rs2_op - PSR.field<key_ICC_c>();
     #else
     result = rs1_op - rs2_op - PSR_execute[key_ICC_c];
     #endif
@@ -6764,6 +6807,7 @@ unsigned int leon3_funclt_trap::UDIV_imm::behavior(){
 
     if(exception){
         RaiseException(pcounter, npcounter, DIV_ZERO);
+        return this->totalInstrCycles;
     }
     this->WB_plain(this->rd, this->rd_bit, this->result);
     return this->totalInstrCycles;
@@ -6830,7 +6874,7 @@ unsigned int leon3_funclt_trap::LDSH_imm::behavior(){
     #endif
 
     if(!notAligned){
-        readValue = SignExtend(dataMem.read_half(address, 0xA | (PSR[key_S]? 1 : 0), 0, 0), 16);
+        readValue = SignExtend(dataMem.read_half(address, 0xA | (PSR.field<key_S>()? 1 : 0), 0, 0), 16);
     }
     #ifdef ACC_MODEL
     else{
@@ -6840,6 +6884,7 @@ unsigned int leon3_funclt_trap::LDSH_imm::behavior(){
 
     if(notAligned){
         RaiseException(pcounter, npcounter, MEM_ADDR_NOT_ALIGNED);
+        return this->totalInstrCycles;
     }
 
     rd = readValue;
@@ -6943,7 +6988,7 @@ unsigned int leon3_funclt_trap::LDSTUBA_reg::behavior(){
     npcounter = NPC;
 
     address = rs1 + rs2;
-    supervisor = PSR[key_S];
+    supervisor = PSR.field<key_S>();
 
     #ifdef ACC_MODEL
     if(!supervisor){
@@ -6962,6 +7007,7 @@ unsigned int leon3_funclt_trap::LDSTUBA_reg::behavior(){
 
     if(!supervisor){
         RaiseException(pcounter, npcounter, PRIVILEDGE_INSTR);
+        return this->totalInstrCycles;
     }
 
     rd = readValue;
@@ -7154,7 +7200,7 @@ unsigned int leon3_funclt_trap::MULScc_imm::behavior(){
     #else
     unsigned int yNew = (((unsigned int)Y_execute) >> 1) | (rs1_op << 31);
     #endif
-    rs1_op = ((PSR[key_ICC_n] ^ PSR[key_ICC_v]) << 31) | (((unsigned int)rs1_op) >> 1);
+    rs1_op = ((PSR.field<key_ICC_n>() ^ PSR.field<key_ICC_v>()) << 31) | (((unsigned int)rs1_op) >> 1);
     result = rs1_op;
     #ifndef ACC_MODEL
     unsigned int yOld = Y;
@@ -7344,10 +7390,11 @@ unsigned int leon3_funclt_trap::WRITEwim_reg::behavior(){
     this->IncrementPC();
 
     result = rs1 ^ rs2;
-    raiseException = (PSR[key_S] == 0);
+    raiseException = (PSR.field<key_S>() == 0);
 
     if(raiseException){
         RaiseException(pcounter, npcounter, PRIVILEDGE_INSTR);
+        return this->totalInstrCycles;
     }
 
     if(!raiseException){
@@ -7574,10 +7621,10 @@ unsigned int leon3_funclt_trap::BRANCH::behavior(){
         break;}
         default:{
             #ifndef ACC_MODEL
-            bool icc_z = PSR[key_ICC_z];
-            bool icc_n = PSR[key_ICC_n];
-            bool icc_v = PSR[key_ICC_v];
-            bool icc_c = PSR[key_ICC_c];
+            bool icc_z = PSR.field<key_ICC_z>();
+            bool icc_n = PSR.field<key_ICC_n>();
+            bool icc_v = PSR.field<key_ICC_v>();
+            bool icc_c = PSR.field<key_ICC_c>();
             #else
             bool icc_z = PSR_execute[key_ICC_z];
             bool icc_n = PSR_execute[key_ICC_n];
@@ -8042,6 +8089,7 @@ unsigned int leon3_funclt_trap::TADDccTV_reg::behavior(){
 
     if(temp_V){
         RaiseException(pcounter, npcounter, TAG_OVERFLOW);
+        return this->totalInstrCycles;
     }
     this->WB_tv(this->rd, this->rd_bit, this->result, this->temp_V);
     return this->totalInstrCycles;
@@ -8131,6 +8179,7 @@ unsigned int leon3_funclt_trap::SDIV_reg::behavior(){
 
     if(exception){
         RaiseException(pcounter, npcounter, DIV_ZERO);
+        return this->totalInstrCycles;
     }
     this->WB_plain(this->rd, this->rd_bit, this->result);
     return this->totalInstrCycles;
@@ -8265,13 +8314,14 @@ unsigned int leon3_funclt_trap::SWAP_reg::behavior(){
         flush();
     }
     else{
-        readValue = dataMem.read_word(address, 0xA | (PSR[key_S]? 1 : 0), 0, 1);
-        dataMem.write_word(address, toWrite, 0xA | (PSR[key_S]? 1 : 0), 0, 0);
+        readValue = dataMem.read_word(address, 0xA | (PSR.field<key_S>()? 1 : 0), 0, 1);
+        dataMem.write_word(address, toWrite, 0xA | (PSR.field<key_S>()? 1 : 0), 0, 0);
     }
     stall(2);
 
     if(notAligned){
         RaiseException(pcounter, npcounter, MEM_ADDR_NOT_ALIGNED);
+        return this->totalInstrCycles;
     }
 
     rd = readValue;
@@ -8332,7 +8382,7 @@ unsigned int leon3_funclt_trap::SUBX_imm::behavior(){
     rs2_op = SignExtend(simm13, 13);
 
     #ifndef ACC_MODEL
-    result = rs1_op - rs2_op - PSR[key_ICC_c];
+    result = rs1_op - rs2_op - PSR.field<key_ICC_c>();
     #else
     result = rs1_op - rs2_op - PSR_execute[key_ICC_c];
     #endif
@@ -8397,7 +8447,7 @@ unsigned int leon3_funclt_trap::STDA_reg::behavior(){
     else{
         toWrite = REGS[rd_bit + 1] || (((unsigned long long)rd) << 32);
     }
-    supervisor = PSR[key_S];
+    supervisor = PSR.field<key_S>();
 
     notAligned = (address & 0x00000003) != 0;
     #ifdef ACC_MODEL
@@ -8416,9 +8466,11 @@ unsigned int leon3_funclt_trap::STDA_reg::behavior(){
 
     if(!supervisor){
         RaiseException(pcounter, npcounter, PRIVILEDGE_INSTR);
+        return this->totalInstrCycles;
     }
     if(notAligned){
         RaiseException(pcounter, npcounter, MEM_ADDR_NOT_ALIGNED);
+        return this->totalInstrCycles;
     }
     this->IncrementPC();
     return this->totalInstrCycles;
@@ -8560,6 +8612,7 @@ unsigned int leon3_funclt_trap::JUMP_imm::behavior(){
 
     if(trapNotAligned){
         RaiseException(pcounter, npcounter, MEM_ADDR_NOT_ALIGNED);
+        return this->totalInstrCycles;
     }
 
     if(!trapNotAligned){
@@ -8797,7 +8850,7 @@ unsigned int leon3_funclt_trap::LDUBA_reg::behavior(){
     npcounter = NPC;
 
     address = rs1 + rs2;
-    supervisor = PSR[key_S];
+    supervisor = PSR.field<key_S>();
 
     #ifdef ACC_MODEL
     if(!supervisor){
@@ -8818,6 +8871,7 @@ unsigned int leon3_funclt_trap::LDUBA_reg::behavior(){
 
     if(!supervisor){
         RaiseException(pcounter, npcounter, PRIVILEDGE_INSTR);
+        return this->totalInstrCycles;
     }
 
     rd = readValue;
@@ -8897,6 +8951,7 @@ unsigned int leon3_funclt_trap::JUMP_reg::behavior(){
 
     if(trapNotAligned){
         RaiseException(pcounter, npcounter, MEM_ADDR_NOT_ALIGNED);
+        return this->totalInstrCycles;
     }
 
     if(!trapNotAligned){
@@ -8958,7 +9013,7 @@ unsigned int leon3_funclt_trap::ADDX_reg::behavior(){
     rs2_op = rs2;
 
     #ifndef ACC_MODEL
-    result = rs1_op + rs2_op + PSR[key_ICC_c];
+    result = rs1_op + rs2_op + PSR.field<key_ICC_c>();
     #else
     //I read the register of the execute stage since this
     //is the one containing the bypass value
@@ -9044,6 +9099,7 @@ unsigned int leon3_funclt_trap::UDIV_reg::behavior(){
 
     if(exception){
         RaiseException(pcounter, npcounter, DIV_ZERO);
+        return this->totalInstrCycles;
     }
     this->WB_plain(this->rd, this->rd_bit, this->result);
     return this->totalInstrCycles;
@@ -9205,7 +9261,7 @@ unsigned int leon3_funclt_trap::LDA_reg::behavior(){
     npcounter = NPC;
 
     address = rs1 + rs2;
-    supervisor = PSR[key_S];
+    supervisor = PSR.field<key_S>();
 
     notAligned = (address & 0x00000003) != 0;
     #ifdef ACC_MODEL
@@ -9227,9 +9283,11 @@ unsigned int leon3_funclt_trap::LDA_reg::behavior(){
 
     if(!supervisor){
         RaiseException(pcounter, npcounter, PRIVILEDGE_INSTR);
+        return this->totalInstrCycles;
     }
     if(notAligned){
         RaiseException(pcounter, npcounter, MEM_ADDR_NOT_ALIGNED);
+        return this->totalInstrCycles;
     }
 
     rd = readValue;
@@ -9291,7 +9349,7 @@ unsigned int leon3_funclt_trap::STHA_reg::behavior(){
 
     address = rs1 + rs2;
     toWrite = (unsigned short int)(rd & 0x0000FFFF);
-    supervisor = PSR[key_S];
+    supervisor = PSR.field<key_S>();
 
     notAligned = (address & 0x00000001) != 0;
     #ifdef ACC_MODEL
@@ -9310,9 +9368,11 @@ unsigned int leon3_funclt_trap::STHA_reg::behavior(){
 
     if(!supervisor){
         RaiseException(pcounter, npcounter, PRIVILEDGE_INSTR);
+        return this->totalInstrCycles;
     }
     if(notAligned){
         RaiseException(pcounter, npcounter, MEM_ADDR_NOT_ALIGNED);
+        return this->totalInstrCycles;
     }
     this->IncrementPC();
     return this->totalInstrCycles;
@@ -9375,7 +9435,7 @@ unsigned int leon3_funclt_trap::LDDA_reg::behavior(){
     #endif
 
     address = rs1 + rs2;
-    supervisor = PSR[key_S];
+    supervisor = PSR.field<key_S>();
 
     notAligned = (address & 0x00000007) != 0;
     #ifdef ACC_MODEL
@@ -9397,9 +9457,11 @@ unsigned int leon3_funclt_trap::LDDA_reg::behavior(){
 
     if(!supervisor){
         RaiseException(pcounter, npcounter, PRIVILEDGE_INSTR);
+        return this->totalInstrCycles;
     }
     if(notAligned){
         RaiseException(pcounter, npcounter, MEM_ADDR_NOT_ALIGNED);
+        return this->totalInstrCycles;
     }
 
     if(rd_bit % 2 == 0){
@@ -9560,6 +9622,7 @@ unsigned int leon3_funclt_trap::RESTORE_imm::behavior(){
 
     if(!okNewWin){
         RaiseException(pcounter, npcounter, WINDOW_UNDERFLOW);
+        return this->totalInstrCycles;
     }
 
     if(okNewWin){
@@ -9630,10 +9693,11 @@ unsigned int leon3_funclt_trap::LD_imm::behavior(){
     }
     #endif
 
-    readValue = dataMem.read_word(address, 0xA | (PSR[key_S]? 1 : 0), 0, 0);
+    readValue = dataMem.read_word(address, 0xA | (PSR.field<key_S>()? 1 : 0), 0, 0);
 
     if(notAligned){
         RaiseException(pcounter, npcounter, MEM_ADDR_NOT_ALIGNED);
+        return this->totalInstrCycles;
     }
 
     rd = readValue;
@@ -9690,10 +9754,10 @@ unsigned int leon3_funclt_trap::TRAP_reg::behavior(){
     npcounter = NPC;
 
     #ifndef ACC_MODEL
-    bool icc_z = PSR[key_ICC_z];
-    bool icc_n = PSR[key_ICC_n];
-    bool icc_v = PSR[key_ICC_v];
-    bool icc_c = PSR[key_ICC_c];
+    bool icc_z = PSR.field<key_ICC_z>();
+    bool icc_n = PSR.field<key_ICC_n>();
+    bool icc_v = PSR.field<key_ICC_v>();
+    bool icc_c = PSR.field<key_ICC_c>();
     #else
     bool icc_z = PSR_execute[key_ICC_z];
     bool icc_n = PSR_execute[key_ICC_n];
@@ -9732,6 +9796,7 @@ unsigned int leon3_funclt_trap::TRAP_reg::behavior(){
     if(raiseException){
         stall(4);
         RaiseException(pcounter, npcounter, TRAP_INSTRUCTION, (rs1 + rs2) & 0x0000007F);
+        return this->totalInstrCycles;
     }
     #ifndef ACC_MODEL // review!
     else{
@@ -9840,7 +9905,7 @@ unsigned int leon3_funclt_trap::LDUB_imm::behavior(){
 
     address = rs1 + SignExtend(simm13, 13);
 
-    readValue = dataMem.read_byte(address, 0xA | (PSR[key_S]? 1 : 0), 0, 0);
+    readValue = dataMem.read_byte(address, 0xA | (PSR.field<key_S>()? 1 : 0), 0, 0);
 
     rd = readValue;
     this->IncrementPC();
@@ -9897,9 +9962,9 @@ unsigned int leon3_funclt_trap::RETT_reg::behavior(){
     
 
     targetAddr = rs1 + rs2;
-    newCwp = ((unsigned int)(PSR[key_CWP] + 1)) % NUM_REG_WIN;
-    exceptionEnabled = PSR[key_ET];
-    supervisor = PSR[key_S];
+    newCwp = ((unsigned int)(PSR.field<key_CWP>() + 1)) % NUM_REG_WIN;
+    exceptionEnabled = PSR.field<key_ET>();
+    supervisor = PSR.field<key_S>();
     invalidWin = ((0x01 << (newCwp)) & WIM) != 0;
     notAligned = (targetAddr & 0x00000003) != 0;
     if(!exceptionEnabled && supervisor && !invalidWin && !notAligned){
@@ -9924,7 +9989,7 @@ unsigned int leon3_funclt_trap::RETT_reg::behavior(){
         flush();
     }
     else{
-        PSR.immediateWrite((PSR & 0xFFFFFF40) | (newCwp | 0x20 | (PSR[key_PS] << 7)));
+        PSR.immediateWrite((PSR & 0xFFFFFF40) | (newCwp | 0x20 | (PSR.field<key_PS>() << 7)));
         stall(2);
     }
 
@@ -9937,9 +10002,11 @@ unsigned int leon3_funclt_trap::RETT_reg::behavior(){
     if(exceptionEnabled){
         if(supervisor){
             RaiseException(pcounter, npcounter, ILLEGAL_INSTR);
+            return this->totalInstrCycles;
         }
         else{
             RaiseException(pcounter, npcounter, PRIVILEDGE_INSTR);
+            return this->totalInstrCycles;
         }
     }
     else if(!supervisor || invalidWin || notAligned){
@@ -9949,10 +10016,8 @@ unsigned int leon3_funclt_trap::RETT_reg::behavior(){
     }
     else{
         #ifndef ACC_MODEL
-        //Functional model: we simply immediately update the alias
-        for(int i = 8; i < 32; i++){
-            REGS[i].updateAlias(WINREGS[(newCwp*16 + i - 8) & 0x7f]);
-        }
+        //Functional model: we simply move the base of the register window
+        REGS[8].getWindow()->setCwp(newCwp);
         #else
         //Cycle accurate model: we have to update the alias using the pipeline register
         //We update the aliases for this stage and for all the preceding ones (we are in the
@@ -10055,6 +10120,7 @@ unsigned int leon3_funclt_trap::SDIVcc_imm::behavior(){
 
     if(exception){
         RaiseException(pcounter, npcounter, DIV_ZERO);
+        return this->totalInstrCycles;
     }
     this->WB_plain(this->rd, this->rd_bit, this->result);
     return this->totalInstrCycles;
@@ -10144,6 +10210,7 @@ unsigned int leon3_funclt_trap::SAVE_reg::behavior(){
 
     if(!okNewWin){
         RaiseException(pcounter, npcounter, WINDOW_OVERFLOW);
+        return this->totalInstrCycles;
     }
 
     if(okNewWin){
@@ -10378,17 +10445,15 @@ unsigned int leon3_funclt_trap::WRITEpsr_reg::behavior(){
     // Note how we filter writes to EF and EC fields since we do not
     // have neither a co-processor nor the FPU
     result = ((rs1 ^ rs2) & 0x00FFCFFF) | 0xF3000000;
-    supervisorException = (PSR[key_S] == 0);
+    supervisorException = (PSR.field<key_S>() == 0);
     illegalCWP = (result & 0x0000001f) >= NUM_REG_WIN;
 
     if(!(supervisorException || illegalCWP)){
         PSR = result;
         int newCwp = result & 0x0000001f;
         #ifndef ACC_MODEL
-        //Functional model: we simply immediately update the alias
-        for(int i = 8; i < 32; i++){
-            REGS[i].updateAlias(WINREGS[(newCwp*16 + i - 8) & 0x7f]);
-        }
+        //Functional model: we simply move the base of the register window
+        REGS[8].getWindow()->setCwp(newCwp);
         #else
         //Cycle accurate model: we have to update the alias using the pipeline register
         //We update the aliases for this stage and for all the preceding ones (we are in the
@@ -10403,9 +10468,11 @@ unsigned int leon3_funclt_trap::WRITEpsr_reg::behavior(){
 
     if(supervisorException){
         RaiseException(pcounter, npcounter, PRIVILEDGE_INSTR);
+        return this->totalInstrCycles;
     }
     if(illegalCWP){
         RaiseException(pcounter, npcounter, ILLEGAL_INSTR);
+        return this->totalInstrCycles;
     }
     return this->totalInstrCycles;
 }
@@ -133,8 +133,16 @@ namespace leon3_funclt_trap{
         virtual std::string getInstructionName() const throw() = 0;
         virtual std::string getMnemonic() const throw() = 0;
         virtual unsigned int getId() const throw() = 0;
+        /// Signals that the instruction was cut short by a synchronous trap;
+        /// behavior() returns right after it and the dispatch loop checks the
+        /// annulled flag. Define ANNULL_EXCEPTIONS to get back the old
+        /// behavior, where the trap unwinds the stack with an annull_exception.
         inline void annull(){
+            #ifdef ANNULL_EXCEPTIONS
             throw annull_exception();
+            #else
+            this->annulled = true;
+            #endif
         }
         inline void flush(){
 
@@ -150,6 +158,7 @@ namespace leon3_funclt_trap{
         bool checkIncrementWin() const throw();
         bool checkDecrementWin() const throw();
         unsigned int totalInstrCycles;
+        bool annulled;
         virtual ~Instruction();
     };
 
@@ -182,10 +191,7 @@ namespace leon3_funclt_trap{
         protected:
         inline void ICC_writeLogic( unsigned int & result ) throw(){
 
-            PSR[key_ICC_n] = ((result & 0x80000000) >> 31);
-            PSR[key_ICC_z] = (result == 0);
-            PSR[key_ICC_v] = 0;
-            PSR[key_ICC_c] = 0;
+            PSR.setICCLazy(Reg32_0::ICC_LOGIC, result, 0, 0);
         }
 
         public:
@@ -206,11 +212,11 @@ namespace leon3_funclt_trap{
         inline void ICC_writeTSub( unsigned int & result, bool & temp_V, unsigned int & rs1_op, \
             unsigned int & rs2_op ) throw(){
 
-            PSR[key_ICC_n] = ((result & 0x80000000) >> 31);
-            PSR[key_ICC_z] = (result == 0);
-            PSR[key_ICC_v] = temp_V;
-            PSR[key_ICC_c] = ((unsigned int)(((~rs1_op) & rs2_op) | (((~rs1_op) | rs2_op) & result))) \
-                >> 31;
+            PSR.setField<key_ICC_n>(((result & 0x80000000) >> 31));
+            PSR.setField<key_ICC_z>((result == 0));
+            PSR.setField<key_ICC_v>(temp_V);
+            PSR.setField<key_ICC_c>(((unsigned int)(((~rs1_op) & rs2_op) | (((~rs1_op) | rs2_op) & result))) \
+                >> 31);
         }
 
         public:
@@ -232,10 +238,10 @@ namespace leon3_funclt_trap{
             ) throw(){
 
             if(!exception){
-                PSR[key_ICC_n] = ((result & 0x80000000) >> 31);
-                PSR[key_ICC_z] = (result == 0);
-                PSR[key_ICC_v] = temp_V;
-                PSR[key_ICC_c] = 0;
+                PSR.setField<key_ICC_n>(((result & 0x80000000) >> 31));
+                PSR.setField<key_ICC_z>((result == 0));
+                PSR.setField<key_ICC_v>(temp_V);
+                PSR.setField<key_ICC_c>(0);
             }
         }
 
@@ -257,12 +263,7 @@ namespace leon3_funclt_trap{
         inline void ICC_writeAdd( unsigned int & result, unsigned int & rs1_op, unsigned \
             int & rs2_op ) throw(){
 
-            PSR[key_ICC_n] = ((result & 0x80000000) >> 31);
-            PSR[key_ICC_z] = (result == 0);
-            PSR[key_ICC_v] = ((unsigned int)((rs1_op & rs2_op & (~result)) | ((~rs1_op) & (~rs2_op) \
-                & result))) >> 31;
-            PSR[key_ICC_c] = ((unsigned int)((rs1_op & rs2_op) | ((rs1_op | rs2_op) & (~result)))) \
-                >> 31;
+            PSR.setICCLazy(Reg32_0::ICC_ADD, result, rs1_op, rs2_op);
         }
 
         public:
@@ -283,12 +284,7 @@ namespace leon3_funclt_trap{
         inline void ICC_writeSub( unsigned int & result, unsigned int & rs1_op, unsigned \
             int & rs2_op ) throw(){
 
-            PSR[key_ICC_n] = ((result & 0x80000000) >> 31);
-            PSR[key_ICC_z] = (result == 0);
-            PSR[key_ICC_v] = ((unsigned int)((rs1_op & (~rs2_op) & (~result)) | ((~rs1_op) & \
-                rs2_op & result))) >> 31;
-            PSR[key_ICC_c] = ((unsigned int)(((~rs1_op) & rs2_op) | (((~rs1_op) | rs2_op) & result))) \
-                >> 31;
+            PSR.setICCLazy(Reg32_0::ICC_SUB, result, rs1_op, rs2_op);
         }
 
         public:
@@ -309,11 +305,11 @@ namespace leon3_funclt_trap{
         inline void ICC_writeTAdd( unsigned int & result, bool & temp_V, unsigned int & rs1_op, \
             unsigned int & rs2_op ) throw(){
 
-            PSR[key_ICC_n] = ((result & 0x80000000) >> 31);
-            PSR[key_ICC_z] = (result == 0);
-            PSR[key_ICC_v] = temp_V;
-            PSR[key_ICC_c] = ((unsigned int)((rs1_op & rs2_op) | ((rs1_op | rs2_op) & (~result)))) \
-                >> 31;
+            PSR.setField<key_ICC_n>(((result & 0x80000000) >> 31));
+            PSR.setField<key_ICC_z>((result == 0));
+            PSR.setField<key_ICC_v>(temp_V);
+            PSR.setField<key_ICC_c>(((unsigned int)((rs1_op & rs2_op) | ((rs1_op | rs2_op) & (~result)))) \
+                >> 31);
         }
 
         public:
@@ -335,11 +331,11 @@ namespace leon3_funclt_trap{
             rs1_op, unsigned int & rs2_op ) throw(){
 
             if(!temp_V){
-                PSR[key_ICC_n] = ((result & 0x80000000) >> 31);
-                PSR[key_ICC_z] = (result == 0);
-                PSR[key_ICC_v] = temp_V;
-                PSR[key_ICC_c] = ((unsigned int)(((~rs1_op) & rs2_op) | (((~rs1_op) | rs2_op) & result))) \
-                    >> 31;
+                PSR.setField<key_ICC_n>(((result & 0x80000000) >> 31));
+                PSR.setField<key_ICC_z>((result == 0));
+                PSR.setField<key_ICC_v>(temp_V);
+                PSR.setField<key_ICC_c>(((unsigned int)(((~rs1_op) & rs2_op) | (((~rs1_op) | rs2_op) & result))) \
+                    >> 31);
             }
         }
 
@@ -385,11 +381,11 @@ namespace leon3_funclt_trap{
             rs1_op, unsigned int & rs2_op ) throw(){
 
             if(!temp_V){
-                PSR[key_ICC_n] = ((result & 0x80000000) >> 31);
-                PSR[key_ICC_z] = (result == 0);
-                PSR[key_ICC_v] = 0;
-                PSR[key_ICC_c] = ((unsigned int)((rs1_op & rs2_op) | ((rs1_op | rs2_op) & (~result)))) \
-                    >> 31;
+                PSR.setField<key_ICC_n>(((result & 0x80000000) >> 31));
+                PSR.setField<key_ICC_z>((result == 0));
+                PSR.setField<key_ICC_v>(0);
+                PSR.setField<key_ICC_c>(((unsigned int)((rs1_op & rs2_op) | ((rs1_op | rs2_op) & (~result)))) \
+                    >> 31);
             }
         }
 
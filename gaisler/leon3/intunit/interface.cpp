@@ -70,24 +70,20 @@ void leon3_funclt_trap::LEON3_ABIIf::waitInstrEnd() const throw(){
 
 void leon3_funclt_trap::LEON3_ABIIf::preCall() throw(){
 
-    unsigned int newCwp = ((unsigned int)(PSR[key_CWP] - 1)) % 8;
+    unsigned int newCwp = ((unsigned int)(PSR.field<key_CWP>() - 1)) % 8;
     PSR.immediateWrite((PSR & 0xFFFFFFE0) | newCwp);
 
-    //ABI model: we simply immediately update the alias
-    for(int i = 8; i < 32; i++){
-        REGS[i].updateAlias(WINREGS[(newCwp*16 + i - 8) % (128)]);
-    }
+    //ABI model: we simply move the base of the register window
+    REGS[8].getWindow()->setCwp(newCwp);
 }
 
 void leon3_funclt_trap::LEON3_ABIIf::postCall() throw(){
 
-    unsigned int newCwp = ((unsigned int)(PSR[key_CWP] + 1)) % 8;
+    unsigned int newCwp = ((unsigned int)(PSR.field<key_CWP>() + 1)) % 8;
     PSR.immediateWrite((PSR & 0xFFFFFFE0) | newCwp);
 
-    //ABI model: we simply immediately update the alias
-    for(int i = 8; i < 32; i++){
-        REGS[i].updateAlias(WINREGS[(newCwp*16 + i - 8) % (128)]);
-    }
+    //ABI model: we simply move the base of the register window
+    REGS[8].getWindow()->setCwp(newCwp);
 }
 
 void leon3_funclt_trap::LEON3_ABIIf::returnFromCall() throw(){
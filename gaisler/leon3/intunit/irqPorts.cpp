@@ -54,6 +54,7 @@ void leon3_funclt_trap::IntrTLMPort_32::callbackMethod( const std::pair<unsigned
     else{
         //Raise the interrupt
         this->irqSignal = value.first;
+        this->raised.notify();
         v::debug << name() << "InterruptIN " << value.first << v::endl;
     }
 }
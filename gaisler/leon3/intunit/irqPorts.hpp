@@ -58,6 +58,9 @@ namespace leon3_funclt_trap{
         unsigned int & irqSignal;
 
         signal< std::pair<unsigned int, bool> >::in irq_signal;
+
+        /// Notified whenever the interrupt controller raises an interrupt
+        sc_event raised;
     };
 
 };
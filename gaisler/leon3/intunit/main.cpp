@@ -417,6 +417,7 @@ int sc_main( int argc, char * * argv ){
     procInst.toolManager.addTool(osEmu);
     if(vm.count("debugger") != 0){
         procInst.toolManager.addTool(gdbStub);
+        procInst.haltPoll = sc_time(100, SC_NS);
         gdbStub.initialize();
         procInst.instrMem.setDebugger(&gdbStub);
         procInst.dataMem.setDebugger(&gdbStub);
@@ -0,0 +1,147 @@
+/***************************************************************************\
+ *
+ *
+ *         _/        _/_/_/_/    _/_/    _/      _/   _/_/_/
+ *        _/        _/        _/    _/  _/_/    _/         _/
+ *       _/        _/_/_/    _/    _/  _/  _/  _/     _/_/
+ *      _/        _/        _/    _/  _/    _/_/         _/
+ *     _/_/_/_/  _/_/_/_/    _/_/    _/      _/   _/_/_/
+ *
+ *
+ *
+ *
+ *   This file is part of LEON3.
+ *
+ *   LEON3 is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the
+ *   Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *   or see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *
+ *   (c) 2026 agent
+ *
+\***************************************************************************/
+
+
+
+#include "gaisler/leon3/intunit/predecode.hpp"
+#include "gaisler/leon3/intunit/instructions.hpp"
+
+using namespace leon3_funclt_trap;
+leon3_funclt_trap::PredecodePage::PredecodePage() : valid(0){
+    for(int i = 0; i < 1024; i++){
+        this->instrs[i] = NULL;
+        this->bitStrings[i] = 0;
+        this->asis[i] = 0;
+    }
+}
+
+leon3_funclt_trap::PredecodeTable::PredecodeTable() : invalidations(0){
+    for(int i = 0; i < 1024; i++){
+        this->pages[i] = NULL;
+    }
+}
+
+leon3_funclt_trap::PredecodeTable::~PredecodeTable(){
+    this->flush();
+    this->collectRetired();
+    for(int i = 0; i < 1024; i++){
+        delete [] this->pages[i];
+    }
+}
+
+void leon3_funclt_trap::PredecodeTable::insert( unsigned int pc, unsigned int asi, \
+    unsigned int bitString, Instruction * instr ) throw(){
+    PredecodePage **&dir = this->pages[pc >> 22];
+    if(dir == NULL){
+        dir = new PredecodePage *[1024];
+        for(int i = 0; i < 1024; i++){
+            dir[i] = NULL;
+        }
+    }
+    PredecodePage *&page = dir[(pc >> 12) & 0x3ff];
+    if(page == NULL){
+        page = new PredecodePage();
+    }
+    unsigned int idx = (pc >> 2) & 0x3ff;
+    if(page->instrs[idx] != NULL){
+        this->retired.push_back(page->instrs[idx]);
+    } else {
+        page->valid++;
+    }
+    page->instrs[idx] = instr;
+    page->bitStrings[idx] = bitString;
+    page->asis[idx] = asi;
+}
+
+bool leon3_funclt_trap::PredecodeTable::invalidateRange( unsigned int address, unsigned int \
+    length ) throw(){
+    bool dropped = false;
+    unsigned int addr = address & ~0x3;
+    unsigned int last = address + length - 1;
+    while(true){
+        PredecodePage **dir = this->pages[addr >> 22];
+        PredecodePage *page = (dir != NULL)? dir[(addr >> 12) & 0x3ff] : NULL;
+        // end of the range within the current page
+        unsigned int pageEnd = addr | 0xfff;
+        unsigned int end = (last < pageEnd)? last : pageEnd;
+        if(page != NULL && page->valid != 0){
+            for(unsigned int idx = (addr >> 2) & 0x3ff; idx <= ((end >> 2) & 0x3ff); idx++){
+                if(page->instrs[idx] != NULL){
+                    this->retired.push_back(page->instrs[idx]);
+                    page->instrs[idx] = NULL;
+                    page->valid--;
+                    this->invalidations++;
+                    dropped = true;
+                }
+            }
+        }
+        if(end == last){
+            break;
+        }
+        addr = end + 1;
+    }
+    return dropped;
+}
+
+void leon3_funclt_trap::PredecodeTable::flush() throw(){
+    for(int i = 0; i < 1024; i++){
+        if(this->pages[i] == NULL){
+            continue;
+        }
+        for(int j = 0; j < 1024; j++){
+            PredecodePage *page = this->pages[i][j];
+            if(page == NULL){
+                continue;
+            }
+            for(int k = 0; k < 1024 && page->valid != 0; k++){
+                if(page->instrs[k] != NULL){
+                    this->retired.push_back(page->instrs[k]);
+                    page->valid--;
+                    this->invalidations++;
+                }
+            }
+            delete page;
+            this->pages[i][j] = NULL;
+        }
+    }
+}
+
+void leon3_funclt_trap::PredecodeTable::collectRetired() throw(){
+    for(unsigned int i = 0; i < this->retired.size(); i++){
+        delete this->retired[i];
+    }
+    this->retired.clear();
+}
@@ -0,0 +1,125 @@
+/***************************************************************************\
+ *
+ *
+ *         _/        _/_/_/_/    _/_/    _/      _/   _/_/_/
+ *        _/        _/        _/    _/  _/_/    _/         _/
+ *       _/        _/_/_/    _/    _/  _/  _/  _/     _/_/
+ *      _/        _/        _/    _/  _/    _/_/         _/
+ *     _/_/_/_/  _/_/_/_/    _/_/    _/      _/   _/_/_/
+ *
+ *
+ *
+ *
+ *   This file is part of LEON3.
+ *
+ *   LEON3 is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the
+ *   Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *   or see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *
+ *   (c) 2026 agent
+ *
+\***************************************************************************/
+
+
+#ifndef LT_PREDECODE_HPP
+#define LT_PREDECODE_HPP
+
+#include "gaisler/leon3/intunit/instructions.hpp"
+#include <vector>
+
+#define FUNC_MODEL
+#define LT_IF
+namespace leon3_funclt_trap{
+
+    /// Decoded instructions of one 4KB page, indexed by word offset
+    class PredecodePage{
+
+        public:
+        PredecodePage();
+        Instruction * instrs[1024];
+        unsigned int bitStrings[1024];
+        /// Fetch ASI (user or supervisor) each entry was decoded for
+        unsigned char asis[1024];
+        /// Number of decoded entries in the page
+        unsigned int valid;
+    };
+
+    /// PC indexed store of decoded instructions. Pages are organized in a
+    /// two level table (1024 directories of 1024 pages) and allocated
+    /// lazily on first decode. Every decoded entry owns its instruction
+    /// object, so its operands stay bound between executions. Entries are
+    /// only found with the fetch ASI they were decoded for, so that fetches
+    /// in the other privilege mode go through the MMU checks again.
+    class PredecodeTable{
+
+        public:
+        PredecodeTable();
+        ~PredecodeTable();
+        /// Returns the decoded instruction at pc, NULL if not decoded yet
+        /// or decoded for another ASI
+        inline Instruction * find( unsigned int pc, unsigned int asi ) const throw(){
+            PredecodePage **dir = this->pages[pc >> 22];
+            if(dir == NULL){
+                return NULL;
+            }
+            PredecodePage *page = dir[(pc >> 12) & 0x3ff];
+            if(page == NULL){
+                return NULL;
+            }
+            unsigned int idx = (pc >> 2) & 0x3ff;
+            return (page->asis[idx] == asi)? page->instrs[idx] : NULL;
+        }
+        /// Returns the instruction word a decoded entry was built from
+        inline unsigned int bitString( unsigned int pc ) const throw(){
+            return this->pages[pc >> 22][(pc >> 12) & 0x3ff]->bitStrings[(pc >> 2) & 0x3ff];
+        }
+        /// Stores instr as decoded instruction at pc; the table takes ownership
+        void insert( unsigned int pc, unsigned int asi, unsigned int bitString, Instruction * instr ) throw();
+        /// Drops all decoded entries overlapping [address, address + length).
+        /// Returns true if any decoded instruction has been dropped.
+        inline bool invalidate( unsigned int address, unsigned int length ) throw(){
+            PredecodePage **dir = this->pages[address >> 22];
+            if(dir == NULL && ((address + length - 1) >> 22) == (address >> 22)){
+                return false;
+            }
+            return this->invalidateRange(address, length);
+        }
+        /// Drops all decoded entries
+        void flush() throw();
+        /// Deletes the instruction objects dropped since the last call; must
+        /// only be called while no decoded instruction is executing
+        inline void collect() throw(){
+            if(!this->retired.empty()){
+                this->collectRetired();
+            }
+        }
+        /// Number of decoded instructions dropped due to invalidation
+        unsigned long long invalidations;
+
+        private:
+        bool invalidateRange( unsigned int address, unsigned int length ) throw();
+        void collectRetired() throw();
+        PredecodePage **pages[1024];
+        /// Dropped instructions waiting for deletion
+        std::vector< Instruction * > retired;
+    };
+
+};
+
+
+
+#endif
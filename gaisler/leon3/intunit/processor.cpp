@@ -54,6 +54,7 @@
 #include "gaisler/leon3/intunit/irqPorts.hpp"
 #include "gaisler/leon3/intunit/externalPins.hpp"
 #include <string>
+#include <sys/time.h>
 #include "core/common/systemc.h"
 #include "core/common/verbose.h"
 
@@ -63,64 +64,152 @@ void leon3_funclt_trap::Processor_leon3_funclt::mainLoop() {
     wait(SC_ZERO_TIME); // wait for SystemC infrastructure.
                         // if you don't wait the register callbacks will crash
 
-    bool startMet = false;
-    vmap< unsigned int, CacheElem >::iterator instrCacheEnd = this->instrCache.end();
-
     unsigned int firstPC = this->PC + 0;
-    unsigned int firstbitString = this->instrMem.read_instr(firstPC, 0x8 | (PSR[key_S]? 1 : 0), 0);
+    unsigned int firstbitString = this->instrMem.read_instr(firstPC, 0x8 | (PSR.field<key_S>()? 1 : 0), 0);
     int firstinstrId = this->decoder.decode(firstbitString);
     Instruction *firstinstr = this->INSTRUCTIONS[firstinstrId];
     raisedException = 0;
     while(true) {
         unsigned int numCycles = 0;
+        unsigned int numExecuted = 1;
         this->instrExecuting = true;
+        this->predecode.collect();
 
+        if(irqAck.powerdown && !irqAck.stopped) {
+          irqAck.stopped = true;
+          irqAck.status = false;
+        }
         if(irqAck.stopped) {
+          // Halted cores sleep until the interrupt controller starts or
+          // interrupts them, so that they cost no host time. With a
+          // debugger attached they wake up periodically to poll it.
+          this->quantKeeper.sync();
           while(irqAck.stopped) {
-            //if(sc_time_stamp()>sc_time(0, SC_NS)) {
-              //wait(irqAck.start);
-              this->toolManager.newIssue(firstPC, firstinstr);
-              wait(100, SC_NS);
-            //}
+            this->toolManager.newIssue(firstPC, firstinstr);
+            if(irqAck.powerdown && this->irqLine != 0xFFFFFFFF) {
+              irqAck.stopped = false;
+              irqAck.status = true;
+            } else if(irqAck.powerdown) {
+              if(this->haltPoll != SC_ZERO_TIME) {
+                wait(this->haltPoll, irqAck.start | this->IRQ_port.raised);
+              } else {
+                wait(irqAck.start | this->IRQ_port.raised);
+              }
+            } else if(this->haltPoll != SC_ZERO_TIME) {
+              wait(this->haltPoll, irqAck.start);
+            } else {
+              wait(irqAck.start);
+            }
+          }
+          this->quantKeeper.reset();
+          if(irqAck.powerdown) {
+            irqAck.powerdown = false;
+          } else {
+            v::info << name() << "Starting ... " << v::endl;
+            resetOp();
           }
-          v::info << name() << "Starting ... " << v::endl;
-          resetOp();
         }
-
-        // Log instruction count for power monitoring
-        if (m_pow_mon) {
-            dyn_instr++;
+        this->IRQ = this->irqLine;
+        if(this->IRQ != 0xFFFFFFFF){
+            // Pending interrupts keep the quantum narrow
+            this->quantKeeper.disturb();
         }
 
-        if((IRQ != 0xFFFFFFFF) && (PSR[key_ET] && (IRQ == 15 || IRQ > PSR[key_PIL]))){
+        if(this->irqPending()){
             this->IRQ_irqInstr->setInterruptValue(IRQ);
             try{
                 numCycles = this->IRQ_irqInstr->behavior();
                 //this->IRQ_irqInstr->behavior(); // Replacement for ^^
+                if(this->IRQ_irqInstr->annulled){
+                    this->IRQ_irqInstr->annulled = false;
+                    numCycles = 0;
+                }
             }
             catch(annull_exception &etc){
               numCycles = 0;
             }
 
+        } else if(this->parallelEnabled && !this->historyEnabled) {
+            // The rest of the quantum is issued on the host worker thread,
+            // which keeps track of the local time on its own
+            numExecuted = this->worker.runQuantum();
+            if (m_pow_mon) {
+                dyn_instr += numExecuted;
+            }
+            if (this->quantKeeper.need_sync()){
+                this->quantKeeper.sync();
+            }
+            this->instrExecuting = false;
+            this->instrEndEvent.notify();
+            this->numInstructions += numExecuted;
+            continue;
         } else {
-            try {
-                curPC = this->PC + 0;
-                if(!startMet && curPC == this->profStartAddr){
-                    this->profTimeStart = sc_time_stamp();
-                } else if(startMet && curPC == this->profEndAddr){
-                    this->profTimeEnd = sc_time_stamp();
-                }
+            numExecuted = this->issueInstruction(numCycles);
+        }
+        // Log instruction count for power monitoring
+        if (m_pow_mon) {
+            dyn_instr += numExecuted;
+        }
+
+        this->quantKeeper.inc((numCycles + numExecuted)*this->latency);
+        if (this->quantKeeper.need_sync()){
+            this->quantKeeper.sync();
+        }
+        this->instrExecuting = false;
+        this->instrEndEvent.notify();
+        this->numInstructions += numExecuted;
+    }
+}
 
-                int instrId = 0;
-                unsigned int bitString = this->instrMem.read_instr(curPC, 0x8 | (PSR[key_S]? 1 : 0),0);
-                if(raisedException) {
-                    unsigned int exception = raisedException;
-                    raisedException = 0;
-                    curInstrPtr->RaiseException(raisedExceptionPC, raisedExceptionNPC, exception);
+unsigned int leon3_funclt_trap::Processor_leon3_funclt::issueInstruction( unsigned int \
+    & numCycles ){
+    bool startMet = false;
+    unsigned int numExecuted = 1;
+    if(this->blockCacheEnabled && (numExecuted = this->executeBlock(numCycles)) != 0) {
+        // A whole basic block has been issued; numCycles holds the
+        // summed up cycles of all its instructions
+    } else {
+        numExecuted = 1;
+        try {
+            curPC = this->PC + 0;
+            if(!startMet && curPC == this->profStartAddr){
+                this->profTimeStart = this->worker.running()? this->quantKeeper.getLatchedTime() : sc_time_stamp();
+            } else if(startMet && curPC == this->profEndAddr){
+                this->profTimeEnd = this->worker.running()? this->quantKeeper.getLatchedTime() : sc_time_stamp();
+            }
+
+            int instrId = 0;
+            unsigned int bitString = 0;
+            Instruction *decoded = NULL;
+            bool fetched = true;
+            unsigned int fetchCycles = 0;
+            if(this->predecodeEnabled) {
+                decoded = this->fetchDecoded(curPC, 0x8 | (PSR.field<key_S>()? 1 : 0), bitString, fetched);
+                if(decoded != NULL && !fetched) {
+                    fetchCycles = this->fetchDecodedHit(curPC, 0x8 | (PSR.field<key_S>()? 1 : 0));
                 }
-                vmap< unsigned int, CacheElem >::iterator cachedInstr = this->instrCache.find(bitString);
+            } else {
+                bitString = this->instrMem.read_instr(curPC, 0x8 | (PSR.field<key_S>()? 1 : 0),0);
+            }
+            bool trapped = false;
+            if(raisedException) {
+                unsigned int exception = raisedException;
+                raisedException = 0;
+                curInstrPtr->RaiseException(raisedExceptionPC, raisedExceptionNPC, exception);
+                trapped = curInstrPtr->annulled;
+                curInstrPtr->annulled = false;
+            }
+            if(trapped) {
+                // The trap has been taken, nothing is issued in this cycle
+                numCycles = 0;
+            } else {
+                vmap< unsigned int, CacheElem >::iterator instrCacheEnd = this->instrCache.end();
+                vmap< unsigned int, CacheElem >::iterator cachedInstr = instrCacheEnd;
                 unsigned int *curCount = NULL;
-                if(cachedInstr != instrCacheEnd) {
+                if(decoded != NULL) {
+                    // Found in the predecode table, already bound to its operands
+                    curInstrPtr = decoded;
+                } else if((cachedInstr = this->instrCache.find(bitString)) != instrCacheEnd) {
                     curInstrPtr = cachedInstr->second.instr;
                     // I can call the instruction, I have found it
                     if(curInstrPtr == NULL) {
@@ -145,17 +234,26 @@ void leon3_funclt_trap::Processor_leon3_funclt::mainLoop() {
                 }
                 try {
                     #ifndef DISABLE_TOOLS
-                    if (!(this->toolManager.newIssue(curPC, curInstrPtr))) {
+                    if (!(this->issueTools(curPC, curInstrPtr))) {
                         #endif
                         numCycles = curInstrPtr->behavior();
                         //curInstrPtr->behavior(); // Replacement for ^^
+                        if (curInstrPtr->annulled) {
+                            // A synchronous trap was taken by the instruction
+                            curInstrPtr->annulled = false;
+                            numCycles = 0;
+                        }
                         #ifndef DISABLE_TOOLS
                     }
                     #endif
                 } catch (annull_exception &etc) {
                     numCycles = 0;
                 }
-                if (cachedInstr != instrCacheEnd) {
+                if (decoded != NULL) {
+                    // The predecode table owns the instruction. The fetch it
+                    // saved still costs an icache hit.
+                    numCycles += fetchCycles;
+                } else if (cachedInstr != instrCacheEnd) {
                     if (curCount && *curCount < 256) {
 //                        *curCount++; // ????
                     } else if (curCount) {
@@ -165,20 +263,237 @@ void leon3_funclt_trap::Processor_leon3_funclt::mainLoop() {
                     }
                 } else {
                     this->instrCache.insert(std::pair< unsigned int, CacheElem >(bitString, CacheElem()));
-                    instrCacheEnd = this->instrCache.end();
                 }
-            } catch (annull_exception &etc) {
-                numCycles = 0;
             }
+        } catch (annull_exception &etc) {
+            numCycles = 0;
         }
-        this->quantKeeper.inc((numCycles + 1)*this->latency);
-        if (this->quantKeeper.need_sync()){
-            this->quantKeeper.sync();
+    }
+    return numExecuted;
+}
+
+unsigned int leon3_funclt_trap::Processor_leon3_funclt::issueQuantum(){
+    unsigned int executed = 0;
+    while(!this->quantKeeper.needSyncLatched() && !this->haltLatched && !this->irqPending() && !this->irqAck.powerdown) {
+        unsigned int numCycles = 0;
+        this->predecode.collect();
+        unsigned int numExecuted = this->issueInstruction(numCycles);
+        this->quantKeeper.inc((numCycles + numExecuted)*this->latency);
+        executed += numExecuted;
+    }
+    return executed;
+}
+
+void leon3_funclt_trap::Processor_leon3_funclt::latchExternal(){
+    this->IRQ = this->irqLine;
+    this->haltLatched = this->irqAck.stopped;
+    this->quantKeeper.latchTime();
+    if(this->foreignFlush) {
+        this->flushCode();
+        this->foreignFlush = false;
+    } else {
+        for(unsigned int i = 0; i < this->foreignWrites.size(); i++) {
+            this->invalidateCode(this->foreignWrites[i].first, this->foreignWrites[i].second);
         }
-        this->instrExecuting = false;
-        this->instrEndEvent.notify();
-        this->numInstructions++;
     }
+    this->foreignWrites.clear();
+}
+
+Instruction * leon3_funclt_trap::Processor_leon3_funclt::fetchDecoded( unsigned int pc, \
+    unsigned int asi, unsigned int & bitString, bool & fetched ){
+    Instruction *instr = this->predecode.find(pc, asi);
+    if(instr != NULL) {
+        bitString = this->predecode.bitString(pc);
+        fetched = false;
+        return instr;
+    }
+    fetched = true;
+    bitString = this->instrMem.read_instr(pc, asi, 0);
+    if(raisedException) {
+        return NULL;
+    }
+    int instrId = this->decoder.decode(bitString);
+    instr = this->INSTRUCTIONS[instrId]->replicate();
+    instr->setParams(bitString);
+    this->predecode.insert(pc, asi, bitString, instr);
+    return instr;
+}
+
+unsigned int leon3_funclt_trap::Processor_leon3_funclt::fetchDecodedHit( unsigned int pc, \
+    unsigned int asi ){
+    if(this->instrMem.read_instr_hit(pc, asi)) {
+        return 1;
+    }
+    // The line left the icache: the refill is timed by the memory, a fault
+    // is raised before the instruction executes
+    this->instrMem.read_instr(pc, asi, 0);
+    return 0;
+}
+
+void leon3_funclt_trap::Processor_leon3_funclt::invalidateCode( unsigned int address, \
+    unsigned int length ){
+    // Blocks are always built from predecoded instructions, so only ranges
+    // holding decoded code have to be searched in the block cache
+    if(this->predecode.invalidate(address, length)) {
+        this->blockCache.invalidate(address, address + length);
+    }
+}
+
+void leon3_funclt_trap::Processor_leon3_funclt::invalidateForeignCode( unsigned int \
+    address, unsigned int length ){
+    if(this->worker.running()) {
+        // The worker may be executing the code right now
+        this->foreignWrites.push_back(std::pair< unsigned int, unsigned int >(address, length));
+    } else {
+        this->invalidateCode(address, length);
+    }
+}
+
+void leon3_funclt_trap::Processor_leon3_funclt::flushForeignCode(){
+    if(this->worker.running()) {
+        // The worker may be executing the code right now
+        this->foreignFlush = true;
+    } else {
+        this->flushCode();
+    }
+}
+
+void leon3_funclt_trap::Processor_leon3_funclt::flushCode(){
+    this->predecode.flush();
+    this->blockCache.flush();
+}
+
+BasicBlock * leon3_funclt_trap::Processor_leon3_funclt::translateBlock( unsigned int pc, \
+    unsigned int asi ){
+    BasicBlock *block = new BasicBlock(pc, asi);
+    bool delaySlot = false;
+    while(true) {
+        unsigned int bitString = 0;
+        bool fetched = false;
+        Instruction *decoded = this->fetchDecoded(block->endPC, asi, bitString, fetched);
+        if(decoded == NULL) {
+            // Fetch fault: the single stepping path raises the exception
+            // once execution actually reaches this address
+            raisedException = 0;
+            break;
+        }
+        Instruction *instr = decoded->replicate();
+        instr->setParams(bitString);
+        int instrId = instr->getId();
+        block->instrs.push_back(instr);
+        block->bitStrings.push_back(bitString);
+        block->fetchTimed.push_back(fetched);
+        block->size++;
+        block->endPC += 4;
+        if(delaySlot || (BlockCache::endsBlock(instrId) && !BlockCache::hasDelaySlot(instrId))) {
+            break;
+        }
+        delaySlot = BlockCache::hasDelaySlot(instrId);
+        if((!delaySlot && block->size >= this->blockCache.maxBlockSize) || (block->endPC & 0xfff) == 0) {
+            break;
+        }
+    }
+    if(block->size == 0) {
+        delete block;
+        return NULL;
+    }
+    this->blockCache.insert(block);
+    return block;
+}
+
+unsigned int leon3_funclt_trap::Processor_leon3_funclt::executeBlock( unsigned int & numCycles ){
+    if(raisedException) {
+        // Pending exceptions are raised by the single stepping path
+        this->lastBlock = NULL;
+        return 0;
+    }
+    unsigned int pc = this->PC + 0;
+    if(pc == this->profStartAddr || pc == this->profEndAddr) {
+        // Profiling boundaries are timed by the single stepping path
+        this->lastBlock = NULL;
+        return 0;
+    }
+    unsigned int asi = 0x8 | (PSR.field<key_S>()? 1 : 0);
+    BasicBlock *block = NULL;
+    bool chained = this->lastBlock != NULL && this->lastBlockEpoch == this->blockCache.epoch;
+    if(chained) {
+        block = this->lastBlock->successor(pc, asi);
+    }
+    if(block == NULL) {
+        this->blockCache.collect();
+        block = this->blockCache.find(pc, asi);
+        if(block == NULL) {
+            block = this->translateBlock(pc, asi);
+            if(block == NULL) {
+                this->lastBlock = NULL;
+                return 0;
+            }
+            // translating may have dropped older blocks
+            chained = chained && this->lastBlockEpoch == this->blockCache.epoch;
+        }
+        if(chained) {
+            this->lastBlock->chain(block);
+        }
+    }
+    this->lastBlock = block;
+    this->lastBlockEpoch = this->blockCache.epoch;
+
+    unsigned int executed = 0;
+    while(executed < block->size && pc == block->startPC + (executed << 2)) {
+        if(executed != 0 && (pc == this->profStartAddr || pc == this->profEndAddr)) {
+            // Leave the block in front of a profiling boundary
+            break;
+        }
+        curPC = pc;
+        curInstrPtr = block->instrs[executed];
+        // Every issued instruction is fetched, at the cost of an icache
+        // hit. Fetches timed while translating are not charged twice.
+        if(block->fetchTimed[executed]) {
+            block->fetchTimed[executed] = false;
+        } else {
+            numCycles += this->fetchDecodedHit(pc, asi);
+        }
+        executed++;
+        try {
+            if(raisedException) {
+                unsigned int exception = raisedException;
+                raisedException = 0;
+                curInstrPtr->RaiseException(raisedExceptionPC, raisedExceptionNPC, exception);
+                if(curInstrPtr->annulled) {
+                    curInstrPtr->annulled = false;
+                    break;
+                }
+            }
+            if (this->historyEnabled) {
+                srInfo()
+                    ("Address",curPC)
+                    ("Name",curInstrPtr->getInstructionName())
+                    ("Mnemonic",curInstrPtr->getMnemonic())
+                    ("Instruction History");
+            }
+            #ifndef DISABLE_TOOLS
+            if (!(this->issueTools(curPC, curInstrPtr))) {
+                #endif
+                unsigned int cycles = curInstrPtr->behavior();
+                if(curInstrPtr->annulled) {
+                    curInstrPtr->annulled = false;
+                    break;
+                }
+                numCycles += cycles;
+                #ifndef DISABLE_TOOLS
+            }
+            #endif
+        } catch (annull_exception &etc) {
+            break;
+        }
+        if(this->lastBlockEpoch != this->blockCache.epoch) {
+            // The block has been invalidated by the instruction just issued
+            this->lastBlock = NULL;
+            break;
+        }
+        pc = this->PC + 0;
+    }
+    return executed;
 }
 
 void leon3_funclt_trap::Processor_leon3_funclt::triggerException(unsigned int exception) {
@@ -240,6 +555,11 @@ void leon3_funclt_trap::Processor_leon3_funclt::resetOp(){
     PC.immediateWrite(ENTRY_POINT);
     NPC.immediateWrite(ENTRY_POINT + 0x4);
     this->IRQ = -1;
+    this->irqLine = -1;
+    this->irqAck.powerdown = false;
+
+    // A (re)loaded program invalidates everything decoded so far
+    this->flushCode();
 
     //user-defined initialization
     this->beginOp();
@@ -285,6 +605,9 @@ gs::cnf::callback_return_type leon3_funclt_trap::Processor_leon3_funclt::swi_pow
 
 // Automatically called at the beginning of the simulation
 void leon3_funclt_trap::Processor_leon3_funclt::start_of_simulation() {
+  struct timeval now;
+  gettimeofday(&now, NULL);
+  hostStartTime = (unsigned long long)now.tv_sec*1000000 + now.tv_usec;
 
   // Initialize power model
   if (m_pow_mon) {
@@ -299,10 +622,35 @@ void leon3_funclt_trap::Processor_leon3_funclt::end_of_simulation() {
     v::report << name() << " * LEON3 Statistic:" << v::endl;
     v::report << name() << " * ------------------" << v::endl;
     v::report << name() << " * Total number of processed instructions: " << numInstructions << v::endl;
+    if (blockCacheEnabled) {
+        v::report << name() << " * Translated basic blocks: " << blockCache.translations << v::endl;
+        v::report << name() << " * Invalidated basic blocks: " << blockCache.invalidations << v::endl;
+    }
+    if (predecodeEnabled || blockCacheEnabled) {
+        v::report << name() << " * Invalidated predecoded instructions: " << predecode.invalidations << v::endl;
+    }
+    if (worker.quanta) {
+        v::report << name() << " * Quanta issued on the worker thread: " << worker.quanta << v::endl;
+        v::report << name() << " * Requests served for the worker thread: " << worker.requests << v::endl;
+        v::report << name() << " * Stores queued by the worker thread: " << worker.postedStores << v::endl;
+    }
+    struct timeval now;
+    gettimeofday(&now, NULL);
+    unsigned long long hostTime = (unsigned long long)now.tv_sec*1000000 + now.tv_usec - hostStartTime;
+    v::report << name() << " * Quantum synchronizations: " << quantKeeper.syncs << v::endl;
+    if (adaptiveQuantum) {
+        v::report << name() << " * Final adaptive quantum: " << quantKeeper.getQuantum() << v::endl;
+    }
+    if (hostTime) {
+        v::report << name() << " * Achieved MIPS: " << (double)numInstructions / (double)hostTime << v::endl;
+    }
     v::report << name() << " ******************************************** " << v::endl;
 }
 
 void leon3_funclt_trap::Processor_leon3_funclt::end_of_elaboration(){
+    // The clock of the core is known now
+    this->quantKeeper.setQuantum(this->latency*this->quantumCycles, \
+        this->latency*this->maxQuantumCycles, this->adaptiveQuantum);
     if(!this->resetCalled){
         this->resetOp();
     }
@@ -401,12 +749,20 @@ leon3_funclt_trap::Processor_leon3_funclt::Processor_leon3_funclt(
         Reg32_3("ASR29"), Reg32_3("ASR30"), Reg32_3("ASR31")},
 #endif
       mem(memory),
-      instrMem(*mem),
-      dataMem(*mem),
+      worker(*this, memory),
+      instrMem(worker),
+      dataMem(worker),
       latency(latency),
-      IRQ_port("IRQ_port", IRQ),
+      haltPoll(SC_ZERO_TIME),
+      IRQ_port("IRQ_port", irqLine),
       irqAck("irqAck"),
       historyEnabled("historyEnabled", false),
+      blockCacheEnabled("blockCacheEnabled", false),
+      predecodeEnabled("predecodeEnabled", false),
+      parallelEnabled("parallelEnabled", false),
+      quantumCycles("quantum", 100),
+      maxQuantumCycles("maxquantum", 6400),
+      adaptiveQuantum("adaptivequantum", false),
       m_pow_mon(pow_mon),
       sta_power_norm("power.leon3.sta_power_norm", 5.27e+8, true), // norm. static power
       int_power_norm("power.leon3.int_power_norm", 5.497e-6, true), // norm. dynamic power
@@ -421,6 +777,12 @@ leon3_funclt_trap::Processor_leon3_funclt::Processor_leon3_funclt(
       numInstructions("instruction_count", 0ull)
 {
     this->resetCalled = false;
+    this->irqLine = -1;
+    this->haltLatched = false;
+    this->foreignFlush = false;
+    this->hostStartTime = 0;
+    this->lastBlock = NULL;
+    this->lastBlockEpoch = 0;
     Processor_leon3_funclt::numInstances++;
     // Initialization of the array holding the initial instance of the instructions
     this->INSTRUCTIONS = new Instruction *[145];
@@ -716,8 +1078,8 @@ leon3_funclt_trap::Processor_leon3_funclt::Processor_leon3_funclt(
         ASR, FP, LR, SP, PCR, REGS, instrMem, dataMem, irqAck);
     this->IRQ_irqInstr = new IRQ_IRQ_Instruction(PSR, WIM, TBR, Y, PC, NPC, GLOBAL, WINREGS, \
         ASR, FP, LR, SP, PCR, REGS, instrMem, dataMem, irqAck, this->IRQ);
-    this->quantKeeper.set_global_quantum( this->latency*100);
-    this->quantKeeper.reset();
+    this->quantKeeper.setQuantum(this->latency*100, this->latency*100, false);
+    this->quantKeeper.setMemory(this->mem);
     // Initialization of the standard registers
     // Initialization of the register banks
     this->GLOBAL.setSize(8);
@@ -738,30 +1100,31 @@ leon3_funclt_trap::Processor_leon3_funclt::Processor_leon3_funclt(
     this->REGS[5].updateAlias(this->GLOBAL[5]);
     this->REGS[6].updateAlias(this->GLOBAL[6]);
     this->REGS[7].updateAlias(this->GLOBAL[7]);
-    this->REGS[8].updateAlias(this->WINREGS[0]);
-    this->REGS[9].updateAlias(this->WINREGS[1]);
-    this->REGS[10].updateAlias(this->WINREGS[2]);
-    this->REGS[11].updateAlias(this->WINREGS[3]);
-    this->REGS[12].updateAlias(this->WINREGS[4]);
-    this->REGS[13].updateAlias(this->WINREGS[5]);
-    this->REGS[14].updateAlias(this->WINREGS[6]);
-    this->REGS[15].updateAlias(this->WINREGS[7]);
-    this->REGS[16].updateAlias(this->WINREGS[8]);
-    this->REGS[17].updateAlias(this->WINREGS[9]);
-    this->REGS[18].updateAlias(this->WINREGS[10]);
-    this->REGS[19].updateAlias(this->WINREGS[11]);
-    this->REGS[20].updateAlias(this->WINREGS[12]);
-    this->REGS[21].updateAlias(this->WINREGS[13]);
-    this->REGS[22].updateAlias(this->WINREGS[14]);
-    this->REGS[23].updateAlias(this->WINREGS[15]);
-    this->REGS[24].updateAlias(this->WINREGS[16]);
-    this->REGS[25].updateAlias(this->WINREGS[17]);
-    this->REGS[26].updateAlias(this->WINREGS[18]);
-    this->REGS[27].updateAlias(this->WINREGS[19]);
-    this->REGS[28].updateAlias(this->WINREGS[20]);
-    this->REGS[29].updateAlias(this->WINREGS[21]);
-    this->REGS[30].updateAlias(this->WINREGS[22]);
-    this->REGS[31].updateAlias(this->WINREGS[23]);
+    this->regWindow.setRegisters(this->WINREGS, 128);
+    this->REGS[8].updateAlias(this->regWindow, 0);
+    this->REGS[9].updateAlias(this->regWindow, 1);
+    this->REGS[10].updateAlias(this->regWindow, 2);
+    this->REGS[11].updateAlias(this->regWindow, 3);
+    this->REGS[12].updateAlias(this->regWindow, 4);
+    this->REGS[13].updateAlias(this->regWindow, 5);
+    this->REGS[14].updateAlias(this->regWindow, 6);
+    this->REGS[15].updateAlias(this->regWindow, 7);
+    this->REGS[16].updateAlias(this->regWindow, 8);
+    this->REGS[17].updateAlias(this->regWindow, 9);
+    this->REGS[18].updateAlias(this->regWindow, 10);
+    this->REGS[19].updateAlias(this->regWindow, 11);
+    this->REGS[20].updateAlias(this->regWindow, 12);
+    this->REGS[21].updateAlias(this->regWindow, 13);
+    this->REGS[22].updateAlias(this->regWindow, 14);
+    this->REGS[23].updateAlias(this->regWindow, 15);
+    this->REGS[24].updateAlias(this->regWindow, 16);
+    this->REGS[25].updateAlias(this->regWindow, 17);
+    this->REGS[26].updateAlias(this->regWindow, 18);
+    this->REGS[27].updateAlias(this->regWindow, 19);
+    this->REGS[28].updateAlias(this->regWindow, 20);
+    this->REGS[29].updateAlias(this->regWindow, 21);
+    this->REGS[30].updateAlias(this->regWindow, 22);
+    this->REGS[31].updateAlias(this->regWindow, 23);
     this->FP.updateAlias(this->REGS[30], 0);
     this->LR.updateAlias(this->REGS[31], 0);
     this->PCR.updateAlias(this->ASR[17], 0);
@@ -796,6 +1159,8 @@ leon3_funclt_trap::Processor_leon3_funclt::Processor_leon3_funclt(
 leon3_funclt_trap::Processor_leon3_funclt::~Processor_leon3_funclt(){
 
     GC_UNREGISTER_CALLBACKS();
+    // The worker thread may still be issuing on the state torn down here
+    this->worker.shutdown();
 
     Processor_leon3_funclt::numInstances--;
     for(int i = 0; i < 145; i++){
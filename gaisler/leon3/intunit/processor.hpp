@@ -42,9 +42,12 @@
 #include "core/common/trapgen/utils/customExceptions.hpp"
 #include "gaisler/leon3/intunit/instructions.hpp"
 #include "gaisler/leon3/intunit/decoder.hpp"
+#include "gaisler/leon3/intunit/blockcache.hpp"
+#include "gaisler/leon3/intunit/predecode.hpp"
+#include "gaisler/leon3/intunit/quantumworker.hpp"
+#include "gaisler/leon3/intunit/quantumkeeper.hpp"
 #include "gaisler/leon3/intunit/interface.hpp"
 #include "core/common/trapgen/ToolsIf.hpp"
-#include <tlm_utils/tlm_quantumkeeper.h>
 #include "gaisler/leon3/intunit/registers.hpp"
 #include "gaisler/leon3/intunit/alias.hpp"
 #include "gaisler/leon3/intunit/memory.hpp"
@@ -57,6 +60,7 @@
 #include "gaisler/leon3/intunit/irqPorts.hpp"
 #include "gaisler/leon3/intunit/externalPins.hpp"
 #include <string>
+#include <vector>
 #include "core/common/systemc.h"
 
 #define FUNC_MODEL
@@ -80,8 +84,45 @@ namespace leon3_funclt_trap{
         unsigned int raisedExceptionPC;
         unsigned int raisedExceptionNPC;
         vmap<unsigned int, CacheElem> instrCache;
+        PredecodeTable predecode;
+        BlockCache blockCache;
+        BasicBlock *lastBlock;
+        unsigned int lastBlockEpoch;
+        BasicBlock * translateBlock( unsigned int pc, unsigned int asi );
+        unsigned int executeBlock( unsigned int & numCycles );
+        /// Returns the decoded instruction at pc; fetched is set if it had to
+        /// be read from memory, which times the fetch
+        Instruction * fetchDecoded( unsigned int pc, unsigned int asi, unsigned int & bitString, bool & fetched );
+        /// Times the fetch of a decoded instruction which was not read from
+        /// memory: returns the cycle of an icache hit, or carries the fetch
+        /// out (and returns 0) if it would miss
+        unsigned int fetchDecodedHit( unsigned int pc, unsigned int asi );
+        unsigned int issueInstruction( unsigned int & numCycles );
+        /// Calls the tools; on the worker thread the tools which need an
+        /// empty pipeline are called from the SystemC process
+        inline bool issueTools( const unsigned int & curPC, const Instruction * curInstr ) throw(){
+            if(this->worker.forwarding() && this->toolManager.emptyPipeline(curPC)){
+                return this->worker.newIssue(curPC, curInstr);
+            }
+            return this->toolManager.newIssue(curPC, curInstr);
+        }
+        /// True if the pending interrupt can be taken
+        inline bool irqPending() const throw(){
+            return (IRQ != 0xFFFFFFFF) && (PSR.field<key_ET>() && (IRQ == 15 || IRQ > PSR.field<key_PIL>()));
+        }
         static int numInstances;
+        /// Interrupt request as seen by the instructions
         unsigned int IRQ;
+        /// Interrupt request line driven by the interrupt controller
+        unsigned int irqLine;
+        /// Halt request as seen by the worker thread
+        bool haltLatched;
+        /// Code ranges written by other masters while the worker was issuing
+        std::vector< std::pair< unsigned int, unsigned int > > foreignWrites;
+        /// Set if all code has to be dropped once the worker stops issuing
+        bool foreignFlush;
+        /// Host time at the start of the simulation in microseconds
+        unsigned long long hostStartTime;
 
       public:
         GC_HAS_CALLBACKS();
@@ -93,7 +134,20 @@ namespace leon3_funclt_trap{
         void end_of_simulation();
         void power_model();
         void triggerException(unsigned int exception);
-        tlm_utils::tlm_quantumkeeper quantKeeper;
+        void invalidateCode( unsigned int address, unsigned int length );
+        /// Invalidates code written by another bus master; deferred while the
+        /// worker thread is issuing
+        void invalidateForeignCode( unsigned int address, unsigned int length );
+        /// Drops all code after a write of another bus master which cannot be
+        /// mapped to code addresses; deferred while the worker is issuing
+        void flushForeignCode();
+        void flushCode();
+        /// Issues the instructions of one quantum; runs on the worker thread
+        unsigned int issueQuantum();
+        /// Takes over interrupt and halt requests and code invalidations which
+        /// arrived from the SystemC side; the worker thread must not be issuing
+        void latchExternal();
+        AdaptiveQuantumKeeper quantKeeper;
         gs::cnf::callback_return_type sta_power_cb(gs::gs_param_base& changed_param, gs::cnf::callback_type reason);
         gs::cnf::callback_return_type int_power_cb(gs::gs_param_base& changed_param, gs::cnf::callback_type reason);
         gs::cnf::callback_return_type swi_power_cb(gs::gs_param_base& changed_param, gs::cnf::callback_type reason);
@@ -111,15 +165,20 @@ namespace leon3_funclt_trap{
         RegisterBankClass GLOBAL;
         Reg32_3 WINREGS[128];
         Reg32_3 ASR[32];
+        RegisterWindow regWindow;
         Alias FP;
         Alias LR;
         Alias SP;
         Alias PCR;
         Alias REGS[32];
         MemoryInterface *mem;
+        QuantumWorker worker;
         MemoryInterface &instrMem;
         MemoryInterface &dataMem;
         sc_time latency;
+        /// Period at which a halted core keeps issuing to the tools, so that
+        /// an attached debugger can break in; zero lets it sleep until woken
+        sc_time haltPoll;
         sc_time profTimeStart;
         sc_time profTimeEnd;
         unsigned int undumpedHistElems;
@@ -131,6 +190,14 @@ namespace leon3_funclt_trap{
         IntrTLMPort_32 IRQ_port;
         PinTLM_out_32 irqAck;
         sr_param<bool> historyEnabled;
+        sr_param<bool> blockCacheEnabled;
+        sr_param<bool> predecodeEnabled;
+        sr_param<bool> parallelEnabled;
+        /// Quantum in clock cycles of the core
+        sr_param<unsigned int> quantumCycles;
+        /// Upper bound of the adaptive quantum in clock cycles
+        sr_param<unsigned int> maxQuantumCycles;
+        sr_param<bool> adaptiveQuantum;
         bool m_pow_mon;
         void setProfilingRange( unsigned int startAddr, unsigned int endAddr );
         IRQ_IRQ_Instruction * IRQ_irqInstr;
@@ -0,0 +1,88 @@
+/***************************************************************************\
+ *
+ *
+ *         _/        _/_/_/_/    _/_/    _/      _/   _/_/_/
+ *        _/        _/        _/    _/  _/_/    _/         _/
+ *       _/        _/_/_/    _/    _/  _/  _/  _/     _/_/
+ *      _/        _/        _/    _/  _/    _/_/         _/
+ *     _/_/_/_/  _/_/_/_/    _/_/    _/      _/   _/_/_/
+ *
+ *
+ *
+ *
+ *   This file is part of LEON3.
+ *
+ *   LEON3 is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the
+ *   Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *   or see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *
+ *   (c) 2026 agent
+ *
+\***************************************************************************/
+
+
+
+
+#include "gaisler/leon3/intunit/quantumkeeper.hpp"
+
+using namespace leon3_funclt_trap;
+leon3_funclt_trap::AdaptiveQuantumKeeper::AdaptiveQuantumKeeper() : syncs(0), \
+    memory(NULL), baseQuantum(SC_ZERO_TIME), maxQuantum(SC_ZERO_TIME), curQuantum(SC_ZERO_TIME), \
+    kernelTime(SC_ZERO_TIME), adaptive(false), disturbed(false){
+
+}
+
+void leon3_funclt_trap::AdaptiveQuantumKeeper::setQuantum( const sc_time & quantum, \
+    const sc_time & maxQuantum, bool adaptive ){
+    this->baseQuantum = quantum;
+    this->maxQuantum = (maxQuantum > quantum)? maxQuantum : quantum;
+    this->curQuantum = quantum;
+    this->adaptive = adaptive;
+    this->disturbed = false;
+    this->reset();
+}
+
+void leon3_funclt_trap::AdaptiveQuantumKeeper::sync(){
+    this->syncs++;
+    // Other masters must see the stores of the quantum
+    if(this->memory != NULL){
+        this->memory->drain_writes();
+    }
+    if(this->adaptive){
+        if(this->disturbed){
+            this->curQuantum = this->baseQuantum;
+        } else if(this->curQuantum < this->maxQuantum){
+            this->curQuantum = this->curQuantum*2;
+            if(this->curQuantum > this->maxQuantum){
+                this->curQuantum = this->maxQuantum;
+            }
+        }
+        this->disturbed = false;
+    }
+    // Waits for the local time and computes the next synchronization point
+    tlm_utils::tlm_quantumkeeper::sync();
+}
+
+sc_time leon3_funclt_trap::AdaptiveQuantumKeeper::compute_local_quantum(){
+    if(this->curQuantum == SC_ZERO_TIME){
+        return tlm_utils::tlm_quantumkeeper::compute_local_quantum();
+    }
+    // Synchronization points stay aligned to the configured quantum, so
+    // that the cores meet at the same points in time
+    sc_time current = sc_time_stamp();
+    return this->curQuantum - (current % this->baseQuantum);
+}
@@ -0,0 +1,108 @@
+/***************************************************************************\
+ *
+ *
+ *         _/        _/_/_/_/    _/_/    _/      _/   _/_/_/
+ *        _/        _/        _/    _/  _/_/    _/         _/
+ *       _/        _/_/_/    _/    _/  _/  _/  _/     _/_/
+ *      _/        _/        _/    _/  _/    _/_/         _/
+ *     _/_/_/_/  _/_/_/_/    _/_/    _/      _/   _/_/_/
+ *
+ *
+ *
+ *
+ *   This file is part of LEON3.
+ *
+ *   LEON3 is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the
+ *   Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *   or see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *
+ *   (c) 2026 agent
+ *
+\***************************************************************************/
+
+
+#ifndef LT_QUANTUMKEEPER_HPP
+#define LT_QUANTUMKEEPER_HPP
+
+#include <tlm_utils/tlm_quantumkeeper.h>
+#include "gaisler/leon3/intunit/memory.hpp"
+#include "core/common/systemc.h"
+
+#define FUNC_MODEL
+#define LT_IF
+namespace leon3_funclt_trap{
+
+    /// Quantum keeper of the core with a quantum of its own instead of the
+    /// TLM global quantum. In adaptive mode the quantum is doubled at every
+    /// synchronization which saw no interrupt and no snoop, up to a maximum,
+    /// and falls back to the configured quantum as soon as one of them is
+    /// reported through disturb(). The keeper counts the synchronizations
+    /// and drains the stores held back by the memory before each of them.
+    class AdaptiveQuantumKeeper : public tlm_utils::tlm_quantumkeeper{
+
+        public:
+        AdaptiveQuantumKeeper();
+        /// Sets the configured and the maximum quantum; the maximum is only
+        /// used in adaptive mode
+        void setQuantum( const sc_time & quantum, const sc_time & maxQuantum, bool adaptive );
+        /// Sets the memory whose stores are drained at synchronization
+        inline void setMemory( MemoryInterface * memory ) throw(){
+            this->memory = memory;
+        }
+        /// Reports an interrupt or shared memory traffic; the next quantum
+        /// is the configured one again
+        inline void disturb() throw(){
+            this->disturbed = true;
+        }
+        /// Current width of the quantum
+        inline const sc_time & getQuantum() const throw(){
+            return this->curQuantum;
+        }
+        /// Latches the kernel time for the worker thread, which must not
+        /// read it; called by the SystemC process
+        inline void latchTime() throw(){
+            this->kernelTime = sc_time_stamp();
+        }
+        /// Kernel time as of the last latchTime()
+        inline const sc_time & getLatchedTime() const throw(){
+            return this->kernelTime;
+        }
+        /// need_sync() against the latched kernel time
+        inline bool needSyncLatched() const throw(){
+            return this->kernelTime + this->m_local_time >= this->m_next_sync_point;
+        }
+        void sync();
+        /// Number of synchronizations with the SystemC kernel
+        unsigned long long syncs;
+
+        protected:
+        sc_time compute_local_quantum();
+
+        private:
+        MemoryInterface * memory;
+        sc_time baseQuantum;
+        sc_time maxQuantum;
+        sc_time curQuantum;
+        sc_time kernelTime;
+        bool adaptive;
+        bool disturbed;
+    };
+
+};
+
+#undef LT_IF
+#endif
@@ -0,0 +1,566 @@
+/***************************************************************************\
+ *
+ *
+ *         _/        _/_/_/_/    _/_/    _/      _/   _/_/_/
+ *        _/        _/        _/    _/  _/_/    _/         _/
+ *       _/        _/_/_/    _/    _/  _/  _/  _/     _/_/
+ *      _/        _/        _/    _/  _/    _/_/         _/
+ *     _/_/_/_/  _/_/_/_/    _/_/    _/      _/   _/_/_/
+ *
+ *
+ *
+ *
+ *   This file is part of LEON3.
+ *
+ *   LEON3 is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the
+ *   Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *   or see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *
+ *   (c) 2026 agent
+ *
+\***************************************************************************/
+
+
+
+
+#include "gaisler/leon3/intunit/quantumworker.hpp"
+#include "gaisler/leon3/intunit/processor.hpp"
+
+using namespace leon3_funclt_trap;
+boost::mutex leon3_funclt_trap::QuantumWorker::mutex;
+boost::condition_variable leon3_funclt_trap::QuantumWorker::posted;
+unsigned int leon3_funclt_trap::QuantumWorker::active = 0;
+std::vector< QuantumWorker * > leon3_funclt_trap::QuantumWorker::workers;
+sc_core::sc_event * leon3_funclt_trap::QuantumWorker::served = NULL;
+
+leon3_funclt_trap::QuantumWorker::QuantumWorker( Processor_leon3_funclt & processor, \
+    MemoryInterface * memory ) : quanta(0), requests(0), postedStores(0), processor(processor), \
+    memory(*memory), thread(NULL), state(IDLE), executed(0), isRunning(false), isServing(false){
+    if(QuantumWorker::served == NULL){
+        QuantumWorker::served = new sc_core::sc_event();
+    }
+    // The cores are built in the order of their numbers
+    QuantumWorker::workers.push_back(this);
+}
+
+leon3_funclt_trap::QuantumWorker::~QuantumWorker(){
+    this->shutdown();
+    boost::lock_guard< boost::mutex > lock(QuantumWorker::mutex);
+    for(std::vector< QuantumWorker * >::iterator it = QuantumWorker::workers.begin(); \
+        it != QuantumWorker::workers.end(); it++){
+        if(*it == this){
+            QuantumWorker::workers.erase(it);
+            break;
+        }
+    }
+}
+
+void leon3_funclt_trap::QuantumWorker::shutdown(){
+    if(this->thread == NULL){
+        return;
+    }
+    {
+        boost::lock_guard< boost::mutex > lock(QuantumWorker::mutex);
+        if(this->state == RUN){
+            QuantumWorker::active--;
+        }
+        this->state = SHUTDOWN;
+    }
+    this->cond.notify_all();
+    this->thread->join();
+    delete this->thread;
+    this->thread = NULL;
+}
+
+unsigned int leon3_funclt_trap::QuantumWorker::runQuantum(){
+    if(this->thread == NULL){
+        this->thread = new boost::thread(&QuantumWorker::threadMain, this);
+    }
+    this->processor.latchExternal();
+    this->isRunning = true;
+    {
+        boost::lock_guard< boost::mutex > lock(QuantumWorker::mutex);
+        this->state = READY;
+    }
+
+    // Let the other cores whose quanta start now join the round
+    sc_core::wait(sc_core::SC_ZERO_TIME);
+
+    // Whenever a worker runs, the SystemC thread stays blocked in here
+    boost::unique_lock< boost::mutex > lock(QuantumWorker::mutex);
+    while(true){
+        if(QuantumWorker::active != 0){
+            QuantumWorker::posted.wait(lock);
+            continue;
+        }
+        QuantumWorker * next = QuantumWorker::nextRequest();
+        if(next == this){
+            this->state = SERVING;
+            lock.unlock();
+            this->serve();
+            QuantumWorker::served->notify(sc_core::SC_ZERO_TIME);
+            lock.lock();
+            this->state = SERVED;
+        } else if(next != NULL){
+            // Accesses of cores with lower numbers go first
+            bool busy = next->state == SERVING;
+            lock.unlock();
+            if(busy){
+                sc_core::wait(*QuantumWorker::served);
+            } else {
+                sc_core::wait(sc_core::SC_ZERO_TIME);
+            }
+            lock.lock();
+        } else if(this->state == DONE){
+            break;
+        } else {
+            QuantumWorker::resume();
+        }
+    }
+    this->state = IDLE;
+    lock.unlock();
+    this->isRunning = false;
+    this->quanta++;
+    return this->executed;
+}
+
+QuantumWorker * leon3_funclt_trap::QuantumWorker::nextRequest(){
+    for(std::vector< QuantumWorker * >::iterator it = QuantumWorker::workers.begin(); \
+        it != QuantumWorker::workers.end(); it++){
+        if((*it)->state == REQUEST || (*it)->state == SERVING){
+            return *it;
+        }
+    }
+    return NULL;
+}
+
+void leon3_funclt_trap::QuantumWorker::resume(){
+    for(std::vector< QuantumWorker * >::iterator it = QuantumWorker::workers.begin(); \
+        it != QuantumWorker::workers.end(); it++){
+        if((*it)->state == READY || (*it)->state == SERVED){
+            (*it)->state = RUN;
+            QuantumWorker::active++;
+            (*it)->cond.notify_all();
+        }
+    }
+}
+
+void leon3_funclt_trap::QuantumWorker::threadMain(){
+    boost::unique_lock< boost::mutex > lock(QuantumWorker::mutex);
+    while(true){
+        while(this->state != RUN && this->state != SHUTDOWN){
+            this->cond.wait(lock);
+        }
+        if(this->state == SHUTDOWN){
+            return;
+        }
+        lock.unlock();
+        unsigned int executed = this->processor.issueQuantum();
+        if(!this->stores.empty()){
+            // The stores of a quantum are done when it ends
+            this->call(DRAIN, 0);
+        }
+        lock.lock();
+        if(this->state == SHUTDOWN){
+            return;
+        }
+        this->executed = executed;
+        this->state = DONE;
+        QuantumWorker::active--;
+        QuantumWorker::posted.notify_all();
+    }
+}
+
+sc_dt::uint64 leon3_funclt_trap::QuantumWorker::call( Operation op, unsigned int address, \
+    sc_dt::uint64 datum, unsigned int asi, unsigned int flush, unsigned int lock, const \
+    InstructionBase * instr ) throw(){
+    boost::unique_lock< boost::mutex > guard(QuantumWorker::mutex);
+    if(this->state == SHUTDOWN){
+        // Nobody is left to serve the request
+        return 0;
+    }
+    this->request.op = op;
+    this->request.address = address;
+    this->request.datum = datum;
+    this->request.asi = asi;
+    this->request.flush = flush;
+    this->request.lock = lock;
+    this->request.instr = instr;
+    this->state = REQUEST;
+    QuantumWorker::active--;
+    QuantumWorker::posted.notify_all();
+    while(this->state != RUN && this->state != SHUTDOWN){
+        this->cond.wait(guard);
+    }
+    return (this->state == SHUTDOWN)? 0 : this->request.datum;
+}
+
+void leon3_funclt_trap::QuantumWorker::drain() throw(){
+    for(std::vector< Request >::iterator r = this->stores.begin(); r != this->stores.end(); r++){
+        switch(r->op){
+            case WRITE_DWORD:{
+                this->memory.write_dword(r->address, r->datum, r->asi, r->flush, r->lock);
+            }break;
+            case WRITE_WORD:{
+                this->memory.write_word(r->address, (unsigned int)r->datum, r->asi, r->flush, r->lock);
+            }break;
+            case WRITE_HALF:{
+                this->memory.write_half(r->address, (unsigned short int)r->datum, r->asi, r->flush, r->lock);
+            }break;
+            default:{
+                this->memory.write_byte(r->address, (unsigned char)r->datum, r->asi, r->flush, r->lock);
+            }break;
+        }
+    }
+    this->stores.clear();
+}
+
+void leon3_funclt_trap::QuantumWorker::serve() throw(){
+    Request & r = this->request;
+    this->isServing = true;
+    // Queued stores go before any later access of the core
+    this->drain();
+    switch(r.op){
+        case READ_DWORD:{
+            r.datum = this->memory.read_dword(r.address, r.asi, r.flush, r.lock);
+        }break;
+        case READ_WORD:{
+            r.datum = this->memory.read_word(r.address, r.asi, r.flush, r.lock);
+        }break;
+        case READ_HALF:{
+            r.datum = this->memory.read_half(r.address, r.asi, r.flush, r.lock);
+        }break;
+        case READ_BYTE:{
+            r.datum = this->memory.read_byte(r.address, r.asi, r.flush, r.lock);
+        }break;
+        case READ_INSTR:{
+            r.datum = this->memory.read_instr(r.address, r.asi, r.flush);
+        }break;
+        case READ_DWORD_DBG:{
+            r.datum = this->memory.read_dword_dbg(r.address);
+        }break;
+        case READ_WORD_DBG:{
+            r.datum = this->memory.read_word_dbg(r.address);
+        }break;
+        case READ_HALF_DBG:{
+            r.datum = this->memory.read_half_dbg(r.address);
+        }break;
+        case READ_BYTE_DBG:{
+            r.datum = this->memory.read_byte_dbg(r.address);
+        }break;
+        case WRITE_DWORD:{
+            this->memory.write_dword(r.address, r.datum, r.asi, r.flush, r.lock);
+        }break;
+        case WRITE_WORD:{
+            this->memory.write_word(r.address, (unsigned int)r.datum, r.asi, r.flush, r.lock);
+        }break;
+        case WRITE_HALF:{
+            this->memory.write_half(r.address, (unsigned short int)r.datum, r.asi, r.flush, r.lock);
+        }break;
+        case WRITE_BYTE:{
+            this->memory.write_byte(r.address, (unsigned char)r.datum, r.asi, r.flush, r.lock);
+        }break;
+        case WRITE_DWORD_DBG:{
+            this->memory.write_dword_dbg(r.address, r.datum);
+        }break;
+        case WRITE_WORD_DBG:{
+            this->memory.write_word_dbg(r.address, (unsigned int)r.datum);
+        }break;
+        case WRITE_HALF_DBG:{
+            this->memory.write_half_dbg(r.address, (unsigned short int)r.datum);
+        }break;
+        case WRITE_BYTE_DBG:{
+            this->memory.write_byte_dbg(r.address, (unsigned char)r.datum);
+        }break;
+        case LOCK:{
+            this->memory.lock();
+        }break;
+        case UNLOCK:{
+            this->memory.unlock();
+        }break;
+        case FLUSH_INSTR:{
+            this->memory.flush_instr(r.address);
+        }break;
+        case NEW_ISSUE:{
+            r.datum = this->processor.toolManager.newIssue(r.address, r.instr);
+        }break;
+        case DRAIN:{
+        }break;
+    }
+    // Whatever happened on the bus meanwhile becomes visible to the worker
+    // right after its own access, like it would after a synchronization
+    this->processor.latchExternal();
+    this->isServing = false;
+    this->requests++;
+}
+
+bool leon3_funclt_trap::QuantumWorker::readLocal( unsigned int address, unsigned int asi, \
+    unsigned int length, unsigned int flush, unsigned int lock, sc_dt::uint64 & datum ) throw(){
+    if(flush || lock){
+        return false;
+    }
+    for(std::vector< Request >::const_iterator r = this->stores.begin(); r != this->stores.end(); r++){
+        unsigned int size = (r->op == WRITE_DWORD)? 8 : (r->op == WRITE_WORD)? 4 : \
+            (r->op == WRITE_HALF)? 2 : 1;
+        if(r->address < address + length && address < r->address + size){
+            // The load has to see the store
+            return false;
+        }
+    }
+    return this->memory.read_data_local(address, asi, length, datum);
+}
+
+bool leon3_funclt_trap::QuantumWorker::writeLocal( Operation op, unsigned int address, \
+    sc_dt::uint64 datum, unsigned int asi, unsigned int flush, unsigned int lock ) throw(){
+    if(flush || lock || this->stores.size() >= QuantumWorker::MAX_STORES || \
+        !this->memory.write_postable(address, asi)){
+        return false;
+    }
+    Request r;
+    r.op = op;
+    r.address = address;
+    r.datum = datum;
+    r.asi = asi;
+    r.flush = flush;
+    r.lock = lock;
+    r.instr = NULL;
+    this->stores.push_back(r);
+    this->postedStores++;
+    return true;
+}
+
+bool leon3_funclt_trap::QuantumWorker::newIssue( const unsigned int & curPC, const \
+    InstructionBase * curInstr ) throw(){
+    return this->call(NEW_ISSUE, curPC, 0, 0, 0, 0, curInstr) != 0;
+}
+
+sc_dt::uint64 leon3_funclt_trap::QuantumWorker::read_dword( const unsigned int & address, \
+    const unsigned int asi, const unsigned int flush, const unsigned int lock ) throw(){
+    if(this->forwarding()){
+        sc_dt::uint64 datum = 0;
+        if(this->readLocal(address, asi, 8, flush, lock, datum)){
+            return datum;
+        }
+        return this->call(READ_DWORD, address, 0, asi, flush, lock);
+    }
+    return this->memory.read_dword(address, asi, flush, lock);
+}
+
+unsigned int leon3_funclt_trap::QuantumWorker::read_word( const unsigned int & address, \
+    const unsigned int asi, const unsigned int flush, const unsigned int lock ) throw(){
+    if(this->forwarding()){
+        sc_dt::uint64 datum = 0;
+        if(this->readLocal(address, asi, 4, flush, lock, datum)){
+            return (unsigned int)datum;
+        }
+        return (unsigned int)this->call(READ_WORD, address, 0, asi, flush, lock);
+    }
+    return this->memory.read_word(address, asi, flush, lock);
+}
+
+unsigned short int leon3_funclt_trap::QuantumWorker::read_half( const unsigned int & \
+    address, const unsigned int asi, const unsigned int flush, const unsigned int lock ) \
+    throw(){
+    if(this->forwarding()){
+        sc_dt::uint64 datum = 0;
+        if(this->readLocal(address, asi, 2, flush, lock, datum)){
+            return (unsigned short int)datum;
+        }
+        return (unsigned short int)this->call(READ_HALF, address, 0, asi, flush, lock);
+    }
+    return this->memory.read_half(address, asi, flush, lock);
+}
+
+unsigned char leon3_funclt_trap::QuantumWorker::read_byte( const unsigned int & address, \
+    const unsigned int asi, const unsigned int flush, const unsigned int lock ) throw(){
+    if(this->forwarding()){
+        sc_dt::uint64 datum = 0;
+        if(this->readLocal(address, asi, 1, flush, lock, datum)){
+            return (unsigned char)datum;
+        }
+        return (unsigned char)this->call(READ_BYTE, address, 0, asi, flush, lock);
+    }
+    return this->memory.read_byte(address, asi, flush, lock);
+}
+
+unsigned int leon3_funclt_trap::QuantumWorker::read_instr( const unsigned int & address, \
+    const unsigned int asi, const unsigned int flush ) throw(){
+    if(this->forwarding()){
+        // Fetches which do not leave the core stay on the worker thread
+        unsigned int datum = 0;
+        if(!flush && this->memory.read_instr_local(address, asi, datum)){
+            return datum;
+        }
+        return (unsigned int)this->call(READ_INSTR, address, 0, asi, flush);
+    }
+    return this->memory.read_instr(address, asi, flush);
+}
+
+bool leon3_funclt_trap::QuantumWorker::read_instr_local( const unsigned int & address, \
+    const unsigned int asi, unsigned int & datum ) throw(){
+    return this->memory.read_instr_local(address, asi, datum);
+}
+
+bool leon3_funclt_trap::QuantumWorker::read_instr_hit( const unsigned int & address, \
+    const unsigned int asi ) throw(){
+    // Only touches the icache of the core
+    return this->memory.read_instr_hit(address, asi);
+}
+
+sc_dt::uint64 leon3_funclt_trap::QuantumWorker::read_dword_dbg( const unsigned int & \
+    address ) throw(){
+    if(this->forwarding()){
+        return this->call(READ_DWORD_DBG, address);
+    }
+    return this->memory.read_dword_dbg(address);
+}
+
+unsigned int leon3_funclt_trap::QuantumWorker::read_word_dbg( const unsigned int & address \
+    ) throw(){
+    if(this->forwarding()){
+        return (unsigned int)this->call(READ_WORD_DBG, address);
+    }
+    return this->memory.read_word_dbg(address);
+}
+
+unsigned short int leon3_funclt_trap::QuantumWorker::read_half_dbg( const unsigned int & \
+    address ) throw(){
+    if(this->forwarding()){
+        return (unsigned short int)this->call(READ_HALF_DBG, address);
+    }
+    return this->memory.read_half_dbg(address);
+}
+
+unsigned char leon3_funclt_trap::QuantumWorker::read_byte_dbg( const unsigned int & address \
+    ) throw(){
+    if(this->forwarding()){
+        return (unsigned char)this->call(READ_BYTE_DBG, address);
+    }
+    return this->memory.read_byte_dbg(address);
+}
+
+void leon3_funclt_trap::QuantumWorker::write_dword( const unsigned int & address, \
+    sc_dt::uint64 datum, const unsigned int asi, const unsigned int flush, const unsigned \
+    int lock ) throw(){
+    if(this->forwarding()){
+        if(this->writeLocal(WRITE_DWORD, address, datum, asi, flush, lock)){
+            return;
+        }
+        this->call(WRITE_DWORD, address, datum, asi, flush, lock);
+        return;
+    }
+    this->memory.write_dword(address, datum, asi, flush, lock);
+}
+
+void leon3_funclt_trap::QuantumWorker::write_word( const unsigned int & address, unsigned \
+    int datum, const unsigned int asi, const unsigned int flush, const unsigned int lock ) \
+    throw(){
+    if(this->forwarding()){
+        if(this->writeLocal(WRITE_WORD, address, datum, asi, flush, lock)){
+            return;
+        }
+        this->call(WRITE_WORD, address, datum, asi, flush, lock);
+        return;
+    }
+    this->memory.write_word(address, datum, asi, flush, lock);
+}
+
+void leon3_funclt_trap::QuantumWorker::write_half( const unsigned int & address, unsigned \
+    short int datum, const unsigned int asi, const unsigned int flush, const unsigned int \
+    lock ) throw(){
+    if(this->forwarding()){
+        if(this->writeLocal(WRITE_HALF, address, datum, asi, flush, lock)){
+            return;
+        }
+        this->call(WRITE_HALF, address, datum, asi, flush, lock);
+        return;
+    }
+    this->memory.write_half(address, datum, asi, flush, lock);
+}
+
+void leon3_funclt_trap::QuantumWorker::write_byte( const unsigned int & address, unsigned \
+    char datum, const unsigned int asi, const unsigned int flush, const unsigned int lock ) \
+    throw(){
+    if(this->forwarding()){
+        if(this->writeLocal(WRITE_BYTE, address, datum, asi, flush, lock)){
+            return;
+        }
+        this->call(WRITE_BYTE, address, datum, asi, flush, lock);
+        return;
+    }
+    this->memory.write_byte(address, datum, asi, flush, lock);
+}
+
+void leon3_funclt_trap::QuantumWorker::write_dword_dbg( const unsigned int & address, \
+    sc_dt::uint64 datum ) throw(){
+    if(this->forwarding()){
+        this->call(WRITE_DWORD_DBG, address, datum);
+        return;
+    }
+    this->memory.write_dword_dbg(address, datum);
+}
+
+void leon3_funclt_trap::QuantumWorker::write_word_dbg( const unsigned int & address, \
+    unsigned int datum ) throw(){
+    if(this->forwarding()){
+        this->call(WRITE_WORD_DBG, address, datum);
+        return;
+    }
+    this->memory.write_word_dbg(address, datum);
+}
+
+void leon3_funclt_trap::QuantumWorker::write_half_dbg( const unsigned int & address, \
+    unsigned short int datum ) throw(){
+    if(this->forwarding()){
+        this->call(WRITE_HALF_DBG, address, datum);
+        return;
+    }
+    this->memory.write_half_dbg(address, datum);
+}
+
+void leon3_funclt_trap::QuantumWorker::write_byte_dbg( const unsigned int & address, \
+    unsigned char datum ) throw(){
+    if(this->forwarding()){
+        this->call(WRITE_BYTE_DBG, address, datum);
+        return;
+    }
+    this->memory.write_byte_dbg(address, datum);
+}
+
+void leon3_funclt_trap::QuantumWorker::lock(){
+    if(this->forwarding()){
+        this->call(LOCK, 0);
+        return;
+    }
+    this->memory.lock();
+}
+
+void leon3_funclt_trap::QuantumWorker::unlock(){
+    if(this->forwarding()){
+        this->call(UNLOCK, 0);
+        return;
+    }
+    this->memory.unlock();
+}
+
+void leon3_funclt_trap::QuantumWorker::flush_instr( const unsigned int & address ) throw(){
+    if(this->forwarding()){
+        this->call(FLUSH_INSTR, address);
+        return;
+    }
+    this->memory.flush_instr(address);
+}
@@ -0,0 +1,202 @@
+/***************************************************************************\
+ *
+ *
+ *         _/        _/_/_/_/    _/_/    _/      _/   _/_/_/
+ *        _/        _/        _/    _/  _/_/    _/         _/
+ *       _/        _/_/_/    _/    _/  _/  _/  _/     _/_/
+ *      _/        _/        _/    _/  _/    _/_/         _/
+ *     _/_/_/_/  _/_/_/_/    _/_/    _/      _/   _/_/_/
+ *
+ *
+ *
+ *
+ *   This file is part of LEON3.
+ *
+ *   LEON3 is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the
+ *   Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *   or see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *
+ *   (c) 2026 agent
+ *
+\***************************************************************************/
+
+
+#ifndef LT_QUANTUMWORKER_HPP
+#define LT_QUANTUMWORKER_HPP
+
+#include "gaisler/leon3/intunit/memory.hpp"
+#include "core/common/trapgen/instructionBase.hpp"
+#include "core/common/systemc.h"
+#include <boost/thread/thread.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <vector>
+
+#define FUNC_MODEL
+#define LT_IF
+namespace leon3_funclt_trap{
+
+    class Processor_leon3_funclt;
+
+    /// Issues the instructions of one quantum on a host worker thread.
+    /// The worker only touches the state private to its core and never
+    /// calls into the SystemC kernel; the kernel time it needs is latched
+    /// by the SystemC process. Loads hitting in the data cache and fetches
+    /// hitting in the fetch line buffer are served on the worker. Stores
+    /// which need no address translation are queued and carried out later,
+    /// in order. Every
+    /// other access is handed back to the SystemC process of the core and
+    /// the worker waits for it.
+    /// The workers of all cores whose quanta start in the same delta cycle
+    /// run at the same time. While any worker runs, the SystemC thread is
+    /// blocked, so that neither simulated time nor other models (snooping
+    /// caches, peripherals) move. Once all of them wait for an access or
+    /// finished their quantum, the waiting accesses are served in the
+    /// order of the cores, each by the SystemC process of its core, which
+    /// may wait on the bus meanwhile. Then all served workers go on
+    /// together. Hence the results only depend on what the cores execute,
+    /// not on the speed of the host threads.
+    /// The worker sits between the core and its memory interface: as long
+    /// as no quantum is running on the host thread all accesses are passed
+    /// through.
+    class QuantumWorker : public MemoryInterface{
+
+        public:
+        QuantumWorker( Processor_leon3_funclt & processor, MemoryInterface * memory );
+        ~QuantumWorker();
+        /// Stops the worker thread and waits for it. A quantum cut short by
+        /// the end of the simulation runs to its end first, all accesses it
+        /// still hands out are dropped. Has to be called before the core or
+        /// its memory are torn down.
+        void shutdown();
+        /// Issues instructions on the worker thread until the end of the
+        /// quantum or until an interrupt can be taken; called by the SystemC
+        /// process of the core. Returns the number of issued instructions.
+        unsigned int runQuantum();
+        /// True while a quantum is issued on the worker thread
+        inline bool running() const throw(){
+            return this->isRunning;
+        }
+        /// True if an access has to be handed to the SystemC process
+        inline bool forwarding() const throw(){
+            return this->isRunning && !this->isServing;
+        }
+        /// Calls the tools of the core from the SystemC process
+        bool newIssue( const unsigned int & curPC, const InstructionBase * curInstr ) throw();
+        sc_dt::uint64 read_dword( const unsigned int & address, const unsigned int asi, const unsigned int flush, const unsigned int lock ) throw();
+        unsigned int read_word( const unsigned int & address, const unsigned int asi, const unsigned int flush, const unsigned int lock ) throw();
+        unsigned short int read_half( const unsigned int & address, const unsigned int asi, const unsigned int flush, const unsigned int lock ) throw();
+        unsigned char read_byte( const unsigned int & address, const unsigned int asi, const unsigned int flush, const unsigned int lock ) throw();
+        unsigned int read_instr( const unsigned int & address, const unsigned int asi, const unsigned int flush ) throw();
+        bool read_instr_local( const unsigned int & address, const unsigned int asi, unsigned int & datum ) throw();
+        bool read_instr_hit( const unsigned int & address, const unsigned int asi ) throw();
+        sc_dt::uint64 read_dword_dbg( const unsigned int & address ) throw();
+        unsigned int read_word_dbg( const unsigned int & address ) throw();
+        unsigned short int read_half_dbg( const unsigned int & address ) throw();
+        unsigned char read_byte_dbg( const unsigned int & address ) throw();
+        void write_dword( const unsigned int & address, sc_dt::uint64 datum, const unsigned int asi, const unsigned int flush, const unsigned int lock ) throw();
+        void write_word( const unsigned int & address, unsigned int datum, const unsigned int asi, const unsigned int flush, const unsigned int lock ) throw();
+        void write_half( const unsigned int & address, unsigned short int datum, const unsigned int asi, const unsigned int flush, const unsigned int lock ) throw();
+        void write_byte( const unsigned int & address, unsigned char datum, const unsigned int asi, const unsigned int flush, const unsigned int lock ) throw();
+        void write_dword_dbg( const unsigned int & address, sc_dt::uint64 datum ) throw();
+        void write_word_dbg( const unsigned int & address, unsigned int datum ) throw();
+        void write_half_dbg( const unsigned int & address, unsigned short int datum ) throw();
+        void write_byte_dbg( const unsigned int & address, unsigned char datum ) throw();
+        void lock();
+        void unlock();
+        void flush_instr( const unsigned int & address ) throw();
+        /// Number of quanta issued on the worker thread
+        unsigned long long quanta;
+        /// Number of requests served by the SystemC process
+        unsigned long long requests;
+        /// Number of stores queued by the worker
+        unsigned long long postedStores;
+
+        private:
+        /// READY: waits to be started with the next round of workers,
+        /// SERVING: access under way on the SystemC process,
+        /// SERVED: access done, waits for the others of the round
+        enum State{IDLE, READY, RUN, REQUEST, SERVING, SERVED, DONE, SHUTDOWN};
+        enum Operation{READ_DWORD, READ_WORD, READ_HALF, READ_BYTE, READ_INSTR, READ_DWORD_DBG, \
+            READ_WORD_DBG, READ_HALF_DBG, READ_BYTE_DBG, WRITE_DWORD, WRITE_WORD, WRITE_HALF, \
+            WRITE_BYTE, WRITE_DWORD_DBG, WRITE_WORD_DBG, WRITE_HALF_DBG, WRITE_BYTE_DBG, LOCK, \
+            UNLOCK, FLUSH_INSTR, NEW_ISSUE, DRAIN};
+        /// Largest number of queued stores
+        static const unsigned int MAX_STORES = 16;
+        /// Access handed from the worker to the SystemC process
+        struct Request{
+            Operation op;
+            unsigned int address;
+            sc_dt::uint64 datum;
+            unsigned int asi;
+            unsigned int flush;
+            unsigned int lock;
+            const InstructionBase * instr;
+        };
+        /// Hands request to the SystemC process and waits for the result
+        sc_dt::uint64 call( Operation op, unsigned int address, sc_dt::uint64 datum = 0, \
+            unsigned int asi = 0, unsigned int flush = 0, unsigned int lock = 0, \
+            const InstructionBase * instr = NULL ) throw();
+        /// Executes the pending request on the SystemC process
+        void serve() throw();
+        /// Carries out the queued stores on the SystemC process
+        void drain() throw();
+        /// Serves a load on the worker if it hits in the data cache and no
+        /// queued store overlaps it
+        bool readLocal( unsigned int address, unsigned int asi, unsigned int length, \
+            unsigned int flush, unsigned int lock, sc_dt::uint64 & datum ) throw();
+        /// Queues a store of the worker if it may be carried out later
+        bool writeLocal( Operation op, unsigned int address, sc_dt::uint64 datum, \
+            unsigned int asi, unsigned int flush, unsigned int lock ) throw();
+        /// Worker with the lowest core number whose access is pending or
+        /// under way (NULL if none); called with the mutex held
+        static QuantumWorker * nextRequest();
+        /// Lets the served workers go on and starts the ready ones; called
+        /// with the mutex held
+        static void resume();
+        /// Body of the host worker thread
+        void threadMain();
+        /// Guards the state of the workers of all cores
+        static boost::mutex mutex;
+        /// Notified whenever a worker posts a request or finishes a quantum
+        static boost::condition_variable posted;
+        /// Workers issuing instructions right now
+        static unsigned int active;
+        /// Notified when the access of a worker is done; created with the
+        /// first worker, i.e. during elaboration
+        static sc_core::sc_event * served;
+        /// Workers of all cores in the order of the cores
+        static std::vector< QuantumWorker * > workers;
+        Processor_leon3_funclt & processor;
+        MemoryInterface & memory;
+        boost::thread * thread;
+        /// Notified when the worker of this core may go on
+        boost::condition_variable cond;
+        State state;
+        Request request;
+        /// Stores queued by the worker, oldest first
+        std::vector< Request > stores;
+        unsigned int executed;
+        bool isRunning;
+        bool isServing;
+    };
+
+};
+
+
+
+#endif
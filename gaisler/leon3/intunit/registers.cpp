@@ -67,7 +67,12 @@ leon3_funclt_trap::Register::Register( const Register & other ) : sc_register<un
 
 }
 
+unsigned int * leon3_funclt_trap::Register::getStorage() throw(){
+    return NULL;
+}
+
 InnerField & leon3_funclt_trap::Reg32_0::InnerField_VER::operator =( const unsigned int & other) throw() {
+    static_cast< Reg32_0 * >(this->parent)->flushICC();
     this->m_cur_val &= 0xf0ffffffL;
     this->m_cur_val |= ((other & 0xf) << 24);
     parent->execute_callbacks(scireg_ns::SCIREG_WRITE_ACCESS);
@@ -82,6 +87,7 @@ leon3_funclt_trap::Reg32_0::InnerField_VER::~InnerField_VER(){
 }
 
 InnerField & leon3_funclt_trap::Reg32_0::InnerField_ICC_z::operator =( const unsigned int & other) throw() {
+    static_cast< Reg32_0 * >(this->parent)->flushICC();
     this->m_cur_val &= 0xffbfffffL;
     this->m_cur_val |= ((other & 0x1) << 22);
     parent->execute_callbacks(scireg_ns::SCIREG_WRITE_ACCESS);
@@ -95,6 +101,7 @@ leon3_funclt_trap::Reg32_0::InnerField_ICC_z::InnerField_ICC_z( unsigned int & v
 leon3_funclt_trap::Reg32_0::InnerField_ICC_z::~InnerField_ICC_z(){
 }
 InnerField & leon3_funclt_trap::Reg32_0::InnerField_ICC_v::operator =( const unsigned  int & other) throw() {
+    static_cast< Reg32_0 * >(this->parent)->flushICC();
     this->m_cur_val &= 0xffdfffffL;
     this->m_cur_val |= ((other & 0x1) << 21);
     parent->execute_callbacks(scireg_ns::SCIREG_WRITE_ACCESS);
@@ -109,6 +116,7 @@ leon3_funclt_trap::Reg32_0::InnerField_ICC_v::~InnerField_ICC_v() {
 }
 
 InnerField & leon3_funclt_trap::Reg32_0::InnerField_EF::operator =( const unsigned int & other ) throw() {
+    static_cast< Reg32_0 * >(this->parent)->flushICC();
     this->m_cur_val &= 0xffffefffL;
     this->m_cur_val |= ((other & 0x1) << 12);
     parent->execute_callbacks(scireg_ns::SCIREG_WRITE_ACCESS);
@@ -123,6 +131,7 @@ leon3_funclt_trap::Reg32_0::InnerField_EF::~InnerField_EF() {
 }
 
 InnerField & leon3_funclt_trap::Reg32_0::InnerField_EC::operator =( const unsigned  int & other) throw() {
+    static_cast< Reg32_0 * >(this->parent)->flushICC();
     this->m_cur_val &= 0xffffdfffL;
     this->m_cur_val |= ((other & 0x1) << 13);
     parent->execute_callbacks(scireg_ns::SCIREG_WRITE_ACCESS);
@@ -137,6 +146,7 @@ leon3_funclt_trap::Reg32_0::InnerField_EC::~InnerField_EC() {
 }
 
 InnerField & leon3_funclt_trap::Reg32_0::InnerField_ICC_n::operator =( const unsigned int & other) throw() {
+    static_cast< Reg32_0 * >(this->parent)->flushICC();
     this->m_cur_val &= 0xff7fffffL;
     this->m_cur_val |= ((other & 0x1) << 23);
     parent->execute_callbacks(scireg_ns::SCIREG_WRITE_ACCESS);
@@ -151,6 +161,7 @@ leon3_funclt_trap::Reg32_0::InnerField_ICC_n::~InnerField_ICC_n(){
 
 }
 InnerField & leon3_funclt_trap::Reg32_0::InnerField_S::operator =( const unsigned int & other ) throw() {
+    static_cast< Reg32_0 * >(this->parent)->flushICC();
     this->m_cur_val &= 0xffffff7fL;
     this->m_cur_val |= ((other & 0x1) << 7);
     parent->execute_callbacks(scireg_ns::SCIREG_WRITE_ACCESS);
@@ -165,6 +176,7 @@ leon3_funclt_trap::Reg32_0::InnerField_S::~InnerField_S() {
 }
 
 InnerField & leon3_funclt_trap::Reg32_0::InnerField_ET::operator =( const unsigned int & other ) throw() {
+    static_cast< Reg32_0 * >(this->parent)->flushICC();
     this->m_cur_val &= 0xffffffdfL;
     this->m_cur_val |= ((other & 0x1) << 5);
     parent->execute_callbacks(scireg_ns::SCIREG_WRITE_ACCESS);
@@ -179,6 +191,7 @@ leon3_funclt_trap::Reg32_0::InnerField_ET::~InnerField_ET() {
 }
 
 InnerField & leon3_funclt_trap::Reg32_0::InnerField_ICC_c::operator =( const unsigned int & other ) throw() {
+    static_cast< Reg32_0 * >(this->parent)->flushICC();
     this->m_cur_val &= 0xffefffffL;
     this->m_cur_val |= ((other & 0x1) << 20);
     parent->execute_callbacks(scireg_ns::SCIREG_WRITE_ACCESS);
@@ -193,6 +206,7 @@ leon3_funclt_trap::Reg32_0::InnerField_ICC_c::~InnerField_ICC_c() {
 }
 
 InnerField & leon3_funclt_trap::Reg32_0::InnerField_PS::operator =( const unsigned int & other ) throw() {
+    static_cast< Reg32_0 * >(this->parent)->flushICC();
     this->m_cur_val &= 0xffffffbfL;
     this->m_cur_val |= ((other & 0x1) << 6);
     parent->execute_callbacks(scireg_ns::SCIREG_WRITE_ACCESS);
@@ -207,6 +221,7 @@ leon3_funclt_trap::Reg32_0::InnerField_PS::~InnerField_PS() {
 }
 
 InnerField & leon3_funclt_trap::Reg32_0::InnerField_PIL::operator =( const unsigned int & other) throw() {
+    static_cast< Reg32_0 * >(this->parent)->flushICC();
     this->m_cur_val &= 0xfffff0ffL;
     this->m_cur_val |= ((other & 0xf) << 8);
     parent->execute_callbacks(scireg_ns::SCIREG_WRITE_ACCESS);
@@ -221,6 +236,7 @@ leon3_funclt_trap::Reg32_0::InnerField_PIL::~InnerField_PIL() {
 }
 
 InnerField & leon3_funclt_trap::Reg32_0::InnerField_CWP::operator =( const unsigned int & other ) throw() {
+    static_cast< Reg32_0 * >(this->parent)->flushICC();
     this->m_cur_val &= 0xffffffe0L;
     this->m_cur_val |= other;
     parent->execute_callbacks(scireg_ns::SCIREG_WRITE_ACCESS);
@@ -235,6 +251,7 @@ leon3_funclt_trap::Reg32_0::InnerField_CWP::~InnerField_CWP() {
 }
 
 InnerField & leon3_funclt_trap::Reg32_0::InnerField_IMPL::operator =( const unsigned int & other ) throw() {
+    static_cast< Reg32_0 * >(this->parent)->flushICC();
     this->m_cur_val &= 0xfffffff;
     this->m_cur_val |= ((other & 0xf) << 28);
     parent->execute_callbacks(scireg_ns::SCIREG_WRITE_ACCESS);
@@ -259,76 +276,120 @@ leon3_funclt_trap::Reg32_0::InnerField_Empty::InnerField_Empty() {
 leon3_funclt_trap::Reg32_0::InnerField_Empty::~InnerField_Empty() {
 }
 
+unsigned int * leon3_funclt_trap::Reg32_0::getStorage() throw(){
+    // The condition codes are evaluated lazily, so the value of PSR can only
+    // be accessed through its operators
+    return NULL;
+}
+
+void leon3_funclt_trap::Reg32_0::evaluateICC() throw(){
+    unsigned int result = this->iccResult;
+    unsigned int op1 = this->iccOp1;
+    unsigned int op2 = this->iccOp2;
+    unsigned int icc = ((result & 0x80000000) >> 8) | ((result == 0) << 22);
+    switch(this->iccOp){
+        case ICC_ADD:{
+            icc |= (((op1 & op2 & (~result)) | ((~op1) & (~op2) & result)) >> 31) << 21;
+            icc |= (((op1 & op2) | ((op1 | op2) & (~result))) >> 31) << 20;
+            break;
+        }
+        case ICC_SUB:{
+            icc |= (((op1 & (~op2) & (~result)) | ((~op1) & op2 & result)) >> 31) << 21;
+            icc |= ((((~op1) & op2) | (((~op1) | op2) & result)) >> 31) << 20;
+            break;
+        }
+        default:{
+            break;
+        }
+    }
+    this->iccOp = ICC_NONE;
+    this->m_cur_val = (this->m_cur_val & 0xff0fffff) | icc;
+    execute_callbacks(scireg_ns::SCIREG_WRITE_ACCESS);
+}
+
 void leon3_funclt_trap::Reg32_0::immediateWrite( const unsigned int & value ) throw(){
+    this->flushICC();
     this->m_cur_val = value;
     execute_callbacks(scireg_ns::SCIREG_WRITE_ACCESS);
 }
 
 unsigned int leon3_funclt_trap::Reg32_0::readNewValue() throw(){
+    this->flushICC();
     execute_callbacks(scireg_ns::SCIREG_READ_ACCESS);
     return this->m_cur_val;
 }
 
 unsigned int leon3_funclt_trap::Reg32_0::operator ~() throw(){
+    this->flushICC();
     execute_callbacks(scireg_ns::SCIREG_READ_ACCESS);
     return ~(this->m_cur_val);
 }
 
 Reg32_0 & leon3_funclt_trap::Reg32_0::operator =( const unsigned int & other ) throw(){
+    this->flushICC();
     this->m_cur_val = other;
     execute_callbacks(scireg_ns::SCIREG_WRITE_ACCESS);
     return *this;
 }
 
 Reg32_0 & leon3_funclt_trap::Reg32_0::operator +=( const unsigned int & other ) throw(){
+    this->flushICC();
     this->m_cur_val += other;
     execute_callbacks(scireg_ns::SCIREG_WRITE_ACCESS);
     return *this;
 }
 
 Reg32_0 & leon3_funclt_trap::Reg32_0::operator -=( const unsigned int & other ) throw(){
+    this->flushICC();
     this->m_cur_val -= other;
     execute_callbacks(scireg_ns::SCIREG_WRITE_ACCESS);
     return *this;
 }
 
 Reg32_0 & leon3_funclt_trap::Reg32_0::operator *=( const unsigned int & other ) throw(){
+    this->flushICC();
     this->m_cur_val *= other;
     execute_callbacks(scireg_ns::SCIREG_WRITE_ACCESS);
     return *this;
 }
 
 Reg32_0 & leon3_funclt_trap::Reg32_0::operator /=( const unsigned int & other ) throw(){
+    this->flushICC();
     this->m_cur_val /= other;
     execute_callbacks(scireg_ns::SCIREG_WRITE_ACCESS);
     return *this;
 }
 
 Reg32_0 & leon3_funclt_trap::Reg32_0::operator |=( const unsigned int & other ) throw(){
+    this->flushICC();
     this->m_cur_val |= other;
     execute_callbacks(scireg_ns::SCIREG_WRITE_ACCESS);
     return *this;
 }
 
 Reg32_0 & leon3_funclt_trap::Reg32_0::operator &=( const unsigned int & other ) throw(){
+    this->flushICC();
     this->m_cur_val &= other;
     execute_callbacks(scireg_ns::SCIREG_WRITE_ACCESS);
     return *this;
 }
 
 Reg32_0 & leon3_funclt_trap::Reg32_0::operator ^=( const unsigned int & other ) throw(){
+    this->flushICC();
     this->m_cur_val ^= other;
     execute_callbacks(scireg_ns::SCIREG_WRITE_ACCESS);
     return *this;
 }
 
 Reg32_0 & leon3_funclt_trap::Reg32_0::operator <<=( const unsigned int & other ) throw(){
+    this->flushICC();
     this->m_cur_val <<= other;
     execute_callbacks(scireg_ns::SCIREG_WRITE_ACCESS);
     return *this;
 }
 
 Reg32_0 & leon3_funclt_trap::Reg32_0::operator >>=( const unsigned int & other ) throw(){
+    this->flushICC();
     this->m_cur_val >>= other;
     execute_callbacks(scireg_ns::SCIREG_WRITE_ACCESS);
     return *this;
@@ -336,143 +397,193 @@ Reg32_0 & leon3_funclt_trap::Reg32_0::operator >>=( const unsigned int & other )
 
 unsigned int leon3_funclt_trap::Reg32_0::operator +( const Reg32_0 & other ) const \
     throw(){
+    this->flushICC();
+    other.flushICC();
     execute_callbacks(scireg_ns::SCIREG_READ_ACCESS);
     return (this->m_cur_val + other.m_cur_val);
 }
 
 unsigned int leon3_funclt_trap::Reg32_0::operator -( const Reg32_0 & other ) const \
     throw(){
+    this->flushICC();
+    other.flushICC();
     execute_callbacks(scireg_ns::SCIREG_READ_ACCESS);
     return (this->m_cur_val - other.m_cur_val);
 }
 
 unsigned int leon3_funclt_trap::Reg32_0::operator *( const Reg32_0 & other ) const \
     throw(){
+    this->flushICC();
+    other.flushICC();
     execute_callbacks(scireg_ns::SCIREG_READ_ACCESS);
     return (this->m_cur_val * other.m_cur_val);
 }
 
 unsigned int leon3_funclt_trap::Reg32_0::operator /( const Reg32_0 & other ) const \
     throw(){
+    this->flushICC();
+    other.flushICC();
     execute_callbacks(scireg_ns::SCIREG_READ_ACCESS);
     return (this->m_cur_val / other.m_cur_val);
 }
 
 unsigned int leon3_funclt_trap::Reg32_0::operator |( const Reg32_0 & other ) const \
     throw(){
+    this->flushICC();
+    other.flushICC();
     execute_callbacks(scireg_ns::SCIREG_READ_ACCESS);
     return (this->m_cur_val | other.m_cur_val);
 }
 
 unsigned int leon3_funclt_trap::Reg32_0::operator &( const Reg32_0 & other ) const \
     throw(){
+    this->flushICC();
+    other.flushICC();
     execute_callbacks(scireg_ns::SCIREG_READ_ACCESS);
     return (this->m_cur_val & other.m_cur_val);
 }
 
 unsigned int leon3_funclt_trap::Reg32_0::operator ^( const Reg32_0 & other ) const \
     throw(){
+    this->flushICC();
+    other.flushICC();
     execute_callbacks(scireg_ns::SCIREG_READ_ACCESS);
     return (this->m_cur_val ^ other.m_cur_val);
 }
 
 unsigned int leon3_funclt_trap::Reg32_0::operator <<( const Reg32_0 & other ) const \
     throw(){
+    this->flushICC();
+    other.flushICC();
     execute_callbacks(scireg_ns::SCIREG_READ_ACCESS);
     return (this->m_cur_val << other.m_cur_val);
 }
 
 unsigned int leon3_funclt_trap::Reg32_0::operator >>( const Reg32_0 & other ) const \
     throw(){
+    this->flushICC();
+    other.flushICC();
     execute_callbacks(scireg_ns::SCIREG_READ_ACCESS);
     return (this->m_cur_val >> other.m_cur_val);
 }
 
 bool leon3_funclt_trap::Reg32_0::operator <( const Reg32_0 & other ) const throw(){
+    this->flushICC();
+    other.flushICC();
     execute_callbacks(scireg_ns::SCIREG_READ_ACCESS);
     return (this->m_cur_val < other.m_cur_val);
 }
 
 bool leon3_funclt_trap::Reg32_0::operator >( const Reg32_0 & other ) const throw(){
+    this->flushICC();
+    other.flushICC();
     execute_callbacks(scireg_ns::SCIREG_READ_ACCESS);
     return (this->m_cur_val > other.m_cur_val);
 }
 
 bool leon3_funclt_trap::Reg32_0::operator <=( const Reg32_0 & other ) const throw(){
+    this->flushICC();
+    other.flushICC();
     execute_callbacks(scireg_ns::SCIREG_READ_ACCESS);
     return (this->m_cur_val <= other.m_cur_val);
 }
 
 bool leon3_funclt_trap::Reg32_0::operator >=( const Reg32_0 & other ) const throw(){
+    this->flushICC();
+    other.flushICC();
     execute_callbacks(scireg_ns::SCIREG_READ_ACCESS);
     return (this->m_cur_val >= other.m_cur_val);
 }
 
 bool leon3_funclt_trap::Reg32_0::operator ==( const Reg32_0 & other ) const throw(){
+    this->flushICC();
+    other.flushICC();
     execute_callbacks(scireg_ns::SCIREG_READ_ACCESS);
     return (this->m_cur_val == other.m_cur_val);
 }
 
 bool leon3_funclt_trap::Reg32_0::operator !=( const Reg32_0 & other ) const throw(){
+    this->flushICC();
+    other.flushICC();
     execute_callbacks(scireg_ns::SCIREG_READ_ACCESS);
     return (this->m_cur_val != other.m_cur_val);
 }
 
 Reg32_0 & leon3_funclt_trap::Reg32_0::operator =( const Reg32_0 & other ) throw(){
+    this->flushICC();
+    other.flushICC();
     this->m_cur_val = other;
     execute_callbacks(scireg_ns::SCIREG_WRITE_ACCESS);
     return *this;
 }
 
 Reg32_0 & leon3_funclt_trap::Reg32_0::operator +=( const Reg32_0 & other ) throw(){
+    this->flushICC();
+    other.flushICC();
     this->m_cur_val += other;
     execute_callbacks(scireg_ns::SCIREG_WRITE_ACCESS);
     return *this;
 }
 
 Reg32_0 & leon3_funclt_trap::Reg32_0::operator -=( const Reg32_0 & other ) throw(){
+    this->flushICC();
+    other.flushICC();
     this->m_cur_val -= other;
     execute_callbacks(scireg_ns::SCIREG_WRITE_ACCESS);
     return *this;
 }
 
 Reg32_0 & leon3_funclt_trap::Reg32_0::operator *=( const Reg32_0 & other ) throw(){
+    this->flushICC();
+    other.flushICC();
     this->m_cur_val *= other;
     execute_callbacks(scireg_ns::SCIREG_WRITE_ACCESS);
     return *this;
 }
 
 Reg32_0 & leon3_funclt_trap::Reg32_0::operator /=( const Reg32_0 & other ) throw(){
+    this->flushICC();
+    other.flushICC();
     this->m_cur_val /= other;
     execute_callbacks(scireg_ns::SCIREG_WRITE_ACCESS);
     return *this;
 }
 
 Reg32_0 & leon3_funclt_trap::Reg32_0::operator |=( const Reg32_0 & other ) throw(){
+    this->flushICC();
+    other.flushICC();
     this->m_cur_val |= other;
     execute_callbacks(scireg_ns::SCIREG_WRITE_ACCESS);
     return *this;
 }
 
 Reg32_0 & leon3_funclt_trap::Reg32_0::operator &=( const Reg32_0 & other ) throw(){
+    this->flushICC();
+    other.flushICC();
     this->m_cur_val &= other;
     execute_callbacks(scireg_ns::SCIREG_WRITE_ACCESS);
     return *this;
 }
 
 Reg32_0 & leon3_funclt_trap::Reg32_0::operator ^=( const Reg32_0 & other ) throw(){
+    this->flushICC();
+    other.flushICC();
     this->m_cur_val ^= other;
     execute_callbacks(scireg_ns::SCIREG_WRITE_ACCESS);
     return *this;
 }
 
 Reg32_0 & leon3_funclt_trap::Reg32_0::operator <<=( const Reg32_0 & other ) throw(){
+    this->flushICC();
+    other.flushICC();
     this->m_cur_val <<= other;
     execute_callbacks(scireg_ns::SCIREG_WRITE_ACCESS);
     return *this;
 }
 
 Reg32_0 & leon3_funclt_trap::Reg32_0::operator >>=( const Reg32_0 & other ) throw(){
+    this->flushICC();
+    other.flushICC();
     this->m_cur_val >>= other;
     execute_callbacks(scireg_ns::SCIREG_WRITE_ACCESS);
     return *this;
@@ -480,143 +591,168 @@ Reg32_0 & leon3_funclt_trap::Reg32_0::operator >>=( const Reg32_0 & other ) thro
 
 unsigned int leon3_funclt_trap::Reg32_0::operator +( const Register & other ) const \
     throw(){
+    this->flushICC();
     execute_callbacks(scireg_ns::SCIREG_READ_ACCESS);
     return (this->m_cur_val + other);
 }
 
 unsigned int leon3_funclt_trap::Reg32_0::operator -( const Register & other ) const \
     throw(){
+    this->flushICC();
     execute_callbacks(scireg_ns::SCIREG_READ_ACCESS);
     return (this->m_cur_val - other);
 }
 
 unsigned int leon3_funclt_trap::Reg32_0::operator *( const Register & other ) const \
     throw(){
+    this->flushICC();
     execute_callbacks(scireg_ns::SCIREG_READ_ACCESS);
     return (this->m_cur_val * other);
 }
 
 unsigned int leon3_funclt_trap::Reg32_0::operator /( const Register & other ) const \
     throw(){
+    this->flushICC();
     execute_callbacks(scireg_ns::SCIREG_READ_ACCESS);
     return (this->m_cur_val / other);
 }
 
 unsigned int leon3_funclt_trap::Reg32_0::operator |( const Register & other ) const \
     throw(){
+    this->flushICC();
     execute_callbacks(scireg_ns::SCIREG_READ_ACCESS);
     return (this->m_cur_val | other);
 }
 
 unsigned int leon3_funclt_trap::Reg32_0::operator &( const Register & other ) const \
     throw(){
+    this->flushICC();
     execute_callbacks(scireg_ns::SCIREG_READ_ACCESS);
     return (this->m_cur_val & other);
 }
 
 unsigned int leon3_funclt_trap::Reg32_0::operator ^( const Register & other ) const \
     throw(){
+    this->flushICC();
     execute_callbacks(scireg_ns::SCIREG_READ_ACCESS);
     return (this->m_cur_val ^ other);
 }
 
 unsigned int leon3_funclt_trap::Reg32_0::operator <<( const Register & other ) const \
     throw(){
+    this->flushICC();
     execute_callbacks(scireg_ns::SCIREG_READ_ACCESS);
     return (this->m_cur_val << other);
 }
 
 unsigned int leon3_funclt_trap::Reg32_0::operator >>( const Register & other ) const \
     throw(){
+    this->flushICC();
     execute_callbacks(scireg_ns::SCIREG_READ_ACCESS);
     return (this->m_cur_val >> other);
 }
 
 bool leon3_funclt_trap::Reg32_0::operator <( const Register & other ) const throw(){
+    this->flushICC();
     execute_callbacks(scireg_ns::SCIREG_READ_ACCESS);
     return (this->m_cur_val < other);
 }
 
 bool leon3_funclt_trap::Reg32_0::operator >( const Register & other ) const throw(){
+    this->flushICC();
     execute_callbacks(scireg_ns::SCIREG_READ_ACCESS);
     return (this->m_cur_val > other);
 }
 
 bool leon3_funclt_trap::Reg32_0::operator <=( const Register & other ) const throw(){
+    this->flushICC();
     execute_callbacks(scireg_ns::SCIREG_READ_ACCESS);
     return (this->m_cur_val <= other);
 }
 
 bool leon3_funclt_trap::Reg32_0::operator >=( const Register & other ) const throw(){
+    this->flushICC();
     execute_callbacks(scireg_ns::SCIREG_READ_ACCESS);
     return (this->m_cur_val >= other);
 }
 
 bool leon3_funclt_trap::Reg32_0::operator ==( const Register & other ) const throw(){
+    this->flushICC();
     execute_callbacks(scireg_ns::SCIREG_READ_ACCESS);
     return (this->m_cur_val == other);
 }
 
 bool leon3_funclt_trap::Reg32_0::operator !=( const Register & other ) const throw(){
+    this->flushICC();
     execute_callbacks(scireg_ns::SCIREG_READ_ACCESS);
     return (this->m_cur_val != other);
 }
 
 Reg32_0 & leon3_funclt_trap::Reg32_0::operator =( const Register & other ) throw(){
+    this->flushICC();
     this->m_cur_val = other;
     execute_callbacks(scireg_ns::SCIREG_WRITE_ACCESS);
     return *this;
 }
 
 Reg32_0 & leon3_funclt_trap::Reg32_0::operator +=( const Register & other ) throw(){
+    this->flushICC();
     this->m_cur_val += other;
     execute_callbacks(scireg_ns::SCIREG_WRITE_ACCESS);
     return *this;
 }
 
 Reg32_0 & leon3_funclt_trap::Reg32_0::operator -=( const Register & other ) throw(){
+    this->flushICC();
     this->m_cur_val -= other;
     execute_callbacks(scireg_ns::SCIREG_WRITE_ACCESS);
     return *this;
 }
 
 Reg32_0 & leon3_funclt_trap::Reg32_0::operator *=( const Register & other ) throw(){
+    this->flushICC();
     this->m_cur_val *= other;
     execute_callbacks(scireg_ns::SCIREG_WRITE_ACCESS);
     return *this;
 }
 
 Reg32_0 & leon3_funclt_trap::Reg32_0::operator /=( const Register & other ) throw(){
+    this->flushICC();
     this->m_cur_val /= other;
     execute_callbacks(scireg_ns::SCIREG_WRITE_ACCESS);
     return *this;
 }
 
 Reg32_0 & leon3_funclt_trap::Reg32_0::operator |=( const Register & other ) throw(){
+    this->flushICC();
     this->m_cur_val |= other;
     execute_callbacks(scireg_ns::SCIREG_WRITE_ACCESS);
     return *this;
 }
 
 Reg32_0 & leon3_funclt_trap::Reg32_0::operator &=( const Register & other ) throw(){
+    this->flushICC();
     this->m_cur_val &= other;
     execute_callbacks(scireg_ns::SCIREG_WRITE_ACCESS);
     return *this;
 }
 
 Reg32_0 & leon3_funclt_trap::Reg32_0::operator ^=( const Register & other ) throw(){
+    this->flushICC();
     this->m_cur_val ^= other;
     execute_callbacks(scireg_ns::SCIREG_WRITE_ACCESS);
     return *this;
 }
 
 Reg32_0 & leon3_funclt_trap::Reg32_0::operator <<=( const Register & other ) throw(){
+    this->flushICC();
     this->m_cur_val <<= other;
     execute_callbacks(scireg_ns::SCIREG_WRITE_ACCESS);
     return *this;
 }
 
 Reg32_0 & leon3_funclt_trap::Reg32_0::operator >>=( const Register & other ) throw(){
+    this->flushICC();
     this->m_cur_val >>= other;
     execute_callbacks(scireg_ns::SCIREG_WRITE_ACCESS);
     return *this;
@@ -624,6 +760,7 @@ Reg32_0 & leon3_funclt_trap::Reg32_0::operator >>=( const Register & other ) thr
 
 std::ostream & leon3_funclt_trap::Reg32_0::operator <<( std::ostream & stream ) const \
     throw(){
+    this->flushICC();
     execute_callbacks(scireg_ns::SCIREG_READ_ACCESS);
     stream << std::hex << std::showbase << this->m_cur_val << std::dec;
     return stream;
@@ -634,6 +771,7 @@ leon3_funclt_trap::Reg32_0::Reg32_0() : field_VER(this->m_cur_val, this), field_
     field_S(this->m_cur_val, this), field_ET(this->m_cur_val, this), field_ICC_c(this->m_cur_val, this), field_PS(this->m_cur_val, this), \
     field_PIL(this->m_cur_val, this), field_CWP(this->m_cur_val, this), field_IMPL(this->m_cur_val, this){
     this->m_cur_val = 0;
+    this->iccOp = ICC_NONE;
 }
 
 leon3_funclt_trap::Reg32_0::Reg32_0(const char *name) : Register(name), field_VER(this->m_cur_val, this), field_ICC_z(this->m_cur_val, this), \
@@ -641,6 +779,7 @@ leon3_funclt_trap::Reg32_0::Reg32_0(const char *name) : Register(name), field_VE
     field_S(this->m_cur_val, this), field_ET(this->m_cur_val, this), field_ICC_c(this->m_cur_val, this), field_PS(this->m_cur_val, this), \
     field_PIL(this->m_cur_val, this), field_CWP(this->m_cur_val, this), field_IMPL(this->m_cur_val, this){
     this->m_cur_val = 0;
+    this->iccOp = ICC_NONE;
 }
 
 InnerField & leon3_funclt_trap::Reg32_1::InnerField_WIM_28::operator =( const unsigned \
@@ -1190,6 +1329,10 @@ leon3_funclt_trap::Reg32_1::InnerField_Empty::InnerField_Empty(){
 leon3_funclt_trap::Reg32_1::InnerField_Empty::~InnerField_Empty(){
 
 }
+unsigned int * leon3_funclt_trap::Reg32_1::getStorage() throw(){
+    return &this->m_cur_val;
+}
+
 void leon3_funclt_trap::Reg32_1::immediateWrite( const unsigned int & value ) throw(){
     this->m_cur_val = value;
     execute_callbacks(scireg_ns::SCIREG_WRITE_ACCESS);
@@ -1630,6 +1773,10 @@ leon3_funclt_trap::Reg32_2::InnerField_Empty::InnerField_Empty(){
 leon3_funclt_trap::Reg32_2::InnerField_Empty::~InnerField_Empty(){
 
 }
+unsigned int * leon3_funclt_trap::Reg32_2::getStorage() throw(){
+    return &this->m_cur_val;
+}
+
 void leon3_funclt_trap::Reg32_2::immediateWrite( const unsigned int & value ) throw(){
     this->m_cur_val = value;
     execute_callbacks(scireg_ns::SCIREG_WRITE_ACCESS);
@@ -2021,6 +2168,10 @@ leon3_funclt_trap::Reg32_3::InnerField_Empty::InnerField_Empty(){
 leon3_funclt_trap::Reg32_3::InnerField_Empty::~InnerField_Empty(){
 
 }
+unsigned int * leon3_funclt_trap::Reg32_3::getStorage() throw(){
+    return &this->m_cur_val;
+}
+
 void leon3_funclt_trap::Reg32_3::immediateWrite( const unsigned int & value ) throw(){
     this->m_cur_val = value;
     execute_callbacks(scireg_ns::SCIREG_WRITE_ACCESS);
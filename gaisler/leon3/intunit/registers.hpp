@@ -92,6 +92,205 @@
 #define key_TBA 45
 #define key_TT 46
 
+namespace leon3_funclt_trap{
+
+    /// Compile-time description of the register bit-fields: the mask and the
+    /// shift of field key_X are known statically, so field<key_X>() and
+    /// setField<key_X>() compile down to a couple of logical operations on
+    /// the register storage instead of a call through the virtual InnerField.
+    template < int bitField > struct FieldInfo;
+
+    template <> struct FieldInfo< key_VER >{
+        static const unsigned int mask = 0xf000000;
+        static const unsigned int shift = 24;
+    };
+    template <> struct FieldInfo< key_ICC_z >{
+        static const unsigned int mask = 0x400000;
+        static const unsigned int shift = 22;
+    };
+    template <> struct FieldInfo< key_ICC_v >{
+        static const unsigned int mask = 0x200000;
+        static const unsigned int shift = 21;
+    };
+    template <> struct FieldInfo< key_EF >{
+        static const unsigned int mask = 0x1000;
+        static const unsigned int shift = 12;
+    };
+    template <> struct FieldInfo< key_EC >{
+        static const unsigned int mask = 0x2000;
+        static const unsigned int shift = 13;
+    };
+    template <> struct FieldInfo< key_ICC_n >{
+        static const unsigned int mask = 0x800000;
+        static const unsigned int shift = 23;
+    };
+    template <> struct FieldInfo< key_S >{
+        static const unsigned int mask = 0x80;
+        static const unsigned int shift = 7;
+    };
+    template <> struct FieldInfo< key_ET >{
+        static const unsigned int mask = 0x20;
+        static const unsigned int shift = 5;
+    };
+    template <> struct FieldInfo< key_ICC_c >{
+        static const unsigned int mask = 0x100000;
+        static const unsigned int shift = 20;
+    };
+    template <> struct FieldInfo< key_PS >{
+        static const unsigned int mask = 0x40;
+        static const unsigned int shift = 6;
+    };
+    template <> struct FieldInfo< key_PIL >{
+        static const unsigned int mask = 0xf00;
+        static const unsigned int shift = 8;
+    };
+    template <> struct FieldInfo< key_CWP >{
+        static const unsigned int mask = 0x1f;
+        static const unsigned int shift = 0;
+    };
+    template <> struct FieldInfo< key_IMPL >{
+        static const unsigned int mask = 0xf0000000;
+        static const unsigned int shift = 28;
+    };
+    template <> struct FieldInfo< key_WIM_28 >{
+        static const unsigned int mask = 0x10000000;
+        static const unsigned int shift = 28;
+    };
+    template <> struct FieldInfo< key_WIM_29 >{
+        static const unsigned int mask = 0x20000000;
+        static const unsigned int shift = 29;
+    };
+    template <> struct FieldInfo< key_WIM_24 >{
+        static const unsigned int mask = 0x1000000;
+        static const unsigned int shift = 24;
+    };
+    template <> struct FieldInfo< key_WIM_25 >{
+        static const unsigned int mask = 0x2000000;
+        static const unsigned int shift = 25;
+    };
+    template <> struct FieldInfo< key_WIM_26 >{
+        static const unsigned int mask = 0x4000000;
+        static const unsigned int shift = 26;
+    };
+    template <> struct FieldInfo< key_WIM_27 >{
+        static const unsigned int mask = 0x8000000;
+        static const unsigned int shift = 27;
+    };
+    template <> struct FieldInfo< key_WIM_20 >{
+        static const unsigned int mask = 0x100000;
+        static const unsigned int shift = 20;
+    };
+    template <> struct FieldInfo< key_WIM_21 >{
+        static const unsigned int mask = 0x200000;
+        static const unsigned int shift = 21;
+    };
+    template <> struct FieldInfo< key_WIM_22 >{
+        static const unsigned int mask = 0x400000;
+        static const unsigned int shift = 22;
+    };
+    template <> struct FieldInfo< key_WIM_23 >{
+        static const unsigned int mask = 0x800000;
+        static const unsigned int shift = 23;
+    };
+    template <> struct FieldInfo< key_WIM_9 >{
+        static const unsigned int mask = 0x200;
+        static const unsigned int shift = 9;
+    };
+    template <> struct FieldInfo< key_WIM_8 >{
+        static const unsigned int mask = 0x100;
+        static const unsigned int shift = 8;
+    };
+    template <> struct FieldInfo< key_WIM_1 >{
+        static const unsigned int mask = 0x2;
+        static const unsigned int shift = 1;
+    };
+    template <> struct FieldInfo< key_WIM_0 >{
+        static const unsigned int mask = 0x1;
+        static const unsigned int shift = 0;
+    };
+    template <> struct FieldInfo< key_WIM_3 >{
+        static const unsigned int mask = 0x8;
+        static const unsigned int shift = 3;
+    };
+    template <> struct FieldInfo< key_WIM_2 >{
+        static const unsigned int mask = 0x4;
+        static const unsigned int shift = 2;
+    };
+    template <> struct FieldInfo< key_WIM_5 >{
+        static const unsigned int mask = 0x20;
+        static const unsigned int shift = 5;
+    };
+    template <> struct FieldInfo< key_WIM_4 >{
+        static const unsigned int mask = 0x10;
+        static const unsigned int shift = 4;
+    };
+    template <> struct FieldInfo< key_WIM_7 >{
+        static const unsigned int mask = 0x80;
+        static const unsigned int shift = 7;
+    };
+    template <> struct FieldInfo< key_WIM_6 >{
+        static const unsigned int mask = 0x40;
+        static const unsigned int shift = 6;
+    };
+    template <> struct FieldInfo< key_WIM_11 >{
+        static const unsigned int mask = 0x800;
+        static const unsigned int shift = 11;
+    };
+    template <> struct FieldInfo< key_WIM_10 >{
+        static const unsigned int mask = 0x400;
+        static const unsigned int shift = 10;
+    };
+    template <> struct FieldInfo< key_WIM_13 >{
+        static const unsigned int mask = 0x2000;
+        static const unsigned int shift = 13;
+    };
+    template <> struct FieldInfo< key_WIM_12 >{
+        static const unsigned int mask = 0x1000;
+        static const unsigned int shift = 12;
+    };
+    template <> struct FieldInfo< key_WIM_15 >{
+        static const unsigned int mask = 0x8000;
+        static const unsigned int shift = 15;
+    };
+    template <> struct FieldInfo< key_WIM_14 >{
+        static const unsigned int mask = 0x4000;
+        static const unsigned int shift = 14;
+    };
+    template <> struct FieldInfo< key_WIM_17 >{
+        static const unsigned int mask = 0x20000;
+        static const unsigned int shift = 17;
+    };
+    template <> struct FieldInfo< key_WIM_16 >{
+        static const unsigned int mask = 0x10000;
+        static const unsigned int shift = 16;
+    };
+    template <> struct FieldInfo< key_WIM_19 >{
+        static const unsigned int mask = 0x80000;
+        static const unsigned int shift = 19;
+    };
+    template <> struct FieldInfo< key_WIM_18 >{
+        static const unsigned int mask = 0x40000;
+        static const unsigned int shift = 18;
+    };
+    template <> struct FieldInfo< key_WIM_31 >{
+        static const unsigned int mask = 0x80000000;
+        static const unsigned int shift = 31;
+    };
+    template <> struct FieldInfo< key_WIM_30 >{
+        static const unsigned int mask = 0x40000000;
+        static const unsigned int shift = 30;
+    };
+    template <> struct FieldInfo< key_TBA >{
+        static const unsigned int mask = 0xfffff000;
+        static const unsigned int shift = 12;
+    };
+    template <> struct FieldInfo< key_TT >{
+        static const unsigned int mask = 0xff0;
+        static const unsigned int shift = 4;
+    };
+
+};
+
 namespace leon3_funclt_trap{
 
     class Register;
@@ -160,6 +359,16 @@ namespace leon3_funclt_trap{
         virtual Register & operator >>=( const Register & other ) throw() = 0;
         virtual std::ostream & operator <<( std::ostream & other ) const throw() = 0;
         virtual operator unsigned int() const throw() = 0;
+        /// Returns the word holding the register value, or NULL if the
+        /// register has no backing storage (e.g. the constant %g0); used by
+        /// the aliases to access the register without virtual calls.
+        virtual unsigned int * getStorage() throw();
+        /// True if some scireg client (GDB, pysc, ...) registered a callback
+        /// on the register: in that case accesses must go through the
+        /// virtual operators, which notify the callbacks.
+        inline bool hasCallbacks() const throw(){
+            return !this->scireg_callback_vec.empty();
+        }
 
     inline void execute_callbacks(const scireg_ns::scireg_callback_type &type) const {
       scireg_ns::scireg_callback* p;
@@ -187,6 +396,7 @@ namespace leon3_funclt_trap{
             InnerField_VER( unsigned int & m_cur_val, Register *reg );
             InnerField & operator =( const unsigned int & other ) throw();
             inline operator unsigned int() const throw(){
+                static_cast< Reg32_0 * >(this->parent)->flushICC();
                 parent->execute_callbacks(scireg_ns::SCIREG_READ_ACCESS);
                 return (this->m_cur_val & 0xf000000) >> 24;
             }
@@ -201,6 +411,7 @@ namespace leon3_funclt_trap{
             InnerField_ICC_z( unsigned int & m_cur_val, Register *reg );
             InnerField & operator =( const unsigned int & other ) throw();
             inline operator unsigned int() const throw(){
+                static_cast< Reg32_0 * >(this->parent)->flushICC();
                 parent->execute_callbacks(scireg_ns::SCIREG_READ_ACCESS);
                 return (this->m_cur_val & 0x400000) >> 22;
             }
@@ -215,6 +426,7 @@ namespace leon3_funclt_trap{
             InnerField_ICC_v( unsigned int & m_cur_val, Register *reg );
             InnerField & operator =( const unsigned int & other ) throw();
             inline operator unsigned int() const throw(){
+                static_cast< Reg32_0 * >(this->parent)->flushICC();
                 parent->execute_callbacks(scireg_ns::SCIREG_READ_ACCESS);
                 return (this->m_cur_val & 0x200000) >> 21;
             }
@@ -229,6 +441,7 @@ namespace leon3_funclt_trap{
             InnerField_EF( unsigned int & m_cur_val, Register *reg );
             InnerField & operator =( const unsigned int & other ) throw();
             inline operator unsigned int() const throw(){
+                static_cast< Reg32_0 * >(this->parent)->flushICC();
                 parent->execute_callbacks(scireg_ns::SCIREG_READ_ACCESS);
                 return (this->m_cur_val & 0x1000) >> 12;
             }
@@ -243,6 +456,7 @@ namespace leon3_funclt_trap{
             InnerField_EC( unsigned int & m_cur_val, Register *reg );
             InnerField & operator =( const unsigned int & other ) throw();
             inline operator unsigned int() const throw(){
+                static_cast< Reg32_0 * >(this->parent)->flushICC();
                 parent->execute_callbacks(scireg_ns::SCIREG_READ_ACCESS);
                 return (this->m_cur_val & 0x2000) >> 13;
             }
@@ -257,6 +471,7 @@ namespace leon3_funclt_trap{
             InnerField_ICC_n( unsigned int & m_cur_val, Register *reg );
             InnerField & operator =( const unsigned int & other ) throw();
             inline operator unsigned int() const throw(){
+                static_cast< Reg32_0 * >(this->parent)->flushICC();
                 parent->execute_callbacks(scireg_ns::SCIREG_READ_ACCESS);
                 return (this->m_cur_val & 0x800000) >> 23;
             }
@@ -271,6 +486,7 @@ namespace leon3_funclt_trap{
             InnerField_S( unsigned int & m_cur_val, Register *reg );
             InnerField & operator =( const unsigned int & other ) throw();
             inline operator unsigned int() const throw(){
+                static_cast< Reg32_0 * >(this->parent)->flushICC();
                 parent->execute_callbacks(scireg_ns::SCIREG_READ_ACCESS);
                 return (this->m_cur_val & 0x80) >> 7;
             }
@@ -285,6 +501,7 @@ namespace leon3_funclt_trap{
             InnerField_ET( unsigned int & m_cur_val, Register *reg );
             InnerField & operator =( const unsigned int & other ) throw();
             inline operator unsigned int() const throw(){
+                static_cast< Reg32_0 * >(this->parent)->flushICC();
                 parent->execute_callbacks(scireg_ns::SCIREG_READ_ACCESS);
                 return (this->m_cur_val & 0x20) >> 5;
             }
@@ -299,6 +516,7 @@ namespace leon3_funclt_trap{
             InnerField_ICC_c( unsigned int & m_cur_val, Register *reg );
             InnerField & operator =( const unsigned int & other ) throw();
             inline operator unsigned int() const throw(){
+                static_cast< Reg32_0 * >(this->parent)->flushICC();
                 parent->execute_callbacks(scireg_ns::SCIREG_READ_ACCESS);
                 return (this->m_cur_val & 0x100000) >> 20;
             }
@@ -313,6 +531,7 @@ namespace leon3_funclt_trap{
             InnerField_PS( unsigned int & m_cur_val, Register *reg );
             InnerField & operator =( const unsigned int & other ) throw();
             inline operator unsigned int() const throw(){
+                static_cast< Reg32_0 * >(this->parent)->flushICC();
                 parent->execute_callbacks(scireg_ns::SCIREG_READ_ACCESS);
                 return (this->m_cur_val & 0x40) >> 6;
             }
@@ -327,6 +546,7 @@ namespace leon3_funclt_trap{
             InnerField_PIL( unsigned int & m_cur_val, Register *reg );
             InnerField & operator =( const unsigned int & other ) throw();
             inline operator unsigned int() const throw(){
+                static_cast< Reg32_0 * >(this->parent)->flushICC();
                 parent->execute_callbacks(scireg_ns::SCIREG_READ_ACCESS);
                 return (this->m_cur_val & 0xf00) >> 8;
             }
@@ -341,6 +561,7 @@ namespace leon3_funclt_trap{
             InnerField_CWP( unsigned int & m_cur_val, Register *reg );
             InnerField & operator =( const unsigned int & other ) throw();
             inline operator unsigned int() const throw(){
+                static_cast< Reg32_0 * >(this->parent)->flushICC();
                 parent->execute_callbacks(scireg_ns::SCIREG_READ_ACCESS);
                 return (this->m_cur_val & 0x1f);
             }
@@ -355,6 +576,7 @@ namespace leon3_funclt_trap{
             InnerField_IMPL( unsigned int & m_cur_val, Register *reg );
             InnerField & operator =( const unsigned int & other ) throw();
             inline operator unsigned int() const throw(){
+                static_cast< Reg32_0 * >(this->parent)->flushICC();
                 parent->execute_callbacks(scireg_ns::SCIREG_READ_ACCESS);
                 return (this->m_cur_val & 0xf0000000L) >> 28;
             }
@@ -389,8 +611,21 @@ namespace leon3_funclt_trap{
         InnerField_IMPL field_IMPL;
         InnerField_Empty field_empty;
         unsigned int m_cur_val;
+        unsigned int iccOp;
+        unsigned int iccResult;
+        unsigned int iccOp1;
+        unsigned int iccOp2;
+        void evaluateICC() throw();
 
         public:
+        /// Kind of the operation whose condition codes are still pending
+        enum ICCOp{
+            ICC_NONE = 0,
+            ICC_LOGIC,
+            ICC_ADD,
+            ICC_SUB
+        };
+
         Reg32_0();
         explicit Reg32_0(const char *name);
 
@@ -518,9 +753,42 @@ namespace leon3_funclt_trap{
         Reg32_0 & operator <<=( const Register & other ) throw();
         Reg32_0 & operator >>=( const Register & other ) throw();
         inline operator unsigned int() const throw(){
+            this->flushICC();
             execute_callbacks(scireg_ns::SCIREG_READ_ACCESS);
             return this->m_cur_val;
         }
+        /// Lazy condition codes: cc-setting instructions only record the kind
+        /// of operation, its operands and its result. N, Z, V and C are
+        /// computed into the register value the first time PSR is accessed
+        /// (branches, RDPSR, trap entry, debugger reads, ...), so flags which
+        /// are overwritten before being used are never evaluated.
+        inline void setICCLazy( unsigned int op, unsigned int result, unsigned int op1, unsigned \
+            int op2 ) throw(){
+            this->iccOp = op;
+            this->iccResult = result;
+            this->iccOp1 = op1;
+            this->iccOp2 = op2;
+            if(this->hasCallbacks()){
+                this->evaluateICC();
+            }
+        }
+        inline void flushICC() const throw(){
+            if(this->iccOp != ICC_NONE){
+                const_cast< Reg32_0 * >(this)->evaluateICC();
+            }
+        }
+        template < int bitField > inline unsigned int field() const throw(){
+            this->flushICC();
+            execute_callbacks(scireg_ns::SCIREG_READ_ACCESS);
+            return (this->m_cur_val & FieldInfo< bitField >::mask) >> FieldInfo< bitField >::shift;
+        }
+        template < int bitField > inline void setField( const unsigned int & value ) throw(){
+            this->flushICC();
+            this->m_cur_val = (this->m_cur_val & ~FieldInfo< bitField >::mask) | ((value << FieldInfo< \
+                bitField >::shift) & FieldInfo< bitField >::mask);
+            execute_callbacks(scireg_ns::SCIREG_WRITE_ACCESS);
+        }
+        unsigned int * getStorage() throw();
         std::ostream & operator <<( std::ostream & stream ) const throw();
     };
 
@@ -1233,6 +1501,16 @@ namespace leon3_funclt_trap{
             execute_callbacks(scireg_ns::SCIREG_READ_ACCESS);
             return this->m_cur_val;
         }
+        template < int bitField > inline unsigned int field() const throw(){
+            execute_callbacks(scireg_ns::SCIREG_READ_ACCESS);
+            return (this->m_cur_val & FieldInfo< bitField >::mask) >> FieldInfo< bitField >::shift;
+        }
+        template < int bitField > inline void setField( const unsigned int & value ) throw(){
+            this->m_cur_val = (this->m_cur_val & ~FieldInfo< bitField >::mask) | ((value << FieldInfo< \
+                bitField >::shift) & FieldInfo< bitField >::mask);
+            execute_callbacks(scireg_ns::SCIREG_WRITE_ACCESS);
+        }
+        unsigned int * getStorage() throw();
         std::ostream & operator <<( std::ostream & stream ) const throw();
     };
 
@@ -1374,6 +1652,16 @@ namespace leon3_funclt_trap{
             execute_callbacks(scireg_ns::SCIREG_READ_ACCESS);
             return this->m_cur_val;
         }
+        template < int bitField > inline unsigned int field() const throw(){
+            execute_callbacks(scireg_ns::SCIREG_READ_ACCESS);
+            return (this->m_cur_val & FieldInfo< bitField >::mask) >> FieldInfo< bitField >::shift;
+        }
+        template < int bitField > inline void setField( const unsigned int & value ) throw(){
+            this->m_cur_val = (this->m_cur_val & ~FieldInfo< bitField >::mask) | ((value << FieldInfo< \
+                bitField >::shift) & FieldInfo< bitField >::mask);
+            execute_callbacks(scireg_ns::SCIREG_WRITE_ACCESS);
+        }
+        unsigned int * getStorage() throw();
         std::ostream & operator <<( std::ostream & stream ) const throw();
     };
 
@@ -1480,6 +1768,7 @@ namespace leon3_funclt_trap{
           execute_callbacks(scireg_ns::SCIREG_READ_ACCESS);
           return this->m_cur_val;
         }
+        unsigned int * getStorage() throw();
         std::ostream & operator <<( std::ostream & stream ) const throw();
     };
 
@@ -117,7 +117,23 @@ Leon3::Leon3(
   g_mmupgsz("mmupgsz", mmupgsz, m_generics),
   //g_hindex("hindex", hindex, m_generics),
   g_args("args", m_generics),
-  g_stdout_filename("stdout_filename", "", m_generics) {
+  g_stdout_filename("stdout_filename", "", m_generics),
+  g_fetchbuffer("fetchbuffer", false, m_generics),
+  g_wbdepth("wbdepth", 4, m_generics),
+  g_wbpolicy("wbpolicy", writebuffer::WB_OFF, m_generics),
+  g_dmi("dmi", false, m_generics),
+  g_posted("posted", false, m_generics),
+  g_shadow("shadow", false, m_generics),
+  g_trace("trace", "", m_generics),
+  m_fetch_line(NULL),
+  m_fetch_tag(0),
+  m_fetch_mask(0),
+  m_fetch_asi(0),
+  m_fetch_way(0),
+  m_fetch_valid(0),
+  m_fetch_hits(0),
+  m_code_pages(1 << 20, false),
+  m_code_unknown(false) {
     // TODO(rmeyer): This looks a lot like gs_configs!!!
 
     GC_REGISTER_TYPED_PARAM_CALLBACK(&g_gdb, gs::cnf::post_write, Leon3, g_gdb_callback);
@@ -129,6 +145,8 @@ Leon3::Leon3(
 Leon3::~Leon3() {
 
   GC_UNREGISTER_CALLBACKS();
+  // The worker thread of the core fetches through this memory
+  cpu.worker.shutdown();
 
 }
 void Leon3::init_generics(){
@@ -191,9 +209,30 @@ void Leon3::init_generics(){
 void Leon3::start_of_simulation() {
   cpu.ENTRY_POINT   = 0x0;
   cpu.MPROC_ID      = (g_hindex) << 28;
+  m_wbuf.configure(g_wbdepth, g_wbpolicy);
+  m_dmi_en = g_dmi && (m_abstractionLayer == amba::amba_LT);
+  m_posted_en = g_posted && (m_abstractionLayer == amba::amba_LT);
+  m_shadow_en = g_shadow && m_dmi_en && m_mmu_en;
+  std::string trace = g_trace;
+  if (!trace.empty() && !m_trace.create(trace.c_str())) {
+    srWarn()("file", trace)("Cannot create cache trace");
+  }
+  // Translated blocks and predecoded instructions are executed without
+  // fetching them, the trace would miss these fetches
+  if (m_trace.is_open() && (cpu.blockCacheEnabled || cpu.predecodeEnabled)) {
+    srWarn()("file", trace)("Cache trace records every fetch: block cache and predecoding are disabled");
+    cpu.blockCacheEnabled = false;
+    cpu.predecodeEnabled = false;
+  }
   g_args_callback(g_args, gs::cnf::no_callback);
 }
 
+void Leon3::end_of_simulation() {
+  // Buffered fetches have to show up in the icache statistics
+  invalidate_fetch_line();
+  mmu_cache_base::end_of_simulation();
+}
+
 void Leon3::clkcng() {
   mmu_cache_base::clkcng();
   cpu.latency = clock_cycle;
@@ -203,6 +242,9 @@ gs::cnf::callback_return_type Leon3::g_gdb_callback(gs::gs_param_base& changed_p
   int port = 0;
   changed_param.getValue(port);
   if(port) {
+    // The debugger needs every instruction issued by the SystemC process
+    cpu.parallelEnabled = false;
+    cpu.haltPoll = sc_time(100, SC_NS);
     debugger = new GDBStub<uint32_t>(*(cpu.abiIf));
     cpu.toolManager.addTool(*debugger);
     debugger->initialize(port);
@@ -221,10 +263,111 @@ gs::cnf::callback_return_type Leon3::g_args_callback(gs::gs_param_base& changed_
   m_intrinsics.set_program_args(options);
   return GC_RETURN_OK;
 }
+// Read instruction from the fetch line buffer
+bool Leon3::read_instr_local(const unsigned int & address, const unsigned int asi, unsigned int & datum) throw() {
+
+    // Fetch line buffer hit: Serve the word from the buffered icache line.
+    // Costs the same single cycle as a read hit in the icache.
+    if (m_fetch_line && asi == m_fetch_asi && (address & m_fetch_mask) == m_fetch_tag
+    && ((m_fetch_valid >> ((address & ~m_fetch_mask) >> 2)) & 0x1)) {
+      memcpy(&datum, m_fetch_line + (address & ~m_fetch_mask), sizeof(datum));
+      m_fetch_hits++;
+      trace(cachetrace::FETCH, address, asi, 4);
+      this->cpu.quantKeeper.inc(clock_cycle);
+      swapEndianess(datum);
+      return true;
+    }
+    return false;
+}
+
+bool Leon3::read_data_local(const unsigned int & address, const unsigned int asi, const unsigned int length, sc_dt::uint64 & datum) throw() {
+
+    // User and supervisor data hitting in the data cache. Scratchpads,
+    // stores still in the write buffer and watched addresses take the
+    // regular path.
+    if (((asi != 0xa) && (asi != 0xb)) || (this->debugger != NULL) || !m_wbuf.empty()
+    || (m_dlram && (((address >> 24) & 0xff) == m_dlramstart))
+    || (m_ilram && (((address >> 24) & 0xff) == m_ilramstart))) {
+      return false;
+    }
+    unsigned int way = 0, valid = 0, linesize = 0;
+    const unsigned char *line = dcache->get_line_ptr(address, asi, way, valid, linesize);
+    if (!line || !((valid >> (((address + length - 1) & (linesize - 1)) >> 2)) & 0x1)) {
+      return false;
+    }
+    sc_time delay = SC_ZERO_TIME;
+    unsigned int debug = 0;
+    if (!dcache->read_hit(address, asi, length, &delay, &debug)) {
+      return false;
+    }
+    trace(cachetrace::READ, address, asi, length);
+    this->cpu.quantKeeper.inc(delay);
+
+    // Same conversions as in the read functions
+    line += address & (linesize - 1);
+    switch (length) {
+      case 1: {
+        datum = *line;
+      } break;
+      case 2: {
+        uint16_t half;
+        memcpy(&half, line, sizeof(half));
+        swapEndianess(half);
+        datum = half;
+      } break;
+      case 4: {
+        uint32_t word;
+        memcpy(&word, line, sizeof(word));
+        swapEndianess(word);
+        datum = word;
+      } break;
+      default: {
+        memcpy(&datum, line, sizeof(datum));
+        #ifdef LITTLE_ENDIAN_BO
+        uint32_t datum1 = (uint32_t)(datum);
+        swapEndianess(datum1);
+        uint32_t datum2 = (uint32_t)(datum >> 32);
+        swapEndianess(datum2);
+        datum = datum1 | (((sc_dt::uint64)datum2) << 32);
+        #endif
+      } break;
+    }
+    return true;
+}
+
+bool Leon3::write_postable(const unsigned int & address, const unsigned int asi) throw() {
+    // Untranslated user and supervisor data stores do not trap. Stores of
+    // the other ASIs change caches, MMU or registers.
+    return ((asi == 0xa) || (asi == 0xb)) && (this->debugger == NULL) && !mmu_translates();
+}
+
+// Fetch of an instruction the cpu keeps decoded
+bool Leon3::read_instr_hit(const unsigned int & address, const unsigned int asi) throw() {
+
+    // The fetch is only saved if it would hit in the icache. The icache
+    // counts the hit and updates its replacement state, the cpu charges
+    // the cycle.
+    if (!m_icen || (m_ilram && (((address >> 24) & 0xff) == m_ilramstart))) {
+      return false;
+    }
+    sc_time delay = SC_ZERO_TIME;
+    unsigned int debug = 0;
+    return icache->read_hit(address, asi, 4, &delay, &debug);
+}
+
 // Read instruction
 unsigned int Leon3::read_instr(const unsigned int & address, const unsigned int asi, const unsigned int flush) throw() {
 
     unsigned int datum = 0;
+
+    if (!flush && read_instr_local(address, asi, datum)) {
+      if(this->cpu.quantKeeper.need_sync()){
+        this->cpu.quantKeeper.sync();
+      }
+      return datum;
+    }
+    invalidate_fetch_line();
+
     sc_time delay = this->cpu.quantKeeper.get_local_time();
     unsigned int debug = 0;
     exec_instr(
@@ -236,6 +379,23 @@ unsigned int Leon3::read_instr(const unsigned int & address, const unsigned int
         delay,
         false);
 
+    // Refill the fetch line buffer from the icache. The scratchpad is left
+    // to the regular path.
+    if (g_fetchbuffer && m_icen && !(m_ilram && (((address >> 24) & 0xff) == m_ilramstart))) {
+      unsigned int linesize = 0;
+      m_fetch_line = icache->get_line_ptr(address, asi, m_fetch_way, m_fetch_valid, linesize);
+      if (m_fetch_line) {
+        m_fetch_mask = ~(linesize - 1);
+        m_fetch_tag = address & m_fetch_mask;
+        m_fetch_asi = asi;
+      }
+    }
+
+    // Fetches go to the decoder, unless served from the fetch line buffer
+    if (this->cpu.predecodeEnabled || this->cpu.blockCacheEnabled) {
+      code_fetched(address, asi);
+    }
+
     //Now lets keep track of time
     this->cpu.quantKeeper.set(delay);
     if(this->cpu.quantKeeper.need_sync()){
@@ -264,6 +424,7 @@ sc_dt::uint64 Leon3::read_dword(
     uint32_t debug = 0;
     tlm::tlm_response_status response = tlm::TLM_INCOMPLETE_RESPONSE;
 
+    check_fetch_line(asi, flush);
     exec_data(
         tlm::TLM_READ_COMMAND,
         address,
@@ -306,6 +467,7 @@ uint32_t Leon3::read_word(
     uint32_t debug = 0;
     tlm::tlm_response_status response = tlm::TLM_INCOMPLETE_RESPONSE;
 
+    check_fetch_line(asi, flush);
     exec_data(
         tlm::TLM_READ_COMMAND,
         address,
@@ -349,6 +511,7 @@ uint16_t Leon3::read_half(
     uint32_t debug = 0;
     tlm::tlm_response_status response = tlm::TLM_INCOMPLETE_RESPONSE;
 
+    check_fetch_line(asi, flush);
     exec_data(
         tlm::TLM_READ_COMMAND,
         address,
@@ -387,6 +550,7 @@ uint8_t Leon3::read_byte(
     uint32_t debug = 0;
     tlm::tlm_response_status response = tlm::TLM_INCOMPLETE_RESPONSE;
 
+    check_fetch_line(asi, flush);
     exec_data(
         tlm::TLM_READ_COMMAND,
         address,
@@ -430,6 +594,7 @@ void Leon3::write_dword(
     uint32_t debug = 0;
     tlm::tlm_response_status response = tlm::TLM_INCOMPLETE_RESPONSE;
 
+    check_fetch_line(asi, flush);
     exec_data(
         tlm::TLM_WRITE_COMMAND,
         address,
@@ -443,6 +608,8 @@ void Leon3::write_dword(
         false,
         response);
 
+    code_written(address, sizeof(datum), asi);
+
     //Now lets keep track of time
     this->cpu.quantKeeper.set(delay);
     if(this->cpu.quantKeeper.need_sync()){
@@ -469,6 +636,7 @@ void Leon3::write_word(
     unsigned int debug = 0;
     tlm::tlm_response_status response = tlm::TLM_INCOMPLETE_RESPONSE;
 
+    check_fetch_line(asi, flush);
     exec_data(
         tlm::TLM_WRITE_COMMAND,
         address,
@@ -482,6 +650,8 @@ void Leon3::write_word(
         false,
         response);
 
+    code_written(address, sizeof(datum), asi);
+
     v::debug << name() << "Wrote word:0x" << hex << v::setw(8) << v::setfill('0')
              << datum << ", at:0x" << hex << v::setw(8) << v::setfill('0')
              << address << endl;
@@ -513,6 +683,7 @@ void Leon3::write_half(
     uint32_t debug = 0;
     tlm::tlm_response_status response = tlm::TLM_INCOMPLETE_RESPONSE;
 
+    check_fetch_line(asi, flush);
     exec_data(
         tlm::TLM_WRITE_COMMAND,
         address,
@@ -526,6 +697,8 @@ void Leon3::write_half(
         false,
         response);
 
+    code_written(address, sizeof(datum), asi);
+
     // Now lets keep track of time
     this->cpu.quantKeeper.set(delay);
     if(this->cpu.quantKeeper.need_sync()){
@@ -548,6 +721,7 @@ void Leon3::write_byte(
     uint32_t debug = 0;
     tlm::tlm_response_status response = tlm::TLM_INCOMPLETE_RESPONSE;
 
+    check_fetch_line(asi, flush);
     exec_data(
         tlm::TLM_WRITE_COMMAND,
         address,
@@ -561,6 +735,8 @@ void Leon3::write_byte(
         false,
         response);
 
+    code_written(address, sizeof(datum), asi);
+
     //Now lets keep track of time
     this->cpu.quantKeeper.set(delay);
     if(this->cpu.quantKeeper.need_sync()){
@@ -695,6 +871,8 @@ void Leon3::write_dword_dbg(const uint32_t &address, sc_dt::uint64 datum) throw(
         delay,
         true,
         response);
+
+    code_written(address, sizeof(datum), 0x8);
 }
 
 void Leon3::write_word_dbg(const uint32_t &address, uint32_t datum) throw() {
@@ -719,6 +897,8 @@ void Leon3::write_word_dbg(const uint32_t &address, uint32_t datum) throw() {
         delay,
         true,
         response);
+
+    code_written(address, sizeof(datum), 0x8);
 }
 
 void Leon3::write_half_dbg(const uint32_t &address, uint16_t datum) throw() {
@@ -742,6 +922,8 @@ void Leon3::write_half_dbg(const uint32_t &address, uint16_t datum) throw() {
         delay,
         true,
         response);
+
+    code_written(address, sizeof(datum), 0x8);
 }
 
 void Leon3::write_byte_dbg(const uint32_t &address, uint8_t datum) throw() {
@@ -761,6 +943,8 @@ void Leon3::write_byte_dbg(const uint32_t &address, uint8_t datum) throw() {
         delay,
         true,
         response);
+
+    code_written(address, sizeof(datum), 0x8);
 }
 
 void Leon3::lock() {
@@ -771,6 +955,119 @@ void Leon3::unlock() {
 
 }
 
+void Leon3::flush_instr(const unsigned int & address) throw() {
+  // FLUSH operates on the whole page holding address
+  invalidate_fetch_line();
+  cpu.invalidateCode(address & ~0xfff, 0x1000);
+}
+
+void Leon3::drain_writes() throw() {
+  sc_time delay = cpu.quantKeeper.get_local_time();
+  drain_write_buffer(&delay);
+  cpu.quantKeeper.set(delay);
+}
+
+void Leon3::invalidate_fetch_line() {
+  if (m_fetch_hits) {
+    icache->add_read_hits(m_fetch_way, m_fetch_hits);
+    m_fetch_hits = 0;
+  }
+  m_fetch_line = NULL;
+}
+
+void Leon3::snoopingCallBack(const t_snoop& snoop, const sc_core::sc_time& delay) {
+  mmu_cache_base::snoopingCallBack(snoop, delay);
+  // Own writes are handled in the write functions
+  if (snoop.master_id != m_master_id) {
+    if (mmu_translates()) {
+      // Decoded code is indexed by virtual address, the snooped address is
+      // physical
+      code_phys_written(snoop.address, snoop.length, true);
+    } else {
+      cpu.invalidateForeignCode(snoop.address, snoop.length);
+    }
+    // Shared memory traffic narrows the adaptive quantum
+    cpu.quantKeeper.disturb();
+  }
+}
+
+bool Leon3::mmu_translates() {
+  unsigned int mmu_ctrl = m_mmu_en? m_mmu->read_mcr() : 0;
+  #ifdef LITTLE_ENDIAN_BO
+  swap_Endianess(mmu_ctrl);
+  #endif
+  return (mmu_ctrl & 0x1) != 0;
+}
+
+void Leon3::code_fetched(unsigned int address, unsigned int asi) {
+  if (!mmu_translates()) {
+    return;
+  }
+  uint64_t paddr = 0;
+  bool cacheable = false;
+  if (m_mmu->tlb_probe(address, asi, 0, &paddr, cacheable)) {
+    unsigned int page = (unsigned int)(paddr >> 12) & 0xfffff;
+    if (!m_code_pages[page]) {
+      m_code_pages[page] = true;
+      m_code_page_list.push_back(page);
+    }
+  } else {
+    m_code_unknown = true;
+  }
+}
+
+void Leon3::code_written(unsigned int address, unsigned int length, unsigned int asi) {
+  if ((asi == 0x18) || (asi == 0x19)) {
+    // TLB flush or MMU register write: virtual code addresses may be
+    // mapped differently from now on
+    code_flush(false);
+  } else if (mmu_translates()) {
+    if (m_code_page_list.empty() && !m_code_unknown) {
+      return;
+    }
+    uint64_t paddr = address;
+    bool cacheable = false;
+    if ((asi == 0x1c) || m_mmu->tlb_probe(address, 0xa | (asi & 0x1), 1, &paddr, cacheable)) {
+      code_phys_written(paddr, length, false);
+    } else {
+      // The page the store went to is unknown
+      code_flush(false);
+    }
+  } else {
+    cpu.invalidateCode(address, length);
+  }
+}
+
+void Leon3::code_phys_written(uint64_t paddr, unsigned int length, bool foreign) {
+  bool hit = m_code_unknown;
+  for (uint64_t page = paddr >> 12; !hit && (page <= ((paddr + length - 1) >> 12)); page++) {
+    hit = m_code_pages[page & 0xfffff];
+  }
+  if (hit) {
+    code_flush(foreign);
+  }
+}
+
+void Leon3::code_flush(bool foreign) {
+  if (!foreign) {
+    cpu.flushCode();
+  } else {
+    cpu.flushForeignCode();
+    if (cpu.worker.running()) {
+      // The worker may still decode from the fetch line buffer; the pages
+      // stay recorded
+      return;
+    }
+  }
+  // Lines in the fetch line buffer may belong to pages no longer recorded
+  invalidate_fetch_line();
+  for (unsigned int i = 0; i < m_code_page_list.size(); i++) {
+    m_code_pages[m_code_page_list[i]] = false;
+  }
+  m_code_page_list.clear();
+  m_code_unknown = false;
+}
+
 void Leon3::trigger_exception(unsigned int exception) {
   // somehow trigger the exception in the CPU
   v::info << name() << "Going to trigger exception " << exception << v::endl;
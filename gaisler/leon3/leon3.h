@@ -95,6 +95,7 @@ class Leon3 :
       ~Leon3();
       void init_generics();
       void start_of_simulation();
+      void end_of_simulation();
       virtual void clkcng();
       gs::cnf::callback_return_type g_gdb_callback(gs::gs_param_base& changed_param, gs::cnf::callback_type reason);
       gs::cnf::callback_return_type g_history_callback(gs::gs_param_base& changed_param, gs::cnf::callback_type reason);
@@ -106,6 +107,10 @@ class Leon3 :
       virtual unsigned short int read_half( const unsigned int & address, const unsigned int asi, const unsigned int flush, const unsigned int lock ) throw();
       virtual unsigned char read_byte( const unsigned int & address, const unsigned int asi, const unsigned int flush, const unsigned int lock ) throw();
       virtual unsigned int read_instr( const unsigned int & address, const unsigned int asi, const unsigned int flush) throw();
+      virtual bool read_instr_local( const unsigned int & address, const unsigned int asi, unsigned int & datum) throw();
+      virtual bool read_instr_hit( const unsigned int & address, const unsigned int asi) throw();
+      virtual bool read_data_local( const unsigned int & address, const unsigned int asi, const unsigned int length, sc_dt::uint64 & datum) throw();
+      virtual bool write_postable( const unsigned int & address, const unsigned int asi) throw();
       virtual sc_dt::uint64 read_dword_dbg( const unsigned int & address ) throw();
       virtual unsigned int read_word_dbg( const unsigned int & address ) throw();
       virtual unsigned short int read_half_dbg( const unsigned int & address ) throw();
@@ -120,7 +125,40 @@ class Leon3 :
       virtual void write_byte_dbg( const unsigned int & address, unsigned char datum ) throw();
       virtual void lock();
       virtual void unlock();
+      virtual void flush_instr(const unsigned int & address) throw();
+      /// Issues the stores held in the write buffer; called by the quantum
+      /// keeper of the cpu before it synchronizes
+      virtual void drain_writes() throw();
       virtual void trigger_exception(unsigned int exception);
+      /// Invalidates predecoded code written by other bus masters
+      virtual void snoopingCallBack(const t_snoop& snoop, const sc_core::sc_time& delay);
+
+      /// Drops the fetch line buffer and hands the buffered hits to the icache
+      void invalidate_fetch_line();
+
+      /// True if the MMU translates data and instruction addresses
+      bool mmu_translates();
+
+      /// Records the physical page of a fetch for the decoder
+      void code_fetched(unsigned int address, unsigned int asi);
+
+      /// Invalidates decoded code after a store of the cpu
+      void code_written(unsigned int address, unsigned int length, unsigned int asi);
+
+      /// Drops all decoded code if a write to a physical address hits one
+      /// of the recorded code pages (MMU enabled only)
+      void code_phys_written(uint64_t paddr, unsigned int length, bool foreign);
+
+      /// Drops all decoded code and forgets the recorded code pages
+      void code_flush(bool foreign);
+
+      /// Drops the fetch line buffer if a data access may change the icache
+      /// (flush, cache control, diagnostic and MMU ASIs)
+      inline void check_fetch_line(unsigned int asi, unsigned int flush) {
+        if (m_fetch_line && (flush || asi < 0x8 || asi > 0xb)) {
+          invalidate_fetch_line();
+        }
+      }
 
     LEON3 cpu;
     GDBStub<uint32_t> *debugger;
@@ -167,6 +205,58 @@ class Leon3 :
     //sr_param<uint32_t> g_hindex;
     sr_param<std::vector<std::string> > g_args;
     sr_param<std::string> g_stdout_filename;
+    /// Enables the instruction fetch line buffer (off by default)
+    sr_param<bool> g_fetchbuffer;
+    /// Burst window of the write buffer in words
+    sr_param<uint32_t> g_wbdepth;
+    /// Drain policy of the write buffer (0 off, 1 lazy, 2 full)
+    sr_param<uint32_t> g_wbpolicy;
+    /// Enables direct reads from memories granting DMI
+    sr_param<bool> g_dmi;
+    /// Issues LT stores on the cpu thread (needs a decoupled AHBCtrl)
+    sr_param<bool> g_posted;
+    /// Enables the shadow TLB for loads (needs MMU and DMI)
+    sr_param<bool> g_shadow;
+    /// File receiving the cache access trace (no trace if empty)
+    sr_param<std::string> g_trace;
+
+  private:
+    // Instruction fetch line buffer
+    // -----------------------------
+    // Holds the icache line of the last fetch. Sequential fetches hitting the
+    // line are served from the host pointer without running through
+    // exec_instr and the icache. Their hits are counted and handed to the
+    // icache statistics in bulk once the buffer is left.
+
+    /// Host pointer to the data of the buffered icache line (NULL if empty)
+    const unsigned char *m_fetch_line;
+    /// Line aligned address of the buffered line
+    unsigned int m_fetch_tag;
+    /// Mask selecting the line address bits
+    unsigned int m_fetch_mask;
+    /// ASI of the fetch which filled the buffer
+    unsigned int m_fetch_asi;
+    /// Cache way of the buffered line
+    unsigned int m_fetch_way;
+    /// Valid words of the buffered line
+    unsigned int m_fetch_valid;
+    /// Fetches served from the buffer, not yet accounted in the icache
+    uint64_t m_fetch_hits;
+
+    // Decoded code pages
+    // ------------------
+    // Decoded instructions and blocks are indexed by virtual address. While
+    // the MMU translates, a store may reach decoded code through another
+    // mapping, and bus writes only carry physical addresses. Hence the
+    // physical pages fetched for the decoder are recorded, and a write
+    // into any of them drops all decoded code.
+
+    /// Recorded physical 4 kB pages (modulo 4 GB)
+    std::vector<bool> m_code_pages;
+    /// Pages set in m_code_pages
+    std::vector<unsigned int> m_code_page_list;
+    /// Set if the page of a fetch could not be determined
+    bool m_code_unknown;
 };
 
 #endif //__MMU_CACHE_H__
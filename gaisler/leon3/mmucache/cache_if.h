@@ -56,6 +56,29 @@ class cache_if : public mem_if {
 	// Helper functions for definition of clock cycle
 	virtual void clkcng(sc_core::sc_time &clk) = 0;
 
+        /// Returns a host pointer to the data of the valid cache line holding
+        /// address (fetch line buffer support), or NULL if the access has to take
+        /// the full lookup path. way, valid and linesize return the hit way, the
+        /// mask of valid words in the line and the line size in bytes.
+        virtual const unsigned char *get_line_ptr(unsigned int address, unsigned int asi,
+                                                  unsigned int &way, unsigned int &valid,
+                                                  unsigned int &linesize) {
+            return NULL;
+        }
+
+        /// Accounts read hits served from a line handed out by get_line_ptr
+        virtual void add_read_hits(unsigned int way, uint64_t hits) {
+        }
+
+        /// Accounts a read of len bytes at address, served outside the cache,
+        /// as a read hit with the timing, statistics and replacement update
+        /// of mem_read. Returns false (and accounts nothing) if the read
+        /// would miss or has to take the full lookup path.
+        virtual bool read_hit(unsigned int address, unsigned int asi, unsigned int len,
+                              sc_core::sc_time * t, unsigned int * debug) {
+            return false;
+        }
+
         // debug and helper functions
         // --------------------------
         /// display of cache lines for debug
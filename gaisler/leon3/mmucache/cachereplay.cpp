@@ -0,0 +1,414 @@
+// vim : set fileencoding=utf-8 expandtab noai ts=4 sw=4 :
+/// @addtogroup mmu_cache
+/// @{
+/// @file cachereplay.cpp
+/// Offline cache design space exploration. Replays a cache access trace,
+/// as written by mmu_cache_base (conf.mmu_cache.trace), through a range of
+/// instruction and data cache configurations in a single pass and prints
+/// hit, miss and power figures for each of them.
+///
+/// @date 2026
+/// @copyright All rights reserved.
+///            Any reproduction, use, distribution or disclosure of this
+///            program, without the express, prior written consent of the
+///            authors is strictly prohibited.
+/// @author agent
+///
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <boost/program_options.hpp>
+
+#include "core/common/systemc.h"
+#include "core/common/sr_param.h"
+#include "core/common/sr_report.h"
+#include "core/common/verbose.h"
+#include "gaisler/leon3/mmucache/cachetrace.h"
+#include "gaisler/leon3/mmucache/mmu_cache_if.h"
+#include "gaisler/leon3/mmucache/ivectorcache.h"
+#include "gaisler/leon3/mmucache/dvectorcache.h"
+
+// Every configuration is a real ivectorcache or dvectorcache. The caches of
+// all configurations see each trace event one after the other, so that one
+// pass over the trace serves the whole sweep. Stack distance analysis is
+// not used: it only holds for LRU, while the caches also replace LRR and
+// random and keep per word valid bits.
+
+/// Memory and cache control seen by the replayed caches. Stands in for
+/// both the mmu_cache and the tlb_adaptor: reads return the cacheability
+/// of the traced access and the cache control register follows the trace.
+class replay_memory : public mmu_cache_if {
+
+ public:
+
+  replay_memory() : m_ccr(0), m_cacheable(true) {
+  }
+
+  unsigned int read_ccr(bool internal) {
+    return m_ccr;
+  }
+
+  bool mem_read(uint32_t addr, uint32_t asi, uint8_t * data,
+                uint32_t length, sc_core::sc_time * t,
+                uint32_t * debug, bool is_dbg, bool &cacheable, bool is_lock = false) {
+    cacheable = m_cacheable;
+    return m_cacheable;
+  }
+
+  void mem_write(uint32_t addr, uint32_t asi, uint8_t * data,
+                 uint32_t length, sc_core::sc_time * t,
+                 uint32_t * debug, bool is_dbg, bool &cacheable, bool is_lock = false) {
+    cacheable = m_cacheable;
+  }
+
+  /// Cache control register
+  unsigned int m_ccr;
+
+  /// Cacheability of the access being replayed
+  bool m_cacheable;
+
+};
+
+/// Geometry of a replayed cache
+struct t_geometry {
+  unsigned int ways;
+  unsigned int waysize;
+  unsigned int linesize;
+  unsigned int repl;
+};
+
+/// Replayed cache: gives the sweep access to the statistics of the cache
+template<class CACHE>
+class replay_cache : public CACHE {
+
+ public:
+
+  replay_cache(sc_core::sc_module_name name, replay_memory *memory, const t_geometry &geometry) :
+    CACHE(name, memory, memory, 0, geometry.ways, geometry.waysize, 0,
+          geometry.linesize, geometry.repl, 0, 0, 0, true),
+    m_geometry(geometry) {
+
+    this->power_model();
+
+  }
+
+  uint64_t read_hits() {
+    uint64_t hits = 0;
+    for (unsigned int i = 0; i <= this->m_sets; i++) {
+      hits += this->rhits[i];
+    }
+    return hits;
+  }
+
+  uint64_t write_hits() {
+    uint64_t hits = 0;
+    for (unsigned int i = 0; i <= this->m_sets; i++) {
+      hits += this->whits[i];
+    }
+    return hits;
+  }
+
+  uint64_t read_misses() {
+    return this->rmisses;
+  }
+
+  uint64_t write_misses() {
+    return this->wmisses;
+  }
+
+  /// Dynamic energy of all tag and data ram accesses
+  double dyn_energy() {
+    return (this->dyn_tag_read_energy * this->dyn_tag_reads) +
+           (this->dyn_tag_write_energy * this->dyn_tag_writes) +
+           (this->dyn_data_read_energy * this->dyn_data_reads) +
+           (this->dyn_data_write_energy * this->dyn_data_writes);
+  }
+
+  /// Prints one row of the result table
+  void print(std::ostream &out, const char *type, bool csv) {
+    static const char *repl_names[] = { "direct", "lru", "lrr", "random" };
+    uint64_t rh = read_hits();
+    uint64_t rm = read_misses();
+    uint64_t wh = write_hits();
+    uint64_t wm = write_misses();
+    double rate = (rh + rm)? (double)rh / (double)(rh + rm) : 0.0;
+    double sta = this->sta_power;
+    uint64_t tr = this->dyn_tag_reads;
+    uint64_t tw = this->dyn_tag_writes;
+    uint64_t dr = this->dyn_data_reads;
+    uint64_t dw = this->dyn_data_writes;
+
+    if (csv) {
+      out << type << "," << m_geometry.ways << "," << m_geometry.waysize << ","
+          << m_geometry.linesize << "," << repl_names[this->m_repl] << ","
+          << rh << "," << rm << "," << rate << "," << wh << "," << wm << ","
+          << tr << "," << tw << "," << dr << "," << dw << ","
+          << dyn_energy() << "," << sta << std::endl;
+    } else {
+      out << std::setw(6) << type << std::setw(5) << m_geometry.ways
+          << std::setw(8) << m_geometry.waysize << std::setw(9) << m_geometry.linesize
+          << std::setw(7) << repl_names[this->m_repl]
+          << std::setw(13) << rh << std::setw(12) << rm
+          << std::setw(9) << std::fixed << std::setprecision(4) << rate
+          << std::setw(13) << wh << std::setw(12) << wm
+          << std::setw(13) << tr << std::setw(13) << tw
+          << std::setw(13) << dr << std::setw(13) << dw
+          << std::setw(13) << std::scientific << std::setprecision(3) << dyn_energy()
+          << std::setw(11) << sta << std::endl;
+    }
+  }
+
+ private:
+
+  t_geometry m_geometry;
+
+};
+
+typedef replay_cache<ivectorcache> replay_icache;
+typedef replay_cache<dvectorcache> replay_dcache;
+
+/// Parses a comma separated list of numbers
+static std::vector<unsigned int> parse_list(const std::string &list) {
+  std::vector<unsigned int> result;
+  std::stringstream in(list);
+  std::string item;
+  while (std::getline(in, item, ',')) {
+    if (!item.empty()) {
+      result.push_back(strtoul(item.c_str(), NULL, 0));
+    }
+  }
+  return result;
+}
+
+/// Returns all valid geometries of the sweep. Direct mapped caches
+/// replace nothing, LRR needs exactly two ways.
+static std::vector<t_geometry> geometries(const std::vector<unsigned int> &ways,
+                                          const std::vector<unsigned int> &waysizes,
+                                          const std::vector<unsigned int> &linesizes,
+                                          const std::vector<unsigned int> &repls) {
+  std::vector<t_geometry> result;
+  for (unsigned int w = 0; w < ways.size(); w++) {
+    if (ways[w] < 1 || ways[w] > 4) {
+      continue;
+    }
+    for (unsigned int s = 0; s < waysizes.size(); s++) {
+      if (waysizes[s] < 1 || waysizes[s] > 256 || (waysizes[s] & (waysizes[s] - 1))) {
+        continue;
+      }
+      for (unsigned int l = 0; l < linesizes.size(); l++) {
+        if (linesizes[l] != 4 && linesizes[l] != 8) {
+          continue;
+        }
+        if (ways[w] == 1) {
+          t_geometry g = { ways[w], waysizes[s], linesizes[l], 0 };
+          result.push_back(g);
+          continue;
+        }
+        for (unsigned int r = 0; r < repls.size(); r++) {
+          if (repls[r] < 1 || repls[r] > 3 || (repls[r] == 2 && ways[w] != 2)) {
+            continue;
+          }
+          t_geometry g = { ways[w], waysizes[s], linesizes[l], repls[r] };
+          result.push_back(g);
+        }
+      }
+    }
+  }
+  return result;
+}
+
+/// Unique module name of a replayed cache
+static std::string cache_name(const char *type, const t_geometry &g) {
+  std::stringstream name;
+  name << type << "_w" << g.ways << "_s" << g.waysize << "_l" << g.linesize << "_r" << g.repl;
+  return name.str();
+}
+
+int sc_main(int argc, char** argv) {
+  sr_report_handler::handler = sr_report_handler::default_handler;
+
+  gs::ctr::GC_Core       core;
+  gs::cnf::ConfigDatabase cnfdatabase("ConfigDatabase");
+  gs::cnf::ConfigPlugin configPlugin(&cnfdatabase);
+
+  boost::program_options::options_description desc("Replays a cache access trace through a range of cache configurations", 120);
+  desc.add_options()
+  ("help,h", "produces the help message")
+  ("trace,t", boost::program_options::value<std::string>(),
+  "trace file written with conf.mmu_cache.trace")
+  ("caches,c", boost::program_options::value<std::string>()->default_value("id"),
+  "caches to explore: i (instruction), d (data) or id")
+  ("ways,w", boost::program_options::value<std::string>()->default_value("1,2,4"),
+  "numbers of ways (1-4), comma separated")
+  ("waysize,s", boost::program_options::value<std::string>()->default_value("1,2,4,8,16,32"),
+  "way sizes in kB (power of two, 1-256), comma separated")
+  ("linesize,l", boost::program_options::value<std::string>()->default_value("4,8"),
+  "line sizes in words (4 or 8), comma separated")
+  ("repl,r", boost::program_options::value<std::string>()->default_value("1,3"),
+  "replacement strategies of multi-way caches (1 LRU, 2 LRR, 3 random), comma separated")
+  ("csv", "prints the results comma separated")
+  ;
+
+  boost::program_options::variables_map vm;
+  try {
+    boost::program_options::store(boost::program_options::parse_command_line(argc, argv, desc), vm);
+    boost::program_options::notify(vm);
+  } catch(boost::program_options::error &e) {
+    std::cerr << "ERROR in parsing the command line parameters" << std::endl << std::endl;
+    std::cerr << e.what() << std::endl << std::endl;
+    std::cerr << desc << std::endl;
+    return -1;
+  }
+
+  if (vm.count("help") != 0) {
+    std::cout << desc << std::endl;
+    return 0;
+  }
+  if (vm.count("trace") == 0) {
+    std::cerr << "It is necessary to specify the trace file using the --trace option" << std::endl << std::endl;
+    std::cerr << desc << std::endl;
+    return -1;
+  }
+
+  cachetrace trace;
+  std::string path = vm["trace"].as<std::string>();
+  if (!trace.open(path.c_str())) {
+    std::cerr << "Cannot open cache trace " << path << std::endl;
+    return -1;
+  }
+
+  std::string caches = vm["caches"].as<std::string>();
+  std::vector<t_geometry> sweep = geometries(parse_list(vm["ways"].as<std::string>()),
+                                             parse_list(vm["waysize"].as<std::string>()),
+                                             parse_list(vm["linesize"].as<std::string>()),
+                                             parse_list(vm["repl"].as<std::string>()));
+  bool csv = vm.count("csv") != 0;
+
+  // The caches are plain objects here; the simulation is never started
+  replay_memory memory;
+  std::vector<replay_icache *> icaches;
+  std::vector<replay_dcache *> dcaches;
+  for (unsigned int i = 0; i < sweep.size(); i++) {
+    if (caches.find('i') != std::string::npos) {
+      icaches.push_back(new replay_icache(cache_name("ic", sweep[i]).c_str(), &memory, sweep[i]));
+    }
+    if (caches.find('d') != std::string::npos) {
+      dcaches.push_back(new replay_dcache(cache_name("dc", sweep[i]).c_str(), &memory, sweep[i]));
+    }
+  }
+
+  if (icaches.empty() && dcaches.empty()) {
+    std::cerr << "No valid cache configuration selected" << std::endl;
+    return -1;
+  }
+
+  // Replay
+  t_trace_record r;
+  unsigned char data[8] = { 0 };
+  unsigned int debug = 0;
+  bool cacheable;
+  t_snoop snoop;
+  sc_core::sc_time delay;
+
+  while (trace.next(r)) {
+
+    unsigned int type = r.type & cachetrace::TYPE_MASK;
+    memory.m_cacheable = !(r.type & cachetrace::UNCACHEABLE);
+
+    switch (type) {
+
+    case cachetrace::FETCH:
+      for (unsigned int i = 0; i < icaches.size(); i++) {
+        cacheable = true;
+        icaches[i]->mem_read(r.address, r.asi, data, 4, &delay, &debug, false, cacheable, false);
+      }
+      break;
+
+    case cachetrace::READ:
+      if (r.length > sizeof(data)) {
+        break;
+      }
+      for (unsigned int i = 0; i < dcaches.size(); i++) {
+        cacheable = true;
+        dcaches[i]->mem_read(r.address, r.asi, data, r.length, &delay, &debug, false, cacheable, false);
+      }
+      break;
+
+    case cachetrace::WRITE:
+      if (r.length > sizeof(data)) {
+        break;
+      }
+      for (unsigned int i = 0; i < dcaches.size(); i++) {
+        cacheable = true;
+        dcaches[i]->mem_write(r.address, r.asi, data, r.length, &delay, &debug, false, cacheable, false);
+      }
+      break;
+
+    case cachetrace::FLUSH:
+      if (r.asi & 0x1) {
+        for (unsigned int i = 0; i < icaches.size(); i++) {
+          icaches[i]->flush(&delay, &debug, false);
+        }
+      }
+      if (r.asi & 0x2) {
+        for (unsigned int i = 0; i < dcaches.size(); i++) {
+          dcaches[i]->flush(&delay, &debug, false);
+        }
+      }
+      break;
+
+    case cachetrace::SNOOP:
+      snoop.master_id = 0;
+      snoop.address = r.address;
+      snoop.length = r.length;
+      for (unsigned int i = 0; i < dcaches.size(); i++) {
+        dcaches[i]->snoop_invalidate(snoop, delay);
+      }
+      break;
+
+    case cachetrace::CCR:
+      memory.m_ccr = r.address;
+      break;
+
+    default:
+      break;
+    }
+
+    // Time does not matter to the statistics
+    delay = sc_core::SC_ZERO_TIME;
+  }
+
+  // Results
+  std::cout << "Replayed " << trace.m_records << " events of " << path << std::endl;
+  if (csv) {
+    std::cout << "cache,ways,waysize,linesize,repl,read_hits,read_misses,read_hit_rate,"
+              << "write_hits,write_misses,tag_reads,tag_writes,data_reads,data_writes,"
+              << "dyn_energy,sta_power" << std::endl;
+  } else {
+    std::cout << std::setw(6) << "cache" << std::setw(5) << "ways"
+              << std::setw(8) << "waysize" << std::setw(9) << "linesize"
+              << std::setw(7) << "repl"
+              << std::setw(13) << "read_hits" << std::setw(12) << "read_misses"
+              << std::setw(9) << "rd_rate"
+              << std::setw(13) << "write_hits" << std::setw(12) << "wr_misses"
+              << std::setw(13) << "tag_reads" << std::setw(13) << "tag_writes"
+              << std::setw(13) << "data_reads" << std::setw(13) << "data_writes"
+              << std::setw(13) << "dyn_energy" << std::setw(11) << "sta_power" << std::endl;
+  }
+  for (unsigned int i = 0; i < icaches.size(); i++) {
+    icaches[i]->print(std::cout, "icache", csv);
+    delete icaches[i];
+  }
+  for (unsigned int i = 0; i < dcaches.size(); i++) {
+    dcaches[i]->print(std::cout, "dcache", csv);
+    delete dcaches[i];
+  }
+
+  return 0;
+}
+/// @}
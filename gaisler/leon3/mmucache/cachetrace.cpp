@@ -0,0 +1,131 @@
+// vim : set fileencoding=utf-8 expandtab noai ts=4 sw=4 :
+/// @addtogroup mmu_cache
+/// @{
+/// @file cachetrace.cpp
+/// Implementation of the cache access trace.
+///
+/// @date 2026
+/// @copyright All rights reserved.
+///            Any reproduction, use, distribution or disclosure of this
+///            program, without the express, prior written consent of the
+///            authors is strictly prohibited.
+/// @author agent
+///
+
+#include "gaisler/leon3/mmucache/cachetrace.h"
+
+/// Constructor - no file open
+cachetrace::cachetrace() :
+  m_records(0),
+  m_file(NULL),
+  m_write(false),
+  m_pos(0),
+  m_fill(0) {
+
+}
+
+/// Destructor - writes outstanding records
+cachetrace::~cachetrace() {
+
+  close();
+
+}
+
+// Creates a trace file and writes the header
+bool cachetrace::create(const char *path) {
+
+  uint32_t header[2] = { MAGIC, VERSION };
+
+  close();
+
+  m_file = fopen(path, "wb");
+  if (!m_file) {
+    return false;
+  }
+
+  if (fwrite(header, sizeof(header), 1, m_file) != 1) {
+    fclose(m_file);
+    m_file = NULL;
+    return false;
+  }
+
+  m_write = true;
+  m_pos = 0;
+  m_records = 0;
+  return true;
+
+}
+
+// Opens a trace file and checks the header
+bool cachetrace::open(const char *path) {
+
+  uint32_t header[2];
+
+  close();
+
+  m_file = fopen(path, "rb");
+  if (!m_file) {
+    return false;
+  }
+
+  if ((fread(header, sizeof(header), 1, m_file) != 1) ||
+      (header[0] != MAGIC) || (header[1] != VERSION)) {
+    fclose(m_file);
+    m_file = NULL;
+    return false;
+  }
+
+  m_write = false;
+  m_pos = 0;
+  m_fill = 0;
+  m_records = 0;
+  return true;
+
+}
+
+// Writes outstanding records and closes the file
+void cachetrace::close() {
+
+  if (!m_file) {
+    return;
+  }
+
+  if (m_write) {
+    write_buffer();
+  }
+
+  fclose(m_file);
+  m_file = NULL;
+
+}
+
+// Reads the next record, refilling the buffer from the file
+bool cachetrace::next(t_trace_record &r) {
+
+  if (m_pos == m_fill) {
+    if (!m_file) {
+      return false;
+    }
+    m_fill = fread(m_buffer, sizeof(t_trace_record), BUFFER_RECORDS, m_file);
+    m_pos = 0;
+    if (!m_fill) {
+      return false;
+    }
+  }
+
+  r = m_buffer[m_pos++];
+  m_records++;
+  return true;
+
+}
+
+// Writes the buffered records to the file
+void cachetrace::write_buffer() {
+
+  if (m_pos && m_file) {
+    fwrite(m_buffer, sizeof(t_trace_record), m_pos, m_file);
+  }
+  m_pos = 0;
+
+}
+/// @}
@@ -0,0 +1,127 @@
+// vim : set fileencoding=utf-8 expandtab noai ts=4 sw=4 :
+/// @addtogroup mmu_cache
+/// @{
+/// @file cachetrace.h
+/// Class definition of the cache access trace. mmu_cache_base writes the
+/// accesses reaching its caches into a trace file, the cachereplay tool
+/// reads them back and replays them through a set of cache configurations.
+///
+/// @date 2026
+/// @copyright All rights reserved.
+///            Any reproduction, use, distribution or disclosure of this
+///            program, without the express, prior written consent of the
+///            authors is strictly prohibited.
+/// @author agent
+///
+
+#ifndef __CACHETRACE_H__
+#define __CACHETRACE_H__
+
+#include <stdint.h>
+#include <stdio.h>
+
+// A trace file starts with the magic number and the format version, both
+// 32 bit in host byte order, followed by one 8 byte record per event:
+//   FETCH  - instruction fetch reaching the icache (4 bytes)
+//   READ   - load reaching the dcache, including shadow TLB loads
+//   WRITE  - store reaching the dcache
+//   FLUSH  - cache flush; the asi field selects the caches (bit 0 icache,
+//            bit 1 dcache)
+//   SNOOP  - write of another master invalidating dcache lines
+//   CCR    - new value of the cache control register, held in the address
+// Fetches, loads and stores of uncacheable memory are flagged with
+// UNCACHEABLE. Scratchpad, diagnostic and debug accesses are not traced.
+
+/// Record of a traced cache event
+struct t_trace_record {
+  /// Virtual address (CCR value for CCR records)
+  uint32_t address;
+  /// Length of the access in bytes
+  uint16_t length;
+  /// Address space identifier
+  uint8_t asi;
+  /// Event type and flags
+  uint8_t type;
+};
+
+/// @brief Binary trace of cache accesses
+class cachetrace {
+
+ public:
+
+  /// Event types
+  enum t_type { FETCH = 0, READ = 1, WRITE = 2, FLUSH = 3, SNOOP = 4, CCR = 5 };
+
+  /// Flag of accesses to uncacheable memory
+  static const uint8_t UNCACHEABLE = 0x80;
+
+  /// Mask selecting the event type
+  static const uint8_t TYPE_MASK = 0x7f;
+
+  /// 'CTRC'
+  static const uint32_t MAGIC = 0x43545243;
+
+  /// Format version
+  static const uint32_t VERSION = 1;
+
+  /// Records buffered before a file access
+  static const unsigned int BUFFER_RECORDS = 4096;
+
+  cachetrace();
+
+  ~cachetrace();
+
+  /// Creates a trace file for writing. Returns false on failure.
+  bool create(const char *path);
+
+  /// Opens a trace file for reading. Returns false on failure or if the
+  /// file is not a trace of this format.
+  bool open(const char *path);
+
+  /// Writes the buffered records and closes the file
+  void close();
+
+  /// True if a trace file is open
+  bool is_open() const {
+    return m_file != NULL;
+  }
+
+  /// Appends an event to the trace
+  inline void record(unsigned int type, unsigned int address, unsigned int asi, unsigned int length) {
+    t_trace_record &r = m_buffer[m_pos];
+    r.address = address;
+    r.length = (length > 0xffff)? 0xffff : length;
+    r.asi = asi;
+    r.type = type;
+    m_records++;
+    if (++m_pos == BUFFER_RECORDS) {
+      write_buffer();
+    }
+  }
+
+  /// Reads the next event. Returns false at the end of the trace.
+  bool next(t_trace_record &r);
+
+  /// Number of records written or read
+  uint64_t m_records;
+
+ private:
+
+  /// Writes the buffered records to the file
+  void write_buffer();
+
+  /// Trace file (NULL if closed)
+  FILE *m_file;
+  /// True if the file is written
+  bool m_write;
+  /// Position in the buffer
+  unsigned int m_pos;
+  /// Number of records in the buffer (reading only)
+  unsigned int m_fill;
+  /// Record buffer
+  t_trace_record m_buffer[BUFFER_RECORDS];
+
+};
+
+#endif // __CACHETRACE_H__
+/// @}
@@ -12,6 +12,28 @@ class cpu_if {
     virtual uint16_t read_half(const uint32_t &address, const uint32_t asi = 0xA, const uint32_t flush = 0, const uint32_t lock = 0) throw() = 0;
     virtual uint8_t read_byte(const uint32_t &address, const uint32_t asi = 0xA, const uint32_t flush = 0, const uint32_t lock = 0) throw() = 0;
     virtual uint32_t read_instr(const uint32_t &address, const uint32_t asi = 0xA, const uint32_t flush = 0) throw() = 0;
+    /// Serves an instruction fetch without leaving the cpu, i.e. without any
+    /// bus access or synchronization. Returns false if read_instr is needed.
+    virtual bool read_instr_local(const uint32_t &address, const uint32_t asi, uint32_t &datum) throw() {
+        return false;
+    }
+    /// Serves a load of length bytes which hits in the data cache without
+    /// leaving the cpu. datum is set as the read function of that size
+    /// returns it. Returns false if the regular read is needed.
+    virtual bool read_data_local(const uint32_t &address, const uint32_t asi, const uint32_t length, sc_dt::uint64 &datum) throw() {
+        return false;
+    }
+    /// True if a store may be carried out later than the cpu issues it,
+    /// i.e. it can neither trap nor change how later accesses are handled
+    virtual bool write_postable(const uint32_t &address, const uint32_t asi) throw() {
+        return false;
+    }
+    /// Accounts a fetch the cpu saved by keeping the instruction decoded
+    /// as an icache read hit; the cpu charges its cycle. Returns false if
+    /// the fetch would not hit, read_instr has to carry it out then.
+    virtual bool read_instr_hit(const uint32_t &address, const uint32_t asi) throw() {
+        return true;
+    }
     virtual sc_dt::uint64 read_dword_dbg(const uint32_t &address) {
         return this->read_dword(address, 0x8, 0, 0);
     }
@@ -50,6 +72,11 @@ class cpu_if {
 
     virtual void lock() = 0;
     virtual void unlock() = 0;
+    /// Called by the FLUSH instruction: code at address may have been modified
+    virtual void flush_instr(const uint32_t &address) throw() {}
+    /// Called before the cpu synchronizes with SystemC: stores held back
+    /// by the memory subsystem have to be issued
+    virtual void drain_writes() throw() {}
     inline void swapEndianess(uint32_t & datum) const throw() {
         uint8_t helperByte = 0;
         for(uint32_t i = 0; i < sizeof(uint32_t)/2; i++){
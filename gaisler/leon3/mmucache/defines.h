@@ -197,65 +197,188 @@ class t_cache_data : public sc_object, public scireg_ns::scireg_region_if {
     }
 };
 
-// cacheline consists of tag and up to 8 entries (depending on configuration)
-//typedef struct {
-class t_cache_line : public sc_module, public scireg_ns::scireg_region_if {
+// scireg view of a cache line. The cache keeps its tags and data in flat
+// arrays (see vectorcache); the views are only created on request of a
+// scireg client and refer to that storage.
+class t_cache_line_view : public scireg_ns::scireg_region_if {
   public:
-        sr_register_bank<uint32_t, uint32_t> tag;
-        t_cache_data entry;
-
-        t_cache_line(sc_core::sc_object &parent, sc_module_name name, const uint32_t linesize) :
-          sc_module(name),
+    /// Tag fields of the line at the offsets of the former tag register bank
+    class tag_view : public scireg_ns::scireg_region_if {
+      public:
+        tag_view(const std::string &name) :
           scireg_ns::scireg_region_if(),
-          tag("tag"),
-          entry("entry", linesize) {
-            this->parent = &parent;
-            tag.create_register(
-                "valid",      // name
-                VALID,        // addr
-                0,            // init value
-                0xFFFFFFFF); // write mask
-            tag.create_register(
-                "atag",       // name
-                ATAG,         // addr
-                0,            // init value
-                0xFFFFFFFF); // write mask
-            tag.create_register(
-                "lrr",        // name
-                LRR,          // addr
-                0,            // init value
-                0xFFFFFFFF); // write mask
-            tag.create_register(
-                "lru",        // name
-                LRU,          // addr
-                0,            // init value
-                0xFFFFFFFF); // write mask
-            tag.create_register(
-                "lock",       // name
-                LOCK,         // addr
-                0,            // init value
-                0xFFFFFFFF); // write mask
-            srDebug()("name", name)("create");
+          m_name(name) {
+            for (uint32_t i = 0; i < 5; i++) {
+              field[i] = NULL;
+            }
           }
 
-        /// Get the region_type of this region:
         virtual scireg_ns::scireg_response scireg_get_region_type(scireg_ns::scireg_region_type& t) const {
           t = scireg_ns::SCIREG_BANK;
           return scireg_ns::SCIREG_SUCCESS;
         }
 
-        static const uint32_t VALID ;
-        static const uint32_t ATAG  ;
-        static const uint32_t LRR   ;
-        static const uint32_t LRU   ;
-        static const uint32_t LOCK  ;
+        virtual scireg_ns::scireg_response scireg_write(const scireg_ns::vector_byte& v, sc_dt::uint64 size, sc_dt::uint64 offset=0) {
+          if (offset + size > 5 * 4) {
+            return scireg_ns::SCIREG_FAILURE;
+          }
+          for (sc_dt::uint64 i = 0; i < size; i++) {
+            reinterpret_cast<uint8_t *>(field[(offset + i) >> 2])[(offset + i) & 3] = v[i];
+          }
+          return scireg_ns::SCIREG_SUCCESS;
+        }
+
+        virtual scireg_ns::scireg_response scireg_read(scireg_ns::vector_byte& v, sc_dt::uint64 size, sc_dt::uint64 offset=0) const {
+          if (offset + size > 5 * 4) {
+            return scireg_ns::SCIREG_FAILURE;
+          }
+          for (sc_dt::uint64 i = 0; i < size; i++) {
+            v[i] = reinterpret_cast<const uint8_t *>(field[(offset + i) >> 2])[(offset + i) & 3];
+          }
+          return scireg_ns::SCIREG_SUCCESS;
+        }
+
+        virtual sc_dt::uint64 scireg_get_bit_width() const {
+          return 5 * 4 * 8;
+        }
 
-  protected:
-        sc_core::sc_object *parent;
+        virtual scireg_ns::scireg_response scireg_get_string_attribute(const char *& s, scireg_ns::scireg_string_attribute_type t) const {
+          if (t == scireg_ns::SCIREG_NAME) {
+            s = m_name.c_str();
+            return scireg_ns::SCIREG_SUCCESS;
+          }
+          return scireg_ns::SCIREG_UNSUPPORTED;
+        }
 
-};
+        /// Fields in the order valid, atag, lrr, lru, lock
+        uint32_t *field[5];
+
+      private:
+        std::string m_name;
+    };
+
+    /// Data of the line; observers registered here are called by the cache
+    class data_view : public scireg_ns::scireg_region_if {
+      public:
+        data_view(const std::string &name, uint8_t *data, uint32_t size) :
+          scireg_ns::scireg_region_if(),
+          m_name(name),
+          m_data(data),
+          m_size(size) {}
+
+        virtual scireg_ns::scireg_response scireg_get_region_type(scireg_ns::scireg_region_type& t) const {
+          t = scireg_ns::SCIREG_MEMORY;
+          return scireg_ns::SCIREG_SUCCESS;
+        }
+
+        virtual scireg_ns::scireg_response scireg_write(const scireg_ns::vector_byte& v, sc_dt::uint64 size, sc_dt::uint64 offset=0) {
+          memcpy(&m_data[offset], static_cast<const uint8_t *>(&v[0]), size);
+          return scireg_ns::SCIREG_SUCCESS;
+        }
+
+        virtual scireg_ns::scireg_response scireg_read(scireg_ns::vector_byte& v, sc_dt::uint64 size, sc_dt::uint64 offset=0) const {
+          memcpy(static_cast<uint8_t *>(&v[0]), &m_data[offset], size);
+          return scireg_ns::SCIREG_SUCCESS;
+        }
+
+        virtual sc_dt::uint64 scireg_get_bit_width() const {
+          return m_size * 8;
+        }
+
+        scireg_ns::scireg_response scireg_add_callback(scireg_ns::scireg_callback &cb) {
+          callback_vector.push_back(&cb);
+          return scireg_ns::SCIREG_SUCCESS;
+        }
+
+        scireg_ns::scireg_response scireg_remove_callback(scireg_ns::scireg_callback& cb) {
+          ::std::vector<scireg_ns::scireg_callback*>::iterator it;
+          it = find(callback_vector.begin(), callback_vector.end(), &cb);
+          if (it != callback_vector.end())
+            callback_vector.erase(it);
+          return scireg_ns::SCIREG_SUCCESS;
+        }
+
+        virtual scireg_ns::scireg_response scireg_get_string_attribute(const char *& s, scireg_ns::scireg_string_attribute_type t) const {
+          if (t == scireg_ns::SCIREG_NAME) {
+            s = m_name.c_str();
+            return scireg_ns::SCIREG_SUCCESS;
+          }
+          return scireg_ns::SCIREG_UNSUPPORTED;
+        }
+
+        bool has_callbacks() const {
+          return !callback_vector.empty();
+        }
+
+        void execute_callbacks(const scireg_ns::scireg_callback_type &type, const uint32_t &offset, const uint32_t &size) {
+          scireg_ns::scireg_callback* p;
+          ::std::vector<scireg_ns::scireg_callback*>::iterator it;
+          for (it = callback_vector.begin(); it != callback_vector.end(); ++it)
+          {
+            p = *it;
+            if (p->type == type) {
+              p->offset = offset;
+              p->size = size;
+              p->do_callback(*this);
+            }
+          }
+        }
+
+      private:
+        std::string m_name;
+        uint8_t *m_data;
+        uint32_t m_size;
+        ::std::vector<scireg_ns::scireg_callback*> callback_vector;
+    };
+
+    t_cache_line_view(const std::string &name, uint8_t *data, uint32_t size) :
+      scireg_ns::scireg_region_if(),
+      tag(name + ".tag"),
+      entry(name + ".entry", data, size),
+      m_name(name) {
+        m_children[0].region = &tag;
+        m_children[0].offset = 0;
+        m_children[0].name = "tag";
+        m_children[1].region = &entry;
+        m_children[1].offset = 0;
+        m_children[1].name = "entry";
+      }
+
+    virtual scireg_ns::scireg_response scireg_get_region_type(scireg_ns::scireg_region_type& t) const {
+      t = scireg_ns::SCIREG_BANK;
+      return scireg_ns::SCIREG_SUCCESS;
+    }
+
+    virtual scireg_ns::scireg_response scireg_get_child_regions(
+        std::vector<scireg_ns::scireg_mapped_region>& mapped_regions,
+        sc_dt::uint64 size=sc_dt::uint64(-1), sc_dt::uint64 offset=0) const {
+      mapped_regions.push_back(m_children[0]);
+      mapped_regions.push_back(m_children[1]);
+      return scireg_ns::SCIREG_SUCCESS;
+    }
+
+    virtual scireg_ns::scireg_response scireg_get_string_attribute(const char *& s, scireg_ns::scireg_string_attribute_type t) const {
+      if (t == scireg_ns::SCIREG_NAME) {
+        s = m_name.c_str();
+        return scireg_ns::SCIREG_SUCCESS;
+      }
+      return scireg_ns::SCIREG_UNSUPPORTED;
+    }
 
-//} t_cache_line;
+    tag_view tag;
+    data_view entry;
+
+    /// Offsets of the tag fields in the tag view
+    static const uint32_t VALID ;
+    static const uint32_t ATAG  ;
+    static const uint32_t LRR   ;
+    static const uint32_t LRU   ;
+    static const uint32_t LOCK  ;
+
+  private:
+    std::string m_name;
+    scireg_ns::scireg_mapped_region m_children[2];
+};
 
 // structure of a tlb entry (page descriptor cache entry)
 // ========================
@@ -274,10 +397,39 @@ typedef struct {
   unsigned int tlb_no;
   unsigned int context;
   unsigned int pte;
-  uint64_t lru;
+  unsigned int vaddr;
   uint64_t page_size;
 } t_PTE_context;
 
+// page descriptor cache
+// ========================
+// The entries are kept in a fixed array of up to 32 entries (itlbnum/dtlbnum).
+// Bit i of 'valid' marks entry i as filled, bit i of 'lru' marks it as
+// recently used (bitmask LRU). 'micro' holds the entries which translated the
+// last two pages for each access type (index ASI[1-0]: user/supervisor
+// instruction, user/supervisor data). It is a host side shortcut and only
+// points into the array, so entries never have to be invalidated there.
+typedef struct {
+  t_PTE_context entry[32];
+  uint32_t valid;
+  uint32_t lru;
+  unsigned char micro[4][2];
+} t_tlb;
+
+// memoized table walk
+// ========================
+// Result of a successful page table walk for a virtual page (VPN) and
+// context. The walk is replayed from here as long as none of the page
+// table memory has been written (see mmu::walk_snoop).
+typedef struct {
+  bool valid;
+  unsigned int vpn;
+  unsigned int context;
+  unsigned int pte;
+  uint64_t page_size;
+  sc_core::sc_time latency;
+} t_walk;
+
 // virtual address tag
 typedef unsigned int t_VAT;
 
@@ -39,10 +39,12 @@ mmu::mmu(ModuleName name, // sysc module name,
 	    m_pseudo_rand(0),
 	    m_pow_mon(pow_mon),
             m_performance_counters("performance_counters"),
-            tihits("instruction_tlb_hits", 8, m_performance_counters),
-            tdhits("data_tlb_hits", 8, m_performance_counters),
+            tihits("instruction_tlb_hits", itlbnum, m_performance_counters),
+            tdhits("data_tlb_hits", dtlbnum, m_performance_counters),
             timisses("instruction_tlb_misses", 0ull, m_performance_counters),
             tdmisses("data_tlb_misses", 0ull, m_performance_counters),
+            tuhits("micro_tlb_hits", 0ull, m_performance_counters),
+            twhits("memoized_walks", 0ull, m_performance_counters),
             sta_power_norm("power.mmu_cache.mmu.sta_power_norm", 7.19e+7, true), // Normalized static power of controller
             int_power_norm("power.mmu_cache.mmu.int_power_norm", 3.74e-8, true), // Normalized static power of controller
             sta_tlb_power_norm("power.mmu_cache.mmu.tlb_power_norm", 6543750, true), // Normalized static power of tlb
@@ -81,16 +83,16 @@ mmu::mmu(ModuleName name, // sysc module name,
     MMU_FAULT_STATUS_REG = 0;
     MMU_FAULT_ADDRESS_REG = 0;
 
-    // generate associative memory (map) for instruction tlb
-    itlb = new std::map<t_VAT, t_PTE_context>;
+    // generate associative memory for instruction tlb
+    itlb = new t_tlb;
     itlb_adaptor = new tlb_adaptor("itlb_adaptor", _mmu_cache, this, itlb,
             m_itlbnum);
 
     // are we in split tlb mode?
     if (m_tlb_type == 0x0) {
 
-        // generate another associative memory (map) for data tlb
-        dtlb = new std::map<t_VAT, t_PTE_context>;
+        // generate another associative memory for data tlb
+        dtlb = new t_tlb;
         dtlb_adaptor = new tlb_adaptor("dtlb_adaptor", _mmu_cache, this, dtlb,
                 m_dtlbnum);
 
@@ -157,14 +159,24 @@ mmu::mmu(ModuleName name, // sysc module name,
     //PM::registerIP(this,"mmu",m_pow_mon);
     //PM::send_idle(this,"idle",sc_time_stamp(),m_pow_mon);
 
+    // Start with empty TLBs
+    memset(itlb, 0, sizeof(t_tlb));
+    memset(dtlb, 0, sizeof(t_tlb));
+    walk_flush();
+
     // Init execution statistic
-    for (uint32_t i=0; i<8; i++) {
+    for (uint32_t i=0; i<m_itlbnum; i++) {
       tihits[i] = 0;
+    }
+
+    for (uint32_t i=0; i<m_dtlbnum; i++) {
       tdhits[i] = 0;
     }
 
     timisses = 0;
     tdmisses = 0;
+    tuhits = 0;
+    twhits = 0;
 
     // Register power callback functions
     if (m_pow_mon) {
@@ -207,13 +219,106 @@ mmu::~mmu() {
 }
 
 
+// Walks the page tables of the current context (tlb miss processing)
+signed mmu::table_walk( unsigned * pde, uint64_t * page_size,
+                        unsigned idx1, unsigned idx2, unsigned idx3,
+                        unsigned * debug, bool is_dbg, sc_core::sc_time * t, unsigned * pde_REMOVE ) {
+
+    unsigned pde_ptr;
+    bool cacheable_mem;
+
+    // **************************************
+    // Context-Table lookup
+    // **************************************
+
+    pde_ptr = (MMU_CONTEXT_TABLE_POINTER_REG << 4) + (MMU_CONTEXT_REG << 2);
+    m_mmu_cache->mem_read(pde_ptr, 0x8, (unsigned char *)pde, 4, t, debug, is_dbg, cacheable_mem,  false);
+    walk_watch(pde_ptr);
+    #ifdef LITTLE_ENDIAN_BO
+    swap_Endianess(*pde);
+    #endif
+    *pde_REMOVE = *pde;
+
+    *page_size = 0x0; // -1 -> 0xFFFFFFFFFFFFFFFF (uint64_t) :-)
+    switch( *pde & 0x3 ) {
+    default:
+    case 0: // Invalid
+      return 1 << 2;                                        // L: Level 0, FT: Invalid address error
+    case 2: // L0 PTE -> shouldn't possibly not happen
+    case 3: // Reserved
+      return 4 << 2;                                        // L: Level 0, FT: Translation error
+    
+    case 1: // 1. load from 1st-level page table
+        pde_ptr = ((*pde & ~3) << 4)+(idx1 << 2);
+        m_mmu_cache->mem_read(pde_ptr, 0x8, (unsigned char *)pde, 4, t, debug, is_dbg, cacheable_mem, false);
+        walk_watch(pde_ptr);
+        #ifdef LITTLE_ENDIAN_BO
+        swap_Endianess(*pde);
+        #endif
+        *pde_REMOVE = *pde;
+
+        switch( *pde & 0x3 ) {
+        case 0: // Invalid
+            return (1 << 8) | (1 << 2);                     // L: Level 1, FT: Invalid address error
+        case 3: // Reserved
+            return (1 << 8) | (4 << 2);                     // L: Level 1, FT: Translation error
+
+        default:
+        case 1: // 2. load from 2nd-level page table
+            pde_ptr = (((*pde & ~0x3) << 4) + (idx2 << 2));
+            m_mmu_cache->mem_read( pde_ptr, 0x8, (unsigned char *)pde, 4, t, debug, is_dbg, cacheable_mem, false);
+            walk_watch(pde_ptr);
+            #ifdef LITTLE_ENDIAN_BO
+            swap_Endianess(*pde);
+            #endif
+            *pde_REMOVE = *pde;
+
+            switch( *pde & 0x3 ) {
+            default:
+            case 0: // Invalid
+                return (2 << 8) | (1 << 2);                 // L: Level 2, FT: Invalid address error
+            case 3: // Reserved
+                return (2 << 8) | (4 << 2);                 // L: Level 2, FT: Translation error
+
+            case 1: // 3. load from 3rd-level page table
+                pde_ptr = (((*pde & ~0x3) << 4) + (idx3<<2));
+                m_mmu_cache->mem_read( pde_ptr, 0x8, (unsigned char *)pde, 4, t, debug, is_dbg, cacheable_mem, false);
+                walk_watch(pde_ptr);
+                #ifdef LITTLE_ENDIAN_BO
+                swap_Endianess(*pde);
+                #endif
+                *pde_REMOVE = *pde;
+
+                switch( *pde & 0x3 ) {
+                case 0: // Invalid
+                    return (3 << 8) | (1 << 2);             // L: Level 3, FT: Invalid address error
+                case 1: // PDE -> should not happen
+                case 3: // Reserved
+                    return (3 << 8) | (4 << 2);             // L: Level 3, FT: Translation error
+                case 2:
+                    break;
+                }
+                *page_size = 0x1000;
+                break;
+            case 2:
+                *page_size = 0x40000;
+            }
+            break;
+        case 2:
+            *page_size = 0x1000000;
+        }
+    }
+
+    return 0;
+}
+
+
 signed mmu::get_physical_address( uint64_t * paddr, signed * prot, unsigned * access_index,
                                   uint64_t vaddr, int asi, uint64_t * page_size,
                                   unsigned * debug, bool is_dbg, sc_core::sc_time * t, unsigned is_write, unsigned * pde_REMOVE ) {
 
     signed access_perms = 0, error_code = 0, is_dirty, is_user;
-    unsigned pde_ptr, pde;
-    bool cacheable_mem;
+    unsigned pde;
 
     // According to the SparcV8 Manual: Pages of the Reference MMU are always aligned on 4K-byte boundaries; hence, the lower-order
     // 12 bits of a physical address are always the same as the low-order 12 bits of
@@ -289,80 +394,41 @@ signed mmu::get_physical_address( uint64_t * paddr, signed * prot, unsigned * ac
             << vaddr << " with indices 1/2/3: " << idx1 << "/" << idx2 << "/" << idx3 << " for context: " << MMU_CONTEXT_REG << v::endl;
 
     // **************************************
-    // Context-Table lookup
+    // Memoized table walks
     // **************************************
 
-    pde_ptr = (MMU_CONTEXT_TABLE_POINTER_REG << 4) + (MMU_CONTEXT_REG << 2);
-    m_mmu_cache->mem_read(pde_ptr, 0x8, (unsigned char *)&pde, 4, t, debug, is_dbg, cacheable_mem,  false);
-    #ifdef LITTLE_ENDIAN_BO
-    swap_Endianess(pde);
-    #endif
-    *pde_REMOVE = pde;
+    t_walk * walk = &m_walks[vpn & (WALK_ENTRIES - 1)];
 
-    *page_size = 0x0; // -1 -> 0xFFFFFFFFFFFFFFFF (uint64_t) :-)
-    switch( pde & 0x3 ) {
-    default:
-    case 0: // Invalid
-      return 1 << 2;                                        // L: Level 0, FT: Invalid address error
-    case 2: // L0 PTE -> shouldn't possibly not happen
-    case 3: // Reserved
-      return 4 << 2;                                        // L: Level 0, FT: Translation error
-    
-    case 1: // 1. load from 1st-level page table
-        pde_ptr = ((pde & ~3) << 4)+(idx1 << 2);
-        m_mmu_cache->mem_read(pde_ptr, 0x8, (unsigned char *)&pde, 4, t, debug, is_dbg, cacheable_mem, false);
-        #ifdef LITTLE_ENDIAN_BO
-        swap_Endianess(pde);
-        #endif
+    if (walk->valid && (walk->vpn == vpn) && (walk->context == MMU_CONTEXT_REG)) {
+
+        // The descriptors of the walk have not been written since. Its
+        // transfer time is charged without issuing the transactions.
+        pde = walk->pte;
+        *page_size = walk->page_size;
         *pde_REMOVE = pde;
 
-        switch( pde & 0x3 ) {
-        case 0: // Invalid
-            return (1 << 8) | (1 << 2);                     // L: Level 1, FT: Invalid address error
-        case 3: // Reserved
-            return (1 << 8) | (4 << 2);                     // L: Level 1, FT: Translation error
+        if (! is_dbg) {
+            *t += walk->latency;
+        }
+        twhits++;
 
-        default:
-        case 1: // 2. load from 2nd-level page table
-            pde_ptr = (((pde & ~0x3) << 4) + (idx2 << 2));
-            m_mmu_cache->mem_read( pde_ptr, 0x8, (unsigned char *)&pde, 4, t, debug, is_dbg, cacheable_mem, false);
-            #ifdef LITTLE_ENDIAN_BO
-            swap_Endianess(pde);
-            #endif
-            *pde_REMOVE = pde;
+    } else {
 
-            switch( pde & 0x3 ) {
-            default:
-            case 0: // Invalid
-                return (2 << 8) | (1 << 2);                 // L: Level 2, FT: Invalid address error
-            case 3: // Reserved
-                return (2 << 8) | (4 << 2);                 // L: Level 2, FT: Translation error
+        sc_core::sc_time start = *t;
 
-            case 1: // 3. load from 3rd-level page table
-                pde_ptr = (((pde & ~0x3) << 4) + (idx3<<2));
-                m_mmu_cache->mem_read( pde_ptr, 0x8, (unsigned char *)&pde, 4, t, debug, is_dbg, cacheable_mem, false);
-                #ifdef LITTLE_ENDIAN_BO
-                swap_Endianess(pde);
-                #endif
-                *pde_REMOVE = pde;
+        error_code = table_walk( &pde, page_size, idx1, idx2, idx3, debug, is_dbg, t, pde_REMOVE );
+        if( error_code ) {
+            return error_code;
+        }
 
-                switch( pde & 0x3 ) {
-                case 0: // Invalid
-                    return (3 << 8) | (1 << 2);             // L: Level 3, FT: Invalid address error
-                case 1: // PDE -> should not happen
-                case 3: // Reserved
-                    return (3 << 8) | (4 << 2);             // L: Level 3, FT: Translation error
-                case 2:
-                    break;
-                }
-                *page_size = 0x1000;
-                break;
-            case 2:
-                *page_size = 0x40000;
-            }
-            break;
-        case 2:
-            *page_size = 0x1000000;
+        // Debug walks do not know the transfer time
+        if (! is_dbg) {
+            walk->valid = true;
+            walk->vpn = vpn;
+            walk->context = MMU_CONTEXT_REG;
+            walk->pte = pde;
+            walk->page_size = *page_size;
+            walk->latency = *t - start;
         }
     }
 
@@ -452,7 +518,7 @@ data_access_exception
 // look up a tlb (page descriptor cache)
 // and return physical address
 signed mmu::tlb_lookup(unsigned int addr, unsigned asi,
-                             std::map<t_VAT, t_PTE_context> * tlb,
+                             t_tlb * tlb,
                              unsigned int tlb_size, sc_core::sc_time * t,
                              unsigned int * debug, bool is_dbg, bool &cacheable,
                              unsigned is_write /* LOAD / STORE? */, uint64_t * paddr ) {
@@ -462,105 +528,105 @@ signed mmu::tlb_lookup(unsigned int addr, unsigned asi,
     Out of those, only the ASIs 0x8, 0x9, 0xA, 0xB will enter this routine!
 */
 
-    // According to the SparcV8 Manual: Pages of the Reference MMU are always aligned on 4K-byte boundaries; hence, the lower-order
-    // 12 bits of a physical address are always the same as the low-order 12 bits of
-    // the virtual address. The Gaisler MMU additionally supports 8k, 16k and 32k alignment,
-//    unsigned int offset = ((addr << m_vtag_width) >> m_vtag_width);
-    t_VAT vpn = (addr >> (32 - m_vtag_width));
-
-    
     // Locals for intermediate results
-    t_PTE_context tmp;
+    t_PTE_context * tmp;
     *paddr = 0xffffffffffff0000ULL; // has size of 36bits!
     unsigned int pde;
+    signed tlb_no = -1;
 
-/*
-    // Search virtual address tag in ipdc (associative)
-    v::debug << this->name() << "Access with ADDR: " << std::hex << addr << " VPN: " << std::hex << vpn
-            << " and OFFSET: " << std::hex << offset << v::endl;
-    pdciter = tlb->find(vpn);
-
-    // Log tlb reads for power monitoring
-    if (m_pow_mon) {
-      // All tlbs are read in parallel !
-      if (tlb == itlb) {
-        dyn_itlb_reads += tlb_size;
-      } else {
-        dyn_dtlb_reads += tlb_size;
-      }
-    }
+    // Access type: ASI[1-0] selects user/supervisor instruction/data
+    unsigned int type = asi & 0x3;
 
-    // TLB hit
-    if (pdciter != tlb->end()) {
+    // AT (Access Type) as built by get_physical_address
+    unsigned int at = (is_write << 2) | ((~asi) & 0x2) | (asi & 0x1);
 
-      // Read the PDC entry
-      tmp = pdciter->second;
+    // TD - with the TLB disabled every access walks the page tables
+    bool tlb_en = !(MMU_CONTROL_REG & (1 << 15));
 
-      v::debug << this->name() << "Virtual Address Tag Hit in TLB " << tmp.tlb_no << " for address: "
-                << hex << addr << v::endl;
+    if (tlb_en) {
 
-        // Check the context tag
-        if (tmp.context == MMU_CONTEXT_REG) {
+      // Log tlb reads for power monitoring
+      if (m_pow_mon) {
+        // All tlbs are read in parallel !
+        if (tlb == itlb) {
+          dyn_itlb_reads += tlb_size;
+        } else {
+          dyn_dtlb_reads += tlb_size;
+        }
+      }
 
-            v::debug << this->name() << "CONTEXT hit " << hex << MMU_CONTEXT_REG << v::endl;
+      // The micro TLB remembers the entries which translated the last two
+      // pages of this access type. It only saves the search of the array.
+      for (unsigned int i = 0; i < 2; i++) {
 
-            // Build physical address from PTE and offset, and return
-            //paddr = (((tmp.pte >> 8) << (32 - m_vtag_width)) | (addr & (tmp.page_size -1)));
-            *paddr = ((tmp.pte & ~0xff) << 4 | (addr & (tmp.page_size - 1)));
-            *paddr &= ((0x1ull << 36) - 1);
-            if ((tmp.pte & (1<<7)) == 0) {
-              v::debug << this->name() << "data not cacheable!" << v::endl;
-              cacheable = false;
-            } else {
-              cacheable = true;
-            }
+        unsigned int no = tlb->micro[type][i];
+        tmp = &tlb->entry[no];
 
-            // Update debug information
-            TLBHIT_SET(*debug);
+        if ((tlb->valid & (1u << no)) && (tmp->context == MMU_CONTEXT_REG) &&
+            ((addr & ~(tmp->page_size - 1)) == tmp->vaddr)) {
 
-            if (tlb == itlb) {
-                tihits[tmp.tlb_no]++;
-            } else {
-                tdhits[tmp.tlb_no]++;
-            }
+          tlb_no = no;
+          tuhits++;
 
-            // Update LRU history
-            if (m_tlb_rep==0) {
-                lru_update(vpn, tlb, tlb_size);
-            }
-            return 0;
-        } else {
+          // Keep the most recent page in front
+          if (i) {
+            tlb->micro[type][1] = tlb->micro[type][0];
+            tlb->micro[type][0] = no;
+          }
+          break;
+        }
+      }
 
-            v::debug << this->name() << "CONTEXT miss" << v::endl;
+      if (tlb_no < 0) {
 
-            // Update debug information
-            TLBMISS_SET(*debug);
+        // Search virtual address tag in pdc (associative)
+        tlb_no = tlb_find(addr, tlb, tlb_size);
 
-            if (tlb == itlb) {
-                timisses++;
-            } else {
-	        tdmisses++;
-            }
+        if (tlb_no >= 0) {
+          tlb->micro[type][1] = tlb->micro[type][0];
+          tlb->micro[type][0] = tlb_no;
         }
-    } else {
+      }
+
+      // TLB hit - the access permissions are checked again, a violation is
+      // reported by the table walk below.
+      if ((tlb_no >= 0) && !access_table[at][(tlb->entry[tlb_no].pte >> 2) & 0x7]) {
 
-        v::debug << this->name() << "Virtual Address Tag miss" << v::endl;
+        tmp = &tlb->entry[tlb_no];
+
+        // Build physical address from PTE and offset, and return
+        *paddr = ((tmp->pte & ~0xff) << 4 | (addr & (tmp->page_size - 1)));
+        *paddr &= ((0x1ull << 36) - 1);
+        cacheable = (tmp->pte & (1 << 7)) != 0;
 
         // Update debug information
-        TLBMISS_SET(*debug);
+        TLBHIT_SET(*debug);
 
-	      if (tlb == itlb) {
-	        timisses++;
-	      } else {
-	        tdmisses++;
-	      }
-    }
+        if (tlb == itlb) {
+          tihits[tlb_no]++;
+        } else {
+          tdhits[tlb_no]++;
+        }
 
-*/
+        // Update LRU history
+        if (m_tlb_rep == 0) {
+          lru_update(tlb_no, tlb, tlb_size);
+        }
+        return 0;
+      }
 
+      v::debug << this->name() << "TLB miss for address: " << hex << addr << v::endl;
 
+      // Update debug information
+      TLBMISS_SET(*debug);
+
+      if (tlb == itlb) {
+        timisses++;
+      } else {
+        tdmisses++;
+      }
+    }
 
-    
     uint64_t page_size;
     unsigned access_index;
     signed error_code = get_physical_address( paddr, NULL, &access_index,
@@ -637,33 +703,42 @@ signed mmu::tlb_lookup(unsigned int addr, unsigned asi,
         v::debug << this->name() << ((error_code >> 8) & 0x3) << "-Level Page Table returned PTE: "
                 << std::hex << pde << v::endl;
 
-        // In case of a virtual address tag miss a new PDC entry is created.
-        // For context miss the existing entry will be replaced.
-        if (tlb->size() == tlb_size) {
-            v::debug << this->name() << "TLB full" << std::hex << pde  << v::endl;
+        if (tlb_en) {
 
-            // Remove a TLB entry, with respect to replacement strategy
-            tmp.tlb_no = tlb_remove(tlb, tlb_size);
-        } else {
-            v::debug << this->name() << "Create new entry PDC entry - TLB number: " << tlb->size() << v::endl;
-            tmp.tlb_no = tlb->size();
-        }
+            // A page which failed the permission check on a hit keeps its
+            // entry, otherwise a new PDC entry is created.
+            if (tlb_no < 0) {
 
-        // add to PDC
-        tmp.context = MMU_CONTEXT_REG;
-        tmp.pte = pde;
-        tmp.lru = 0xffffffffffffffff - 1;
-        tmp.page_size = page_size;
+                // Free or remove a TLB entry, with respect to replacement strategy
+                tlb_no = tlb_remove(tlb, tlb_size);
+                v::debug << this->name() << "Create new PDC entry - TLB number: " << tlb_no << v::endl;
 
-        (*tlb)[vpn] = tmp;
+                tlb->micro[type][1] = tlb->micro[type][0];
+                tlb->micro[type][0] = tlb_no;
+            }
 
-        // Log TLB writes for power monitoring
-        if (m_pow_mon) {
-          if (tlb == itlb) {
-            dyn_itlb_writes++;
-          } else {
-            dyn_dtlb_writes++;
-          }
+            // add to PDC
+            tmp = &tlb->entry[tlb_no];
+            tmp->tlb_no = tlb_no;
+            tmp->context = MMU_CONTEXT_REG;
+            tmp->pte = pde;
+            tmp->vaddr = addr & ~(page_size - 1);
+            tmp->page_size = page_size;
+
+            tlb->valid |= (1u << tlb_no);
+
+            if (m_tlb_rep == 0) {
+                lru_update(tlb_no, tlb, tlb_size);
+            }
+
+            // Log TLB writes for power monitoring
+            if (m_pow_mon) {
+              if (tlb == itlb) {
+                dyn_itlb_writes++;
+              } else {
+                dyn_dtlb_writes++;
+              }
+            }
         }
 
         // build physical address from PTE and offset
@@ -751,6 +826,9 @@ void mmu::write_mctpr(unsigned int * data) {
   // [1-0] reserved, must read as zero
   MMU_CONTEXT_TABLE_POINTER_REG = (tmp & ~0x3);
 
+  // The memoized walks started from the old context table
+  walk_flush();
+
   v::debug << name() << "Write to MMU_CONTEXT_TABLE_POINTER_REG: " << hex << v::setw(8) << MMU_CONTEXT_TABLE_POINTER_REG << v::endl;
 }
 
@@ -837,27 +915,20 @@ unsigned int mmu::read_mfar() {
 // Diagnostic read of instruction PDC (ASI 0x5)
 void mmu::diag_read_itlb(unsigned int addr, unsigned int * data) {
 
-  unsigned int tmp;
-
-  t_VAT vpn = (addr >> (32 - m_vtag_width));
+  unsigned int tmp = 0;
 
-  v::debug << name() << "Diagnostic read instruction PDC with address: " << hex << addr << " VPN: " << vpn << v::endl;
+  v::debug << name() << "Diagnostic read instruction PDC with address: " << hex << addr << v::endl;
 
   // diagnostic ITLB lookup (without bus access)
   if ((addr & 0x3) == 0x3) {
 
-    pdciter = itlb->find(vpn);
+    signed tlb_no = tlb_find(addr, itlb, m_itlbnum);
 
     // found something ?
-    if (pdciter != itlb->end()) {
+    if (tlb_no >= 0) {
 
       // hit
-      tmp = ((pdciter->second).pte);
-
-    } else {
-
-      // miss
-      tmp = 0;
+      tmp = itlb->entry[tlb_no].pte;
 
     }
   }
@@ -869,94 +940,116 @@ void mmu::diag_read_itlb(unsigned int addr, unsigned int * data) {
   *data = tmp;
 }
 
-// Selects a TLB entry for replacement (LRU or RANDOM replacement).
-// Removes the selected entry from the TLB map
-// and returns the 'number' of the TLB (which is now free).
-unsigned int mmu::tlb_remove(std::map<t_VAT, t_PTE_context> * tlb, unsigned int tlb_size) {
+// Translates addr through the TLB only (shadow TLB fill)
+bool mmu::tlb_probe(unsigned int addr, unsigned int asi, unsigned int is_write,
+                    uint64_t * paddr, bool &cacheable) {
 
-  std::map<t_VAT, t_PTE_context>::iterator selector;
-  std::map<t_VAT, t_PTE_context>::iterator lru_selector;
+  // Instruction:       ASI = 0x8 or 0x9
+  // Data:              ASI = 0xA or 0xB
+  t_tlb * tlb = (asi & 0x2)? dtlb : itlb;
+  unsigned int tlb_size = (tlb == itlb)? m_itlbnum : m_dtlbnum;
+  unsigned int at = (is_write << 2) | ((~asi) & 0x2) | (asi & 0x1);
 
-  unsigned int tlb_select=0;
-  uint64_t min_lru = 0xffffffffffffffff;
+  // MMU disabled or TLB disabled (TD)
+  if (!(MMU_CONTROL_REG & 0x1) || (MMU_CONTROL_REG & (1 << 15))) {
+    return false;
+  }
 
-  uint32_t count;
+  signed tlb_no = tlb_find(addr, tlb, tlb_size);
 
-  switch(m_tlb_rep) {
+  if ((tlb_no < 0) || access_table[at][(tlb->entry[tlb_no].pte >> 2) & 0x7]) {
+    return false;
+  }
 
-    // LRU
-    case 0:
+  t_PTE_context * tmp = &tlb->entry[tlb_no];
 
-      // LRU replaces the TLB, which hasn't been used for the longest time.
+  *paddr = ((tmp->pte & ~0xff) << 4 | (addr & (tmp->page_size - 1)));
+  *paddr &= ((0x1ull << 36) - 1);
+  cacheable = (tmp->pte & (1 << 7)) != 0;
 
-      // Find the TLB with the lowest LRU value
-      for(selector = tlb->begin(); selector != tlb->end(); selector++) {
+  return true;
+}
 
-        if (selector->second.lru < min_lru) {
-          lru_selector = selector;
-          tlb_select = selector->second.tlb_no;
-          min_lru = selector->second.lru;
-        }
-      }
+// Returns the number of the TLB entry translating addr
+// in the current context, or -1 if there is none.
+signed mmu::tlb_find(unsigned int addr, t_tlb * tlb, unsigned int tlb_size) {
 
-      v::debug << this->name() << "Select TLB (LRU): " << tlb_select << " for replacement. " << v::endl;
+  for (unsigned int i = 0; i < tlb_size; i++) {
 
-      tlb->erase(lru_selector);
-      v::debug << this->name() << "Erased TLB " << tlb_select << v::endl;
+    t_PTE_context * tmp = &tlb->entry[i];
 
-      break;
+    if ((tlb->valid & (1u << i)) && (tmp->context == MMU_CONTEXT_REG) &&
+        ((addr & ~(tmp->page_size - 1)) == tmp->vaddr)) {
 
-    // Pseudo Random
-    default:
+      return i;
 
-      // Random replacement is implemented through
-      // modulo-N counter that selects the TLB entry
-      // to be removed from the PDC.
-      tlb_select = m_pseudo_rand % (tlb_size + 1);
+    }
+  }
 
-      v::debug << this->name() << "Select TLB (Random): " << tlb_select << " for replacement. " << v::endl;
+  return -1;
+}
 
-      count = 0;
+// Selects a TLB entry for replacement (LRU or RANDOM replacement).
+// Free entries are used first. Invalidates the selected entry
+// and returns the 'number' of the TLB (which is now free).
+unsigned int mmu::tlb_remove(t_tlb * tlb, unsigned int tlb_size) {
 
-      for(selector = tlb->begin(); selector != tlb->end(); selector++) {
-	        if (count == tlb_select) {
+  uint32_t all = (tlb_size < 32)? ((1u << tlb_size) - 1) : 0xffffffff;
+  uint32_t candidates = ~tlb->valid & all;
+  unsigned int tlb_select = 0;
 
-	          tlb->erase(selector);
-	          break;
+  if (!candidates) {
 
-	        }
-      }
+    switch(m_tlb_rep) {
 
-  }
+      // LRU
+      case 0:
 
-  return tlb_select;
+        // LRU replaces a TLB, which has not been used since the
+        // last reset of the history (see lru_update).
+        candidates = ~tlb->lru & all;
 
-}
+        v::debug << this->name() << "Select TLB (LRU) for replacement. " << v::endl;
 
-// LRU replacement history updater
-void mmu::lru_update(t_VAT vpn, std::map<t_VAT, t_PTE_context> * tlb, unsigned int tlb_size) {
+        break;
 
-  std::map<t_VAT, t_PTE_context>::iterator selector;
+      // Pseudo Random
+      default:
 
-  // The LRU counters of all TLBs, except the selected one (vpn),
-  // are decrement. The counter of the selected TLB is set to the maximum.
-  for (selector = tlb->begin(); selector != tlb->end(); selector++) {
+        // Random replacement is implemented through
+        // modulo-N counter that selects the TLB entry
+        // to be removed from the PDC.
+        candidates = 1u << (m_pseudo_rand++ % tlb_size);
 
-    if (selector->first != vpn) {
+        v::debug << this->name() << "Select TLB (Random) for replacement. " << v::endl;
 
-      if (selector->second.lru != 0) {
+    }
+  }
 
-        (selector->second.lru)--;
+  while (!(candidates & (1u << tlb_select))) {
+    tlb_select++;
+  }
 
-      }
+  tlb->valid &= ~(1u << tlb_select);
+  v::debug << this->name() << "Erased TLB " << tlb_select << v::endl;
 
-    } else {
+  return tlb_select;
+
+}
+
+// LRU replacement history updater
+void mmu::lru_update(unsigned int tlb_no, t_tlb * tlb, unsigned int tlb_size) {
 
-      selector->second.lru = 0xffffffffffffffff - 1;
+  uint32_t all = (tlb_size < 32)? ((1u << tlb_size) - 1) : 0xffffffff;
 
-    }
+  // Bitmask LRU: The bit of the selected TLB is set. Once all bits are set,
+  // the history is reset to the selected TLB. Hence, the TLBs with a cleared
+  // bit have been used less recently than those with a set bit.
+  tlb->lru |= (1u << tlb_no);
 
-    v::debug << name() << "TLB " << selector->second.tlb_no << " LRU " << selector->second.lru << v::endl;
+  if ((tlb->lru & all) == all) {
+
+    tlb->lru = (1u << tlb_no);
 
   }
 }
@@ -969,27 +1062,20 @@ void mmu::diag_write_itlb(unsigned int addr, unsigned int * data) {
 // Diagnostic read of data or shared instruction and data PDC (ASI 0x6)
 void mmu::diag_read_dctlb(unsigned int addr, unsigned int * data) {
 
-  unsigned int tmp;
-
-  t_VAT vpn = (addr >> (32 - m_vtag_width));
+  unsigned int tmp = 0;
 
-  v::debug << name() << "Diagnostic read data/shared PDC with address: " << hex << addr << " VPN: " << vpn << v::endl;
+  v::debug << name() << "Diagnostic read data/shared PDC with address: " << hex << addr << v::endl;
 
-  // diagnostic ITLB lookup (without bus access)
+  // diagnostic DTLB lookup (without bus access)
   if ((addr & 0x3) == 0x3) {
 
-    pdciter = dtlb->find(vpn);
+    signed tlb_no = tlb_find(addr, dtlb, (m_tlb_type == 0)? m_dtlbnum : m_itlbnum);
 
     // found something ?
-    if (pdciter != dtlb->end()) {
+    if (tlb_no >= 0) {
 
       // hit
-      tmp = (pdciter->second).pte;
-
-    } else {
-
-      // miss
-      tmp = 0;
+      tmp = dtlb->entry[tlb_no].pte;
 
     }
   }
@@ -1132,6 +1218,8 @@ void mmu::end_of_simulation() {
 
   }
 
+  v::report << name() << "* Misses served by memoized walks: " << twhits << v::endl;
+
   v::report << name() << " ******************************************** " << v::endl;
 
 }
@@ -1162,15 +1250,45 @@ void mmu::clkcng(sc_core::sc_time &clk) {
 
 /// TLB flush complete
 void mmu::tlb_flush() {
-  itlb->clear();  
-  dtlb->clear();  
+  // The micro TLBs only point to valid entries and need no flush
+  itlb->valid = 0;
+  dtlb->valid = 0;
+  // Page tables are changed before the TLB is flushed. Own stores may
+  // still be held in the write buffer, where they can not be snooped.
+  walk_flush();
   v::debug << name() << "TLB flush" << v::endl;
 };
 
 /// TLB flush certain entry
 void mmu::tlb_flush(uint32_t vpn) {
-  itlb->clear();  
-  dtlb->clear();  
+  itlb->valid = 0;
+  dtlb->valid = 0;
+  walk_flush();
   v::debug << name() << "TLB flush" << v::endl;
 }
+/// Drops the memoized walks if page table memory is written
+void mmu::walk_snoop(unsigned int addr, unsigned int length) {
+
+  unsigned int first = addr >> WALK_FILTER_SHIFT;
+  unsigned int last = (addr + ((length)? length - 1 : 0)) >> WALK_FILTER_SHIFT;
+
+  for (unsigned int block = first; block <= last; block++) {
+
+    unsigned int bit = block & (WALK_FILTER_BITS - 1);
+
+    if (m_walk_filter[bit >> 5] & (1u << (bit & 0x1f))) {
+      v::debug << name() << "Page table write at " << hex << addr << v::endl;
+      walk_flush();
+      return;
+    }
+  }
+}
+
+/// Drops all memoized walks
+void mmu::walk_flush() {
+  for (unsigned int i = 0; i < WALK_ENTRIES; i++) {
+    m_walks[i].valid = false;
+  }
+  memset(m_walk_filter, 0, sizeof(m_walk_filter));
+}
 /// @}
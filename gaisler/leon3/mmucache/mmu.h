@@ -18,7 +18,6 @@
 #ifndef __MMU_H__
 #define __MMU_H__
 
-#include <map>
 #include <math.h>
 #include "core/common/base.h"
 #include "core/common/systemc.h"
@@ -42,6 +41,18 @@ class mmu : public DefaultBase, public mmu_if {
                                   uint64_t vaddr, int asi, uint64_t * page_size,
                                   unsigned * debug, bool is_dbg, sc_core::sc_time * t, unsigned is_write, unsigned * pde_REMOVE );
 
+  /// Walks the page tables of the current context. Returns 0 or the fault
+  /// (level and fault type) like get_physical_address.
+  signed table_walk( unsigned * pde, uint64_t * page_size,
+                     unsigned idx1, unsigned idx2, unsigned idx3,
+                     unsigned * debug, bool is_dbg, sc_core::sc_time * t, unsigned * pde_REMOVE );
+
+  /// Marks the page table memory holding a descriptor read by a walk
+  void walk_watch(unsigned int addr) {
+    unsigned int bit = (addr >> WALK_FILTER_SHIFT) & (WALK_FILTER_BITS - 1);
+    m_walk_filter[bit >> 5] |= (1u << (bit & 0x1f));
+  }
+
  public:
 
   GC_HAS_CALLBACKS();
@@ -66,7 +77,7 @@ class mmu : public DefaultBase, public mmu_if {
   // ----------------
   /// Page descriptor cache (PDC) lookup
   signed tlb_lookup(unsigned int addr, unsigned asi,
-                             std::map<t_VAT, t_PTE_context> * tlb,
+                             t_tlb * tlb,
                              unsigned int tlb_size, sc_core::sc_time * t,
                              unsigned int * debug, bool is_dbg, bool &cacheable,
                              unsigned is_write /* LOAD / STORE? */, uint64_t * paddr );
@@ -97,13 +108,22 @@ class mmu : public DefaultBase, public mmu_if {
   /// Diagnostic write of data PDC or shared instruction and data PDC (ASI 0x6)
   void diag_write_dctlb(unsigned int addr, unsigned int * data);
 
-  /// Selects a TLB entry for replacement (LRU or RANDOM replacement).
-  /// Removes the selected entry from the TLB map and returns the 'number'
-  /// of the TLB (which is now free).
-  unsigned int tlb_remove(std::map<t_VAT, t_PTE_context> * tlb, unsigned int tlb_size);
+  /// Translates addr through the TLB only: no table walk, no statistics and
+  /// no LRU update. Returns false if no entry grants the access.
+  bool tlb_probe(unsigned int addr, unsigned int asi, unsigned int is_write,
+                 uint64_t * paddr, bool &cacheable);
+
+  /// Returns the number of the TLB entry translating addr in the current
+  /// context, or -1 if there is none
+  signed tlb_find(unsigned int addr, t_tlb * tlb, unsigned int tlb_size);
+
+  /// Selects a TLB entry for replacement (a free one first, then LRU or
+  /// RANDOM replacement). Invalidates the selected entry and returns the
+  /// 'number' of the TLB (which is now free).
+  unsigned int tlb_remove(t_tlb * tlb, unsigned int tlb_size);
 
   /// LRU replacement history updater
-  void lru_update(t_VAT vpn, std::map<t_VAT, t_PTE_context> * tlb, unsigned int tlb_size);
+  void lru_update(unsigned int tlb_no, t_tlb * tlb, unsigned int tlb_size);
 
   /// Return pointer to tlb instruction interface
   tlb_adaptor * get_itlb_if();
@@ -122,6 +142,13 @@ class mmu : public DefaultBase, public mmu_if {
   /// TLB flush certain entry
   void tlb_flush(uint32_t vpn);
 
+  /// Drops the memoized table walks if a bus write (snooped) may have
+  /// changed page table memory
+  void walk_snoop(unsigned int addr, unsigned int length);
+
+  /// Drops all memoized table walks
+  void walk_flush();
+
   /// Static power callback
   gs::cnf::callback_return_type sta_power_cb(gs::gs_param_base& changed_param, gs::cnf::callback_type reason);
 
@@ -153,15 +180,9 @@ class mmu : public DefaultBase, public mmu_if {
   // instruction and data tlb pointers
   // (depending on configuration may point to a shared tlb implementation)
   /// associative memory for instruction TLB (eventually also data tlb in shared mode)
-  std::map<t_VAT, t_PTE_context> * itlb;
+  t_tlb * itlb;
   /// associative memory for data TLB (not used in shared mode)
-  std::map<t_VAT, t_PTE_context> * dtlb;
-
-  /// iterator for PDC lookup
-  std::map<t_VAT, t_PTE_context>::iterator pdciter;
-
-  /// helper for tlb handling
-  t_PTE_context * m_current_PTE_context;
+  t_tlb * dtlb;
 
   // mmu internal registers
   // ----------------------
@@ -300,6 +321,27 @@ class mmu : public DefaultBase, public mmu_if {
   /// Pseudo random counter for LRU
   uint32_t m_pseudo_rand;
 
+  // Memoized table walks
+  // --------------------
+  // Successful walks are kept per context and virtual page (direct mapped).
+  // A walk replayed from here charges the transfer time of the original
+  // walk. The filter marks the 64 byte blocks of memory holding the
+  // descriptors read by walks (hashed). Any write to a marked block drops
+  // all walks, as does a TLB flush or a new context table pointer.
+
+  /// Number of memoized table walks
+  static const unsigned int WALK_ENTRIES = 256;
+  /// Block size of the page table filter (log2)
+  static const unsigned int WALK_FILTER_SHIFT = 6;
+  /// Number of blocks in the page table filter
+  static const unsigned int WALK_FILTER_BITS = 32768;
+
+  /// Memoized table walks
+  t_walk m_walks[WALK_ENTRIES];
+
+  /// Page table filter
+  uint32_t m_walk_filter[WALK_FILTER_BITS / 32];
+
   /// Power Monitoring enabled?
   bool m_pow_mon;
 
@@ -322,6 +364,12 @@ class mmu : public DefaultBase, public mmu_if {
   sr_param<uint64_t> timisses;
   sr_param<uint64_t> tdmisses;
 
+  /// Number of TLB hits served by the micro TLB
+  sr_param<uint64_t> tuhits;
+
+  /// Number of TLB misses served by memoized table walks
+  sr_param<uint64_t> twhits;
+
 
   // *****************************************************
   // Power Modeling Parameters
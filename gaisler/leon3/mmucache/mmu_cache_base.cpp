@@ -94,6 +94,15 @@ mmu_cache_base::mmu_cache_base(
 
     wb_pointer = 0;
     globl_count = 0;
+    m_wb_regions = 0;
+    m_bus_free = SC_ZERO_TIME;
+    m_posted_en = false;
+    m_posted_writes = 0;
+    m_dmi_en = false;
+    m_dmi_reads = 0;
+    m_shadow_en = false;
+    m_shadow_loads = 0;
+    memset(m_shadow, 0, sizeof(m_shadow));
 
     // Parameter checks
     // ----------------
@@ -142,6 +151,9 @@ mmu_cache_base::mmu_cache_base(
 
     SC_THREAD(mem_access);
 
+    // Memories may withdraw the regions granted for direct access
+    ahb.register_invalidate_direct_mem_ptr(this, &mmu_cache_base::invalidate_direct_mem_ptr);
+
     // Register power callback functions
     if (m_pow_mon) {
 
@@ -186,10 +198,24 @@ void mmu_cache_base::exec_instr(const unsigned int &addr, unsigned char *ptr, un
 
     icache->mem_read((unsigned int)addr, asi, ptr, 4, &delay, debug, is_dbg, cacheable, false);
 
+    if (!is_dbg) {
+      trace(cachetrace::FETCH, addr, asi, 4, cacheable);
+    }
+
   }
 }
 
 void mmu_cache_base::exec_data(const tlm::tlm_command cmd, const unsigned int &addr, unsigned char *ptr, unsigned int len, unsigned int asi, unsigned int *debug, unsigned int flush, unsigned int lock, sc_core::sc_time& delay, bool is_dbg, tlm::tlm_response_status &response) {
+  // Loads from pages in the shadow TLB bypass TLB, cache and bus
+  if (m_shadow_en && (cmd == tlm::TLM_READ_COMMAND) && !flush && !lock && !is_dbg &&
+      shadow_read(addr, asi, ptr, len, delay, debug)) {
+
+    trace(cachetrace::READ, addr, asi, len);
+    response = (tlm::TLM_OK_RESPONSE);
+    return;
+
+  }
+
   srDebug()("addr", addr)("len", len)("asi", asi)("flush", flush)("lock", lock)("delay", delay)("is_dbg", is_dbg)(__PRETTY_FUNCTION__);
   // Flush instruction
   if (flush) {
@@ -199,6 +225,9 @@ void mmu_cache_base::exec_data(const tlm::tlm_command cmd, const unsigned int &a
     // Simultaneous flush of both caches
     icache->flush(&delay, debug, is_dbg);
     dcache->flush(&delay, debug, is_dbg);
+    if (!is_dbg) {
+      trace(cachetrace::FLUSH, addr, 0x3, 0);
+    }
 
     response = (tlm::TLM_OK_RESPONSE);
 
@@ -455,6 +484,15 @@ void mmu_cache_base::exec_data(const tlm::tlm_command cmd, const unsigned int &a
         // Set TLM response
         response = (tlm::TLM_OK_RESPONSE);
 
+        if (!is_dbg) {
+          trace(cachetrace::READ, addr, asi, len, cacheable);
+        }
+
+        // User and supervisor data pages enter the shadow TLB
+        if (m_shadow_en && !is_dbg && !lock && ((asi == 0xa) || (asi == 0xb))) {
+          shadow_fill(addr, asi);
+        }
+
       }
 
       break;
@@ -622,6 +660,9 @@ void mmu_cache_base::exec_data(const tlm::tlm_command cmd, const unsigned int &a
 
       icache->flush(&delay, debug, is_dbg);
       dcache->flush(&delay, debug, is_dbg);
+      if (!is_dbg) {
+        trace(cachetrace::FLUSH, addr, 0x3, 0);
+      }
       // Set TLM response
       response = (tlm::TLM_OK_RESPONSE);
 
@@ -633,6 +674,9 @@ void mmu_cache_base::exec_data(const tlm::tlm_command cmd, const unsigned int &a
       srDebug()("addr", addr)("asi", asi)("ASI flush instruction chache");
 
       icache->flush(&delay, debug, is_dbg);
+      if (!is_dbg) {
+        trace(cachetrace::FLUSH, addr, 0x1, 0);
+      }
       // Set TLM response
       response = (tlm::TLM_OK_RESPONSE);
 
@@ -644,6 +688,9 @@ void mmu_cache_base::exec_data(const tlm::tlm_command cmd, const unsigned int &a
       srDebug()("addr", addr)("asi", asi)("ASI flush data chache");
 
       dcache->flush(&delay, debug, is_dbg);
+      if (!is_dbg) {
+        trace(cachetrace::FLUSH, addr, 0x2, 0);
+      }
       // Set TLM response
       response = (tlm::TLM_OK_RESPONSE);
 
@@ -655,6 +702,7 @@ void mmu_cache_base::exec_data(const tlm::tlm_command cmd, const unsigned int &a
       srDebug()("addr", addr)("asi", asi)("ASI flush TLB");
 
       m_mmu->tlb_flush();
+      shadow_flush();
       // Set TLM response
       response = (tlm::TLM_OK_RESPONSE);
 
@@ -667,6 +715,9 @@ void mmu_cache_base::exec_data(const tlm::tlm_command cmd, const unsigned int &a
 
         srDebug()("addr", addr)("asi", asi)("MMU register write");
 
+        // Mappings, context or MMU state may change
+        shadow_flush();
+
         // Address decoder for MMU register access
         if (addr == 0x000) {
 
@@ -751,6 +802,10 @@ void mmu_cache_base::exec_data(const tlm::tlm_command cmd, const unsigned int &a
         // Set TLM response
         response = (tlm::TLM_OK_RESPONSE);
 
+        if (!is_dbg) {
+          trace(cachetrace::WRITE, addr, asi, len, cacheable);
+        }
+
       }
 
       break;
@@ -796,31 +851,135 @@ void mmu_cache_base::mem_write(unsigned int addr, unsigned int asi, unsigned cha
                           unsigned int length, sc_core::sc_time * delay,
                           unsigned int * debug, bool is_dbg, bool &cacheable, bool is_lock) {
 
+  if (is_dbg) {
+
+    // Allocate new transaction (reference counter = 1)
+    tlm::tlm_generic_payload * trans = ahb.get_transaction();
+
+    // Initialize transaction
+    trans->set_command(tlm::TLM_WRITE_COMMAND);
+    trans->set_address(addr);
+    trans->set_data_length(length);
+    trans->set_data_ptr(data);
+    trans->set_response_status(tlm::TLM_INCOMPLETE_RESPONSE);
+
+    // Debug transport
+    ahbaccess_dbg(trans);
+
+    // Buffered stores must not undo the debug write when drained
+    m_wbuf.update(addr, data, length);
+
+    // Debug writes are not snooped
+    if (m_mmu) {
+      m_mmu->walk_snoop(addr, length);
+    }
+
+    // Decrement reference counter
+    trans->release();
+    return;
+
+  }
+
+  // Regular stores to memory are merged in the write buffer. Locked
+  // stores and stores to I/O areas drain it and go to the bus directly.
+  if (m_wbuf.enabled() && !is_lock && write_bufferable(addr)) {
+
+    if (!m_wbuf.merge(addr, asi, data, length)) {
+
+      drain_write_buffer(delay);
+      if (!m_wbuf.merge(addr, asi, data, length)) {
+        issue_write(addr, data, length, delay, false);
+        return;
+      }
+    }
+
+    if (m_wbuf.drain_full()) {
+      drain_write_buffer(delay);
+    }
+    return;
+
+  }
+
+  drain_write_buffer(delay);
+  issue_write(addr, data, length, delay, is_lock);
+
+}
+
+/// Drains the write buffer
+void mmu_cache_base::drain_write_buffer(sc_core::sc_time * delay) {
+
+  if (m_wbuf.empty()) {
+    return;
+  }
+
+  srDebug()("addr", m_wbuf.address())("length", m_wbuf.length())("Drain write buffer");
+
+  // Slaves expect subword stores at their natural alignment, so merged
+  // bytes are issued as aligned pieces around one burst of whole words
+  unsigned int offset = 0;
+  while (offset < m_wbuf.length()) {
+    unsigned int length = writebuffer::transfer_length(m_wbuf.address() + offset,
+                                                       m_wbuf.length() - offset);
+    issue_write(m_wbuf.address() + offset, m_wbuf.data() + offset, length, delay, false);
+    offset += length;
+  }
+  m_wbuf.m_bursts++;
+  m_wbuf.clear();
+
+}
+
+/// Issues a store to the AHB master socket
+void mmu_cache_base::issue_write(unsigned int addr, unsigned char * data, unsigned int length,
+                                 sc_core::sc_time * delay, bool is_lock) {
+
   // Allocate new transaction (reference counter = 1)
   tlm::tlm_generic_payload * trans = ahb.get_transaction();
 
   srDebug()("pointer", reinterpret_cast<size_t>(trans))("refcount", trans->get_ref_count())("Allocate new transaction (mem_write) Acquire / Ref-Count");
 
-  // Copy payload data
-  memcpy(write_buf + wb_pointer, data, length);
-
   // Initialize transaction
   trans->set_command(tlm::TLM_WRITE_COMMAND);
   trans->set_address(addr);
   trans->set_data_length(length);
-  trans->set_data_ptr(write_buf + wb_pointer);
+  trans->set_data_ptr(data);
   trans->set_response_status(tlm::TLM_INCOMPLETE_RESPONSE);
 
-  wb_pointer = (wb_pointer + length) % 256;
+  if (is_lock) {
+    ahb.validate_extension<amba::amba_lock>(*trans);
+  } else {
+    ahb.invalidate_extension<amba::amba_lock>(*trans);
+  }
 
-  if (!is_dbg) {
+  if (m_posted_en) {
 
-    if (is_lock) {
-      ahb.validate_extension<amba::amba_lock>(*trans);
-    } else {
-      ahb.invalidate_extension<amba::amba_lock>(*trans);
+    // LT on a bus annotating instead of waiting: The store is carried out
+    // on the thread of the cpu, but posted as on the real bus. The cpu
+    // only waits for an earlier store still occupying the bus. The
+    // transfer time is kept in m_bus_free and delays the next bus access
+    // of the cpu.
+    bus_stall(delay);
+    sc_core::sc_time transfer = *delay;
+
+    srDebug()("pointer", reinterpret_cast<size_t>(trans))("Blocking transport (WRITE)");
+    msclogger::forward(this, &ahb, trans, tlm::BEGIN_REQ);
+    ahb->b_transport(*trans, transfer);
+    m_bus_free = sc_core::sc_time_stamp() + transfer;
+
+    if (trans->get_response_status() != tlm::TLM_OK_RESPONSE) {
+      response_error = true;
+      srWarn()("addr", addr)("Transaction response state of Transaction is not TLM_OK_RESPONSE");
     }
- 
+
+  } else {
+
+    // AT, or LT on a bus which waits for the transfers: The store is
+    // posted to the memory access thread, which spends the transfer time.
+    // The data is copied, since the transaction outlives the call.
+    memcpy(write_buf + wb_pointer, data, length);
+    trans->set_data_ptr(write_buf + wb_pointer);
+    wb_pointer = (wb_pointer + length) % 256;
+    m_posted_writes++;
+
     srDebug()("pointer", reinterpret_cast<size_t>(trans))("fifo_level", bus_in_fifo.used())("Schedule transaction (WRITE)");
     srDebug()("pointer", reinterpret_cast<size_t>(trans))("refcount", trans->get_ref_count())("Acquire / Ref-Count before (bus_in_fifo)");
     trans->acquire();
@@ -828,11 +987,6 @@ void mmu_cache_base::mem_write(unsigned int addr, unsigned int asi, unsigned cha
     wait(SC_ZERO_TIME);
     srDebug()("pointer", reinterpret_cast<size_t>(trans))("fifo_level", bus_in_fifo.used())("Done sheduling transaction (WRITE)");
 
-  } else {
-
-    // Debug transport
-    ahbaccess_dbg(trans);
-
   }
 
   srDebug()("pointer", reinterpret_cast<size_t>(trans))("refcount", trans->get_ref_count())("Relese Transaction: Ref-Count before calling release (mem_write)");
@@ -849,6 +1003,34 @@ bool mmu_cache_base::mem_read(unsigned int addr, unsigned int asi, unsigned char
 
   bool cacheable_local = true;
 
+  // Buffered stores have to reach the bus before the read
+  if (!is_dbg) {
+    drain_write_buffer(delay);
+  }
+
+  // Refills, bypass and uncached reads from memory are served with memcpy
+  // from the direct memory pointer. Peripherals never grant direct access
+  // and locked reads always go to the bus.
+  if (!is_dbg && m_dmi_en && !is_lock) {
+
+    t_dmi_region * region = dmi_lookup(addr, length);
+
+    if (region) {
+
+      bus_stall(delay);
+      memcpy(data, region->dmi.get_dmi_ptr() + (addr - region->dmi.get_start_address()), length);
+      *delay += region->dmi.get_read_latency() + region->word_latency * (double)((length + 3) >> 2);
+      m_dmi_reads++;
+
+      cacheable = region->cacheable;
+      if ((m_cached != 0))  {
+        cacheable_local = (m_cached & (1 << (addr >> 28))) ? true : false;
+      }
+      return cacheable_local && cacheable;
+
+    }
+  }
+
   // Allocate new transaction (reference counter = 1)
   tlm::tlm_generic_payload * trans = ahb.get_transaction();
 
@@ -860,6 +1042,7 @@ bool mmu_cache_base::mem_read(unsigned int addr, unsigned int asi, unsigned char
   trans->set_data_length(length);
   trans->set_data_ptr(data);
   trans->set_response_status(tlm::TLM_INCOMPLETE_RESPONSE);
+  trans->set_dmi_allowed(false);
 
   if (!is_dbg) {
 
@@ -869,18 +1052,47 @@ bool mmu_cache_base::mem_read(unsigned int addr, unsigned int asi, unsigned char
       ahb.invalidate_extension<amba::amba_lock>(*trans);
     }
 
-    srDebug()("pointer", reinterpret_cast<size_t>(trans))("fifo_level", bus_in_fifo.used())("Schedule transaction (READ)");
-    srDebug()("pointer", reinterpret_cast<size_t>(trans))("refcount", trans->get_ref_count())("Acquire / Ref-Count before (bus_in_fifo)");
-    trans->acquire();
-    bus_in_fifo.put(trans);
-    srDebug()("pointer", reinterpret_cast<size_t>(trans))("fifo_level", bus_in_fifo.used())("Done sheduling transaction (READ)");
+    if (m_abstractionLayer == amba::amba_LT) {
+
+      // LT: The read is carried out on the thread of the caller, which
+      // blocks anyway. The transfer time is annotated to the local time
+      // handed in, the memory access thread is not involved.
+      // The bus may wait for part of the transfer instead of annotating it.
+      sc_core::sc_time start = bus_stall(delay);
+
+      srDebug()("pointer", reinterpret_cast<size_t>(trans))("Blocking transport (READ)");
+      msclogger::forward(this, &ahb, trans, tlm::BEGIN_REQ);
+      ahb->b_transport(*trans, *delay);
+
+      if (trans->get_response_status() != tlm::TLM_OK_RESPONSE) {
+        response_error = true;
+        srWarn()("addr", addr)("Transaction response state of Transaction is not TLM_OK_RESPONSE");
+      } else if (m_dmi_en && !is_lock && trans->is_dmi_allowed()) {
+        dmi_acquire(trans, sc_core::sc_time_stamp() + *delay - start, ahb.get_extension<amba::amba_cacheable>(*trans) ? true : false);
+      }
+
+    } else {
+
+      srDebug()("pointer", reinterpret_cast<size_t>(trans))("fifo_level", bus_in_fifo.used())("Schedule transaction (READ)");
+      srDebug()("pointer", reinterpret_cast<size_t>(trans))("refcount", trans->get_ref_count())("Acquire / Ref-Count before (bus_in_fifo)");
+      trans->acquire();
+      bus_in_fifo.put(trans);
+      srDebug()("pointer", reinterpret_cast<size_t>(trans))("fifo_level", bus_in_fifo.used())("Done sheduling transaction (READ)");
+
+      // Read misses are blocking the cache !!
+      wait(bus_read_completed);
+      srDebug()("pointer", reinterpret_cast<size_t>(trans))("fifo_level", bus_in_fifo.used())("Done transaction (READ) / bus_read_completed event");
+
+    }
 
-    // Read misses are blocking the cache !!
-    wait(bus_read_completed);
-    srDebug()("pointer", reinterpret_cast<size_t>(trans))("fifo_level", bus_in_fifo.used())("Done transaction (READ) / bus_read_completed event");
     // cacheable handling!!!
     cacheable = (ahb.get_extension<amba::amba_cacheable>(*trans)) ? true : false;
 
+    // Memory regions are learned from the reads for the write buffer
+    if (cacheable) {
+      m_wb_regions |= (1 << (addr >> 28));
+    }
+
     // Check cacheability
     //if ((m_cached != 0) && (cacheable))  {
     if ((m_cached != 0))  {
@@ -891,6 +1103,9 @@ bool mmu_cache_base::mem_read(unsigned int addr, unsigned int asi, unsigned char
     
     ahbaccess_dbg(trans);
 
+    // The debugger sees the stores still held in the write buffer
+    m_wbuf.forward(addr, data, length);
+
   }
 
   srDebug()("pointer", reinterpret_cast<size_t>(trans))("refcount", trans->get_ref_count())("Release transaction (mem_read) Ref-Count before calling release");
@@ -901,6 +1116,147 @@ bool mmu_cache_base::mem_read(unsigned int addr, unsigned int asi, unsigned char
 
 }
 
+// Looks up the region granted for a direct read
+mmu_cache_base::t_dmi_region * mmu_cache_base::dmi_lookup(unsigned int addr, unsigned int length) {
+
+  for (std::vector<t_dmi_region>::iterator region = m_dmi_regions.begin(); region != m_dmi_regions.end(); ++region) {
+
+    // The end address is not trusted to be inclusive
+    if ((addr >= region->dmi.get_start_address()) &&
+        ((sc_dt::uint64)addr + length <= region->dmi.get_end_address())) {
+      return &(*region);
+    }
+  }
+  return NULL;
+
+}
+
+// Requests direct access to the region of a transaction
+void mmu_cache_base::dmi_acquire(tlm::tlm_generic_payload * trans, const sc_core::sc_time &latency, bool cacheable) {
+
+  // The bus may rewrite the address of the request
+  unsigned int addr = trans->get_address();
+  unsigned int length = trans->get_data_length();
+  t_dmi_region region;
+
+  region.dmi.init();
+  if (!ahb->get_direct_mem_ptr(*trans, region.dmi) || !region.dmi.is_read_allowed() ||
+      (region.dmi.get_dmi_ptr() == NULL)) {
+    return;
+  }
+
+  if ((addr < region.dmi.get_start_address()) ||
+      ((sc_dt::uint64)addr + length > region.dmi.get_end_address())) {
+    return;
+  }
+
+  // The target reports the fixed latency of an access, the rest of the
+  // transfer time is spread over the words
+  if (latency > region.dmi.get_read_latency()) {
+    region.word_latency = (latency - region.dmi.get_read_latency()) / (double)((length + 3) >> 2);
+  } else {
+    region.word_latency = SC_ZERO_TIME;
+  }
+  region.cacheable = cacheable;
+  m_dmi_regions.push_back(region);
+
+  srDebug()("start", region.dmi.get_start_address())("end", region.dmi.get_end_address())("Direct memory access granted");
+
+}
+
+// Drops the direct access regions overlapping the range
+void mmu_cache_base::invalidate_direct_mem_ptr(sc_dt::uint64 start_range, sc_dt::uint64 end_range) {
+
+  std::vector<t_dmi_region>::iterator region = m_dmi_regions.begin();
+
+  // The shadow TLB points into the regions
+  shadow_flush();
+
+  while (region != m_dmi_regions.end()) {
+    if ((region->dmi.get_start_address() <= end_range) && (region->dmi.get_end_address() >= start_range)) {
+      region = m_dmi_regions.erase(region);
+    } else {
+      ++region;
+    }
+  }
+
+}
+
+// Serves a load from the shadow TLB
+bool mmu_cache_base::shadow_read(unsigned int addr, unsigned int asi, unsigned char * data,
+                                 unsigned int length, sc_core::sc_time &delay, unsigned int * debug) {
+
+  t_shadow & entry = m_shadow[(addr >> 12) & (SHADOW_ENTRIES - 1)];
+
+  if ((entry.host == NULL) || (entry.vaddr != (addr & ~0xfff)) || (entry.asi != asi)) {
+    return false;
+  }
+
+  // Timing and statistics of a read hit in the data cache
+  if (!dcache->read_hit(addr, asi, length, &delay, debug)) {
+    return false;
+  }
+
+  memcpy(data, entry.host + (addr & 0xfff), length);
+
+  // Stores still held in the write buffer are younger than the memory
+  if (!m_wbuf.empty()) {
+    m_wbuf.forward(entry.paddr | (addr & 0xfff), data, length);
+  }
+
+  m_shadow_loads++;
+
+  return true;
+
+}
+
+// Enters the page of a completed load into the shadow TLB
+void mmu_cache_base::shadow_fill(unsigned int addr, unsigned int asi) {
+
+  uint64_t paddr;
+  bool cacheable;
+
+  // Data cache enabled (not frozen or disabled)
+  if (!m_dcen || (dcache->check_mode() != 0x3)) {
+    return;
+  }
+
+  // The TLB must hold a cacheable translation of the page
+  if (!m_mmu->tlb_probe(addr, asi, 0, &paddr, cacheable) || !cacheable) {
+    return;
+  }
+
+  unsigned int page = (unsigned int)paddr & ~0xfff;
+
+  if ((m_cached != 0) && !(m_cached & (1 << (page >> 28)))) {
+    return;
+  }
+
+  // The page must be cacheable memory granted for direct reads
+  t_dmi_region * region = dmi_lookup(page, 0x1000);
+
+  if (!region || !region->cacheable) {
+    return;
+  }
+
+  t_shadow & entry = m_shadow[(addr >> 12) & (SHADOW_ENTRIES - 1)];
+
+  entry.vaddr = addr & ~0xfff;
+  entry.asi = asi;
+  entry.paddr = page;
+  entry.host = region->dmi.get_dmi_ptr() + (page - region->dmi.get_start_address());
+
+}
+
+// Empties the shadow TLB
+void mmu_cache_base::shadow_flush() {
+
+  for (unsigned int i = 0; i < SHADOW_ENTRIES; i++) {
+    m_shadow[i].host = NULL;
+  }
+
+}
+
 // Thread for serializing memory access
 void mmu_cache_base::mem_access() {
 
@@ -919,7 +1275,11 @@ void mmu_cache_base::mem_access() {
       srDebug()("pointer", reinterpret_cast<size_t>(trans))("addr", trans->get_address())("Transaction returned from AHB");
 
       if (m_abstractionLayer == amba::amba_AT) wait(ahb_response_event);
-      if (trans->is_read()) bus_read_completed.notify();
+      if (trans->is_read()) {
+        bus_read_completed.notify();
+      } else if (--m_posted_writes == 0) {
+        bus_writes_completed.notify();
+      }
 
       // Decrement ref counter
       srDebug()("pointer", reinterpret_cast<size_t>(trans))("refcount", trans->get_ref_count())("Release transaction (bus_in_fifo) Ref-Count before calling release");
@@ -963,6 +1323,9 @@ void mmu_cache_base::write_ccr(unsigned char * data, unsigned int len,
     if (tmp & (1 << 21)) {
         icache->flush(delay, debug, is_dbg);
     }
+    if (!is_dbg && (tmp & (3 << 21))) {
+        trace(cachetrace::FLUSH, 0, (tmp >> 21) & 0x3, 0);
+    }
     // [IB] instruction burst fetch (todo)
     if (tmp & (1 << 16)) {
     }
@@ -983,6 +1346,12 @@ void mmu_cache_base::write_ccr(unsigned char * data, unsigned int len,
 
     // read only masking: 1111 1111 1001 1111 0011 1111 1111 1111
     CACHE_CONTROL_REG = (tmp & 0xff9f3fff);
+    if (!is_dbg) {
+        trace(cachetrace::CCR, CACHE_CONTROL_REG, 0, 0);
+    }
+
+    // Shadow TLB pages are only entered with the data cache enabled
+    shadow_flush();
 
     srDebug()("CACHE_CONTROL_REG", CACHE_CONTROL_REG)(__PRETTY_FUNCTION__);
 }
@@ -1008,6 +1377,12 @@ unsigned int mmu_cache_base::read_ccr(bool internal) {
 void mmu_cache_base::snoopingCallBack(const t_snoop& snoop, const sc_core::sc_time& delay) {
 
   srDebug()("master", snoop.master_id)("addr", snoop.address)("length", snoop.length)(__PRETTY_FUNCTION__);
+
+  // Writes of all masters (including this one) may change page tables
+  if (m_mmu) {
+    m_mmu->walk_snoop(snoop.address, snoop.length);
+  }
+
   // Make sure we are not snooping ourself ;)
   if (snoop.master_id != m_master_id) {
 
@@ -1015,6 +1390,7 @@ void mmu_cache_base::snoopingCallBack(const t_snoop& snoop, const sc_core::sc_ti
     if (m_dcen && m_dsnoop) {
 
       dcache->snoop_invalidate(snoop, delay);
+      trace(cachetrace::SNOOP, snoop.address, 0, snoop.length);
     }
   }
 }
@@ -1075,11 +1451,33 @@ gs::cnf::callback_return_type mmu_cache_base::swi_power_cb(gs::gs_param_base& ch
 // Displays execution statistics.
 void mmu_cache_base::end_of_simulation() {
 
+    // Stores still buffered when the simulation stopped must reach the
+    // memory. Time cannot advance any more, so they go by debug transport.
+    if (!m_wbuf.empty()) {
+      tlm::tlm_generic_payload * trans = ahb.get_transaction();
+      trans->set_command(tlm::TLM_WRITE_COMMAND);
+      trans->set_address(m_wbuf.address());
+      trans->set_data_length(m_wbuf.length());
+      trans->set_data_ptr(m_wbuf.data());
+      trans->set_response_status(tlm::TLM_INCOMPLETE_RESPONSE);
+      ahbaccess_dbg(trans);
+      trans->release();
+      m_wbuf.m_bursts++;
+      m_wbuf.clear();
+    }
+
+    m_trace.close();
+
     v::report << name() << " ********************************************" << v::endl;
     v::report << name() << " * mmu_cache_base Statistics: " << v::endl;
     v::report << name() << " * --------------------- " << v::endl;
     v::report << name() << " * Successful Transactions: " << m_right_transactions << v::endl;
     v::report << name() << " * Total Transactions: " << m_total_transactions << v::endl;
+    v::report << name() << " * Buffered stores: " << m_wbuf.m_stores << v::endl;
+    v::report << name() << " * Write buffer bursts: " << m_wbuf.m_bursts << v::endl;
+    v::report << name() << " * Direct memory reads: " << m_dmi_reads << v::endl;
+    v::report << name() << " * Shadow TLB loads (data cache hits, not in TLB statistics): " << m_shadow_loads << v::endl;
+    v::report << name() << " * Traced cache events: " << m_trace.m_records << v::endl;
     v::report << name() << " * " << v::endl;
     v::report << name() << " * AHB Master interface reports: " << v::endl;
     print_transport_statistics(name());
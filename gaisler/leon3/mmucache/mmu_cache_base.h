@@ -24,6 +24,8 @@
 //#include <tlm_1/tlm_req_rsp/tlm_channels/tlm_fifo/tlm_fifo.h>
 
 #include <math.h>
+#include <vector>
+#include <boost/thread/mutex.hpp>
 
 #include "gaisler/leon3/mmucache/icio_payload_extension.h"
 #include "gaisler/leon3/mmucache/dcio_payload_extension.h"
@@ -41,6 +43,8 @@
 #include "gaisler/leon3/mmucache/mmu_cache_if.h"
 #include "gaisler/leon3/mmucache/mmu.h"
 #include "gaisler/leon3/mmucache/localram.h"
+#include "gaisler/leon3/mmucache/writebuffer.h"
+#include "gaisler/leon3/mmucache/cachetrace.h"
 
 /// @addtogroup mmu_cache MMU_Cache
 /// @{
@@ -139,6 +143,12 @@ class mmu_cache_base :
                         unsigned int length, sc_core::sc_time * t,
                         unsigned int * debug, bool is_dbg, bool &cacheable, bool is_lock);
 
+  /// Issues the stores held by the write buffer
+  void drain_write_buffer(sc_core::sc_time * delay);
+
+  /// Called by the bus if memory regions granted for direct access change
+  void invalidate_direct_mem_ptr(sc_dt::uint64 start_range, sc_dt::uint64 end_range);
+
   /// Send an interrupt over the central IRQ interface
   virtual void set_irq(uint32_t tt);
 
@@ -151,7 +161,7 @@ class mmu_cache_base :
   virtual unsigned int read_ccr(bool internal);
 
   /// Snooping function (For calling dcache->snoop_invalidate)
-  void snoopingCallBack(const t_snoop& snoop, const sc_core::sc_time& delay);
+  virtual void snoopingCallBack(const t_snoop& snoop, const sc_core::sc_time& delay);
 
   /// Automatically called at the beginning of the simulation
   void start_of_simulation();
@@ -233,13 +243,167 @@ class mmu_cache_base :
   /// amba master id
   unsigned int m_master_id;
 
+  /// Serializes the bus accesses; LT reads and writes bypass it
   void mem_access();
 
+  /// Issues a store to the AHB master (LT: blocking, AT: posted)
+  void issue_write(unsigned int addr, unsigned char * data, unsigned int length,
+                   sc_core::sc_time * delay, bool is_lock);
+
+  /// Stalls an LT bus access until the posted stores ahead of it left the
+  /// bus. Returns the start time of the access.
+  sc_core::sc_time bus_stall(sc_core::sc_time * delay) {
+    // Stores posted to the memory access thread go to the bus first
+    while (m_posted_writes) {
+      wait(bus_writes_completed);
+    }
+    sc_core::sc_time start = sc_core::sc_time_stamp() + *delay;
+    if (m_bus_free > start) {
+      *delay += m_bus_free - start;
+      start = m_bus_free;
+    }
+    return start;
+  }
+
+  /// End of the last LT store posted on the cpu thread. These stores cost
+  /// the cpu only their issue cycle, the transfer delays the next bus
+  /// access.
+  sc_core::sc_time m_bus_free;
+
+  /// Issues LT stores on the cpu thread. Only set if the bus annotates the
+  /// transfer time instead of waiting (decoupled AHBCtrl), since a waiting
+  /// bus would suspend the cpu for every store. Otherwise stores are posted
+  /// to the memory access thread.
+  bool m_posted_en;
+
+  /// Stores handed to the memory access thread and not yet completed
+  unsigned int m_posted_writes;
+
+  /// True if stores to addr may be held in the write buffer
+  bool write_bufferable(unsigned int addr) const {
+    unsigned int mask = (m_cached != 0)? m_cached : m_wb_regions;
+    return (mask & (1 << (addr >> 28))) ? true : false;
+  }
+
+  /// Coalescing write buffer between data cache and AHB master
+  writebuffer m_wbuf;
+
+  /// 256 MB regions which returned cacheable data on reads. Stores are
+  /// only buffered in memory, never in I/O areas.
+  unsigned int m_wb_regions;
+
+  /// Memory region granted for direct reads
+  struct t_dmi_region {
+    /// Host pointer, address range and the fixed read latency of the target
+    tlm::tlm_dmi dmi;
+    /// Transfer time per word: the time of the transaction which got the
+    /// region granted less the fixed read latency, divided by its words
+    sc_core::sc_time word_latency;
+    /// Cacheability of the region
+    bool cacheable;
+  };
+
+  /// Returns the region holding a read of length bytes at addr (or NULL)
+  t_dmi_region * dmi_lookup(unsigned int addr, unsigned int length);
+
+  /// Requests direct access to the region of a transaction which the
+  /// target marked as DMI allowed
+  void dmi_acquire(tlm::tlm_generic_payload * trans, const sc_core::sc_time &latency, bool cacheable);
+
+  /// Enables direct reads from memory (LT only). Direct reads do not pass
+  /// the AHBCtrl: they are neither arbitrated nor counted in its statistics.
+  bool m_dmi_en;
+
+  /// Regions granted for direct reads
+  std::vector<t_dmi_region> m_dmi_regions;
+
+  /// Number of reads served from direct memory pointers
+  uint64_t m_dmi_reads;
+
+  // Shadow TLB
+  // ----------
+  // Maps virtual 4 kB data pages to host pointers into memories granting
+  // DMI. An entry is filled after a load which the TLB translated into a
+  // cacheable page of cacheable memory while the data cache was enabled.
+  // Later loads from the page with the same ASI (user or supervisor data)
+  // which hit in the data cache are copied from the host pointer; the data
+  // cache accounts them like any other read hit, so that timing, statistics
+  // and replacement do not depend on the shadow TLB. Stores
+  // take the regular path, so that the data cache, the write buffer and
+  // the snooping of other masters see them. Loads forward the bytes still
+  // held in the write buffer. The table is flushed with the TLB, on writes
+  // to the MMU registers and the cache control register, and when a DMI
+  // region is withdrawn. Hence it holds translations of the current
+  // context only.
+
+  /// Shadow TLB entry
+  struct t_shadow {
+    /// Page aligned virtual address
+    unsigned int vaddr;
+    /// ASI of the load which filled the entry
+    unsigned int asi;
+    /// Page aligned physical address
+    unsigned int paddr;
+    /// Host pointer to the page (NULL if the entry is empty)
+    unsigned char * host;
+  };
+
+  /// Number of shadow TLB entries (direct mapped)
+  static const unsigned int SHADOW_ENTRIES = 256;
+
+  /// Serves a load from the shadow TLB. Returns false if the page has no
+  /// entry or the load misses in the data cache.
+  bool shadow_read(unsigned int addr, unsigned int asi, unsigned char * data,
+                   unsigned int length, sc_core::sc_time &delay, unsigned int * debug);
+
+  /// Enters the page of a completed load into the shadow TLB (if allowed)
+  void shadow_fill(unsigned int addr, unsigned int asi);
+
+  /// Empties the shadow TLB
+  void shadow_flush();
+
+  /// Shadow TLB entries
+  t_shadow m_shadow[SHADOW_ENTRIES];
+
+  /// Enables the shadow TLB (LT with MMU and DMI only)
+  bool m_shadow_en;
+
+  /// Number of loads served from the shadow TLB. They are also counted as
+  /// data cache read hits, but not in the TLB statistics.
+  uint64_t m_shadow_loads;
+
+  // Cache access trace
+  // ------------------
+  // Records the fetches, loads and stores reaching the caches together
+  // with flushes, snoop invalidations and changes of the cache control
+  // register. The cachereplay tool feeds the trace through a range of cache
+  // configurations. Tracing is off unless a trace file is created.
+  // Fetches of a core running its quantum on a worker thread are recorded
+  // while the SystemC thread records snoops, hence the lock.
+
+  /// Appends an event to the cache access trace (if tracing)
+  inline void trace(unsigned int type, unsigned int addr, unsigned int asi,
+                    unsigned int length, bool cacheable = true) {
+    if (m_trace.is_open()) {
+      boost::mutex::scoped_lock lock(m_trace_mutex);
+      m_trace.record(cacheable? type : type | cachetrace::UNCACHEABLE, addr, asi, length);
+    }
+  }
+
+  /// Cache access trace
+  cachetrace m_trace;
+
+  /// Serializes the records of the cache access trace
+  boost::mutex m_trace_mutex;
+
   unsigned char write_buf[1024];
   unsigned int wb_pointer;
 
   sc_event bus_read_completed;
 
+  /// Notified when the memory access thread completed all posted stores
+  sc_event bus_writes_completed;
+
   tlm::tlm_fifo<tlm::tlm_generic_payload *> bus_in_fifo;
 
   /// Total number of successful transactions for execution statistics 
@@ -18,7 +18,6 @@
 #define __MMU_IF_H__
 
 #include <tlm.h>
-#include <map>
 
 #include "gaisler/leon3/mmucache/defines.h"
 
@@ -28,7 +27,7 @@ class mmu_if {
 
         // page descriptor cache (PDC) lookup
         virtual signed tlb_lookup(unsigned int addr, unsigned asi,
-                             std::map<t_VAT, t_PTE_context> * tlb,
+                             t_tlb * tlb,
                              unsigned int tlb_size, sc_core::sc_time * t,
                              unsigned int * debug, bool is_dbg, bool &cacheable,
                              unsigned is_write /* LOAD / STORE? */, uint64_t * paddr ) = 0;
@@ -31,7 +31,7 @@ class tlb_adaptor : public DefaultBase, public mem_if {
 
         /// constructor
         tlb_adaptor(ModuleName name, mmu_cache_if * top,
-                    mmu_if * _mmu, std::map<t_VAT, t_PTE_context> * tlb,
+                    mmu_if * _mmu, t_tlb * tlb,
                     unsigned int tlbnum) :
             sc_module(name), m_mmu_cache(top), m_mmu(_mmu), m_tlb(tlb),
                     m_tlbnum(tlbnum) {
@@ -104,7 +104,7 @@ class tlb_adaptor : public DefaultBase, public mem_if {
         mmu_cache_if * m_mmu_cache;
         mmu_if * m_mmu;
 
-        std::map<t_VAT, t_PTE_context> * m_tlb;
+        t_tlb * m_tlb;
 
         unsigned int m_tlbnum;
 
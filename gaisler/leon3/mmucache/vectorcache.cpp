@@ -59,6 +59,8 @@ vectorcache::vectorcache(ModuleName name,
     whits("write_hits", sets, m_performance_counters),
     wmisses("write_misses", 0ull, m_performance_counters),
     bypassops("bypass_operations", 0ull, m_performance_counters),
+    snoopfiltered("snoops_filtered", 0ull, m_performance_counters),
+    snoopinvalidated("snoop_invalidated_lines", 0ull, m_performance_counters),
     m_pow_mon(pow_mon),
     dyn_tag_reads("dyn_tag_reads", 0ull), // number of itag reads
     dyn_tag_writes("dyn_tag_writes", 0ull), // number of itag writes
@@ -102,23 +104,31 @@ vectorcache::vectorcache(ModuleName name,
 
     // Create the cache sets
     srDebug()("Creating cache memory");
-    //cache_mem = new std::vector<t_cache_line>(m_number_of_vectors*sets);
-    cache_mem = new std::vector<t_cache_line*>();
-    mapped_regions = new std::vector<scireg_ns::scireg_mapped_region*>();
-    for (uint32_t i = 0; i < m_number_of_vectors*sets; i++) {
-      char *buffer = new char[11];
-      snprintf(buffer, 11, "line_%d", i);
-
-      t_cache_line *line = new t_cache_line(*this, buffer, linesize);
-//      srInfo()("name", buffer)("line created");
-      cache_mem->push_back(line);
-
-      scireg_ns::scireg_mapped_region *mapped_region = new scireg_ns::scireg_mapped_region();
-      mapped_region->region = line;
-      mapped_region->offset = i*32;
-      mapped_region->name = buffer;
-      mapped_regions->push_back(mapped_region);
+    uint32_t lines = m_number_of_vectors*sets;
+    m_atag = new unsigned[lines]();
+    m_valid = new unsigned[lines]();
+    m_lrr = new unsigned[lines]();
+    m_lru = new unsigned[lines]();
+    m_lock = new unsigned[lines]();
+    // Lines are aligned to host cache lines
+    void *data = NULL;
+    if (posix_memalign(&data, 64, lines*m_bytesperline)) {
+      srError()("Cannot allocate cache memory");
+      assert(0);
+    }
+    m_data = static_cast<unsigned char *>(data);
+    memset(m_data, 0, lines*m_bytesperline);
+    m_line_views = NULL;
+    mapped_regions = NULL;
+
+    // The snoop filter has at least eight bits per line to keep the rate
+    // of false positives low
+    m_presence_bits = 12;
+    while ((1u << m_presence_bits) < (lines << 3)) {
+      m_presence_bits++;
     }
+    m_presence = new uint32_t[(1u << m_presence_bits) >> 5]();
+    m_presence_fills = 0;
 
 
     // Configuration report
@@ -188,19 +198,30 @@ vectorcache::vectorcache(ModuleName name,
     rmisses = 0;
     wmisses = 0;
     bypassops = 0;
+    snoopfiltered = 0;
+    snoopinvalidated = 0;
 
 } // vectorcache::vectorcache()
 
 /// Destructor
 vectorcache::~vectorcache() {
-  for (std::vector<t_cache_line*>::iterator it = cache_mem->begin() ; it != cache_mem->end(); ++it) {
-    delete (*it);
-  }
-  for (std::vector<scireg_ns::scireg_mapped_region*>::iterator it = mapped_regions->begin() ; it != mapped_regions->end(); ++it) {
-    delete (*it);
+  if (m_line_views) {
+    for (std::vector<t_cache_line_view*>::iterator it = m_line_views->begin() ; it != m_line_views->end(); ++it) {
+      delete (*it);
+    }
+    for (std::vector<scireg_ns::scireg_mapped_region*>::iterator it = mapped_regions->begin() ; it != mapped_regions->end(); ++it) {
+      delete (*it);
+    }
+    delete m_line_views;
+    delete mapped_regions;
   }
-  delete cache_mem;
-  delete mapped_regions;
+  delete[] m_atag;
+  delete[] m_valid;
+  delete[] m_lrr;
+  delete[] m_lru;
+  delete[] m_lock;
+  delete[] m_presence;
+  free(m_data);
 
 } // vectorcache::~vectorcache()
 
@@ -267,7 +288,7 @@ bool vectorcache::mem_read(unsigned int address, unsigned int asi, unsigned char
         ("offset", offset)
         ("byt", byt)
         ("read");
-      (*lookup_line(idx, cache_hit))->entry.copy_from(data, len, offset >> 2, byt);
+      read_line_data(lookup_line(idx, cache_hit), data, len, offset);
 
 
       // Update flags
@@ -397,6 +418,109 @@ bool vectorcache::mem_read(unsigned int address, unsigned int asi, unsigned char
 
 /// ----------------------------------------------------------------------------
 
+/// Returns a host pointer to the data of the cache line holding address
+/** @details
+*   Used by the fetch line buffer of the cpu to serve sequential instruction
+*   fetches without running through mem_read. Only lines which would be hit by
+*   mem_read are handed out: the cache has to be enabled or frozen, the access
+*   must neither bypass the MMU nor force a miss and the line data must not be
+*   observed by scireg callbacks. The lookup itself does not add any timing or
+*   statistics, the caller already did the regular access for the first word.
+*/
+const unsigned char *vectorcache::get_line_ptr(unsigned int address, unsigned int asi,
+                                               unsigned int &way, unsigned int &valid,
+                                               unsigned int &linesize) {
+
+  if ((asi == 0x1c) || (asi <= 3) || !(check_mode() & 0x1)) {
+    return NULL;
+  }
+
+  unsigned idx = get_idx(address);
+  unsigned hits = match_ways(get_tag(address), idx);
+
+  if (!hits) {
+    return NULL;
+  }
+
+  unsigned w = 0;
+  while (!(hits & (1 << w))) {
+    w++;
+  }
+  unsigned line = lookup_line(idx, w);
+  uint32_t tmp_valid = m_valid[line];
+
+  // Linefetch mode only knows whole lines
+  if (m_new_linefetch_en) {
+    tmp_valid = (tmp_valid & 0x1)? (0xffffffff >> (32 - m_wordsperline)) : 0;
+  }
+
+  if (!(tmp_valid & offset2valid(get_offset(address))) || line_observed(line)) {
+    return NULL;
+  }
+
+  way = w;
+  valid = tmp_valid;
+  linesize = m_bytesperline;
+  return line_data(line);
+} // vectorcache::get_line_ptr()
+
+/// ----------------------------------------------------------------------------
+
+/// Accounts read hits served by the fetch line buffer
+/** @details
+*   Every buffered fetch stands for a single word read hit in mem_read. LRU
+*   information is not touched, since all of these hits refer to the way which
+*   was made most recently used by the regular access.
+*/
+void vectorcache::add_read_hits(unsigned int way, uint64_t hits) {
+
+  rhits[way] += hits;
+
+  // Update power information
+  if (m_pow_mon) {
+    dyn_tag_reads += (m_sets + 1) * hits;
+    dyn_data_reads += (m_sets + 1) * hits;
+  }
+} // vectorcache::add_read_hits()
+
+/// ----------------------------------------------------------------------------
+
+/// Accounts a read hit served by the shadow TLB
+/** @details
+*   Does everything the hit path of mem_read does apart from copying the
+*   data, so that a load served from outside the cache leaves timing,
+*   statistics and replacement exactly as mem_read would. Misses, forced
+*   misses, MMU bypass and lines observed by scireg callbacks are left to
+*   mem_read.
+*/
+bool vectorcache::read_hit(unsigned int address, unsigned int asi, unsigned int len,
+                           sc_core::sc_time *delay, unsigned int *debug) {
+
+  if ((asi == 0x1c) || (asi <= 3) || !(check_mode() & 0x1)) {
+    return false;
+  }
+
+  unsigned idx = get_idx(address);
+  sc_core::sc_time lookup = sc_core::SC_ZERO_TIME;
+  int cache_hit = locate_line(get_tag(address), idx, get_offset(address), len, &lookup);
+
+  if ((cache_hit == -1) || line_observed(lookup_line(idx, cache_hit))) {
+    return false;
+  }
+
+  if (m_pow_mon) dyn_data_reads += m_sets + 1 + ((len - 1) >> 2);
+  if (m_repl == 1) lru_update(idx, cache_hit);
+
+  *delay += lookup + ((len - 1) >> 2) * clockcycle;
+
+  rhits[cache_hit]++;
+  CACHEREADHIT_SET(*debug, cache_hit);
+
+  return true;
+} // vectorcache::read_hit()
+
+/// ----------------------------------------------------------------------------
+
 /// mem_if::Write cache
 /** @details
 *   The behavior depends on the write_policy and write_alloc chosen:
@@ -541,19 +665,16 @@ void vectorcache::read_cache_tag(unsigned int address, unsigned int * data,
   unsigned way = get_tag(address) & 0x3;
 
   // find the required cache line
-  t_cache_line* line = (*lookup_line(idx, way));
+  unsigned line = lookup_line(idx, way);
 
   // build bitmask from tag fields
   // (! The atag field starts bit 10. It is not MSB aligned as in the actual tag layout.)
-  uint32_t tmp_valid;
-  line->tag[t_cache_line::VALID].bus_read(tmp_valid);
+  tmp = m_atag[line] << 10;
+  tmp |= m_lrr[line] << 9;
+  tmp |= m_lock[line] << 8;
+  tmp |= m_valid[line];
 
-  tmp = line->tag[t_cache_line::ATAG].bus_read() << 10;
-  tmp |= line->tag[t_cache_line::LRR].bus_read() << 9;
-  tmp |= line->tag[t_cache_line::LOCK].bus_read() << 8;
-  tmp |= tmp_valid;
-
-  srDebug()("tag", line->tag[t_cache_line::ATAG])
+  srDebug()("tag", m_atag[line])
            ("idx", idx)
            ("way", way)
            ("Diagnostic read cache tag");
@@ -593,23 +714,27 @@ void vectorcache::write_cache_tag(unsigned int address, unsigned int * data,
   unsigned way = get_tag(address) & 0x3;
 
   // find the required cache line
-  t_cache_line* line = (*lookup_line(idx, way));
+  unsigned line = lookup_line(idx, way);
 
   // update the tag with write data
   // (! The atag field is expected to start at bit 10. Not MSB aligned as in tag layout.)
-  line->tag[t_cache_line::ATAG].bus_write( *data >> 10);
-  line->tag[t_cache_line::LRR].bus_write((*data & 0x100) >> 9);
+  m_atag[line] = *data >> 10;
+  m_lrr[line] = (*data & 0x100) >> 9;
   // lock bit can only be set, if line locking is enabled
   // locking only works in multi-way configurations. the last way must never be locked.
-  line->tag[t_cache_line::LOCK].bus_write(((m_setlock) && (way != m_sets))? ((*data & 0x100) >> 8) : 0);
-  line->tag[t_cache_line::VALID].bus_write((*data & 0xff));
+  m_lock[line] = ((m_setlock) && (way != m_sets))? ((*data & 0x100) >> 8) : 0;
+  m_valid[line] = (*data & 0xff);
+
+  if (m_valid[line]) {
+    presence_set(get_address(m_atag[line], idx, 0));
+  }
 
-  srDebug()("tag", line->tag[t_cache_line::ATAG])
+  srDebug()("tag", m_atag[line])
            ("idx", idx)
            ("way", way)
-           ("lrr", line->tag[t_cache_line::LRR])
-           ("lock", line->tag[t_cache_line::LOCK])
-           ("valid", line->tag[t_cache_line::VALID])
+           ("lrr", m_lrr[line])
+           ("lock", m_lock[line])
+           ("valid", m_valid[line])
            ("Diagnostic write cache tag");
 
   // increment time
@@ -634,9 +759,9 @@ void vectorcache::read_cache_entry(unsigned int address, unsigned int * data,
   unsigned way = get_tag(address) & 0x3;
 
   // find the required cache line
-  t_cache_line* line = (*lookup_line(idx, way));
+  unsigned line = lookup_line(idx, way);
 
-  *data = line->entry.get_int(sb);
+  read_line_data(line, reinterpret_cast<unsigned char *>(data), 4, sb << 2);
 
   srDebug()("idx", idx)
            ("subblock", sb)
@@ -666,9 +791,9 @@ void vectorcache::write_cache_entry(unsigned int address, unsigned int * data,
   unsigned way = get_tag(address) & 0x3;
 
   // find the required cache line
-  t_cache_line* line = (*lookup_line(idx, way));
+  unsigned line = lookup_line(idx, way);
 
-  line->entry.set_int(sb, *data);
+  write_line_data(line, reinterpret_cast<unsigned char *>(data), 4, sb << 2);
 
   srDebug()("idx", idx)
            ("subblock", sb)
@@ -686,40 +811,11 @@ void vectorcache::write_cache_entry(unsigned int address, unsigned int * data,
 /// cache_if::Flush cache
 void vectorcache::flush(sc_core::sc_time *t, unsigned int * debug, bool is_dbg) {
 
-//  unsigned addr;
-  unsigned i_line = 0;
-//  bool cacheable = true;
-
-  // for all cache lines
-  for (std::vector<t_cache_line*>::iterator line = cache_mem->begin();
-       line < cache_mem->end(); line++, i_line++) {
-
-// it's a write-through cache. we should never need the following code
-/*    for (unsigned entry = 0; entry < m_wordsperline; entry++) {
-
-      // check for valid data
-      if ((*line)->tag.dirty && (*line)->tag[t_cache_line::VALID] & (1 << entry)) {
-
-        // construct address from tag
-        addr = ((*line)->tag[t_cache_line::ATAG] << (m_idx_bits + m_offset_bits));
-        addr |= ((i_line/(m_sets+1)) << m_offset_bits);
-        addr |= (entry << 2);
-
-        srDebug()("addr", addr)
-                 ("line", i_line)
-                 ("idx", i_line/(m_sets+1))
-                 ("way", i_line%(m_sets+1))
-                 ("data", (*line)->entry.get_int(entry))
-                 ("Cache flush");
-
-        m_tlb_adaptor->mem_write(addr, 0x8,(unsigned char*)&((*line)->entry.get_int(entry)),
-                                 4, t, debug, is_dbg, cacheable, false);
-
-      }
-    }*/
-    // invalidate all entries
-    (*line)->tag[t_cache_line::VALID].bus_write(0);
-  }
+  // it's a write-through cache, so there is never anything to write back.
+  // invalidate all entries
+  memset(m_valid, 0, m_number_of_vectors*(m_sets+1)*sizeof(*m_valid));
+  memset(m_presence, 0, ((1u << m_presence_bits) >> 5)*sizeof(*m_presence));
+  m_presence_fills = 0;
 
   // Update debug information
   CACHEFLUSH_SET(*debug);
@@ -730,44 +826,114 @@ void vectorcache::flush(sc_core::sc_time *t, unsigned int * debug, bool is_dbg)
 /// ----------------------------------------------------------------------------
 
 /// Snooping function (invalidates cache lines)
+/** @details
+*   Most writes of other masters hit lines which are not in this cache.
+*   These are dropped by the snoop filter before any tag is read. The
+*   remaining writes are handled line by line: the tags are compared once
+*   per line and the valid bits of all words written are cleared at once.
+*/
 void vectorcache::snoop_invalidate(const t_snoop& snoop, const sc_core::sc_time& delay) {
 
   unsigned address;
+  unsigned end;
   unsigned tag;
   unsigned idx;
   unsigned offset;
+  unsigned len;
   unsigned way;
 
   // Is the cache enabled
-  if (check_mode() & 0x3) {
+  if (!(check_mode() & 0x3) || !snoop.length) {
+    return;
+  }
 
-    for (address = snoop.address; address < snoop.address + snoop.length; address += 4) {
-      // Extract index and tag from address
-      tag    = get_tag(address);
-      idx    = get_idx(address);
-      offset = get_offset(address);
-      way    = 0;
+  end = snoop.address + snoop.length;
 
-      for (std::vector<t_cache_line*>::iterator line = lookup_line(idx, 0);
-           way <= m_sets; line++, way++) {
+  // Drop writes to lines the cache cannot hold
+  for (address = snoop.address; address < end; address = (address | (m_bytesperline - 1)) + 1) {
+    if (presence_test(address)) {
+      break;
+    }
+  }
+  if (address >= end) {
+    snoopfiltered++;
+    return;
+  }
 
-        // Check the cache tag
-        if (((*line)->tag[t_cache_line::ATAG]).bus_read() == tag) {
+  for (; address < end; address += len) {
+    // Extract index and tag from address
+    tag    = get_tag(address);
+    idx    = get_idx(address);
+    offset = get_offset(address);
+    // Bytes of the write inside this line
+    len    = m_bytesperline - offset;
+    if (len > end - address) {
+      len = end - address;
+    }
 
-          uint32_t tmp;
-          if (!m_new_linefetch_en) {
-            (*line)->tag[t_cache_line::VALID].bus_read(tmp);
+    // Check the cache tags
+    unsigned hits = presence_test(address)? match_ways(tag, idx) : 0;
 
-            (*line)->tag[t_cache_line::VALID].bus_write(tmp & ~offset2valid(offset));
-          } else {
-            (*line)->tag[t_cache_line::VALID].bus_write(0);
-          }
+    for (way = 0; hits; way++, hits >>= 1) {
+      if (hits & 1) {
+        unsigned line = lookup_line(idx, way);
+        if (!m_new_linefetch_en) {
+          m_valid[line] &= ~offset2valid(offset, len);
+        } else {
+          m_valid[line] = 0;
         }
+        snoopinvalidated++;
       }
     }
   }
 } // vectorcache::snoop_invalidate()
 
+/// ----------------------------------------------------------------------------
+
+/// scireg child regions: one view per cache line
+/** @details
+*   The tags and the data of the lines live in flat arrays. Views for scireg
+*   clients are only created when the first client asks for them, so that the
+*   elaboration of large caches does not create any objects per line.
+*/
+scireg_ns::scireg_response vectorcache::scireg_get_child_regions(
+    std::vector<scireg_ns::scireg_mapped_region>& mapped_regions,
+    sc_dt::uint64 size, sc_dt::uint64 offset) const {
+
+  if (!m_line_views) {
+    uint32_t lines = m_number_of_vectors*(m_sets+1);
+    m_line_views = new std::vector<t_cache_line_view*>();
+    this->mapped_regions = new std::vector<scireg_ns::scireg_mapped_region*>();
+    m_line_views->reserve(lines);
+    this->mapped_regions->reserve(lines);
+    for (uint32_t i = 0; i < lines; i++) {
+      char buffer[11];
+      snprintf(buffer, 11, "line_%d", i);
+
+      t_cache_line_view *view = new t_cache_line_view(std::string(name()) + "." + buffer,
+                                                      m_data + i*m_bytesperline, m_bytesperline);
+      view->tag.field[0] = &m_valid[i];
+      view->tag.field[1] = &m_atag[i];
+      view->tag.field[2] = &m_lrr[i];
+      view->tag.field[3] = &m_lru[i];
+      view->tag.field[4] = &m_lock[i];
+      m_line_views->push_back(view);
+
+      scireg_ns::scireg_mapped_region *mapped_region = new scireg_ns::scireg_mapped_region();
+      mapped_region->region = view;
+      mapped_region->offset = i*32;
+      mapped_region->name = buffer;
+      this->mapped_regions->push_back(mapped_region);
+    }
+  }
+
+  for (std::vector<scireg_ns::scireg_mapped_region*>::const_iterator i = this->mapped_regions->begin();
+       i != this->mapped_regions->end(); ++i) {
+    mapped_regions.push_back(**i);
+  }
+  return scireg_ns::SCIREG_SUCCESS;
+} // vectorcache::scireg_get_child_regions()
+
 /// @} Interface Control Methods
 /// ****************************************************************************
 /// @name Internal Methods
@@ -808,10 +974,30 @@ unsigned int vectorcache::offset2valid(unsigned int offset, unsigned int len) {
 
 /// ----------------------------------------------------------------------------
 
+/// Copies data out of a cache line
+void vectorcache::read_line_data(unsigned line, unsigned char *dst, unsigned len, unsigned pos) {
+  if (m_line_views) {
+    (*m_line_views)[line]->entry.execute_callbacks(scireg_ns::SCIREG_READ_ACCESS, pos, len);
+  }
+  memcpy(dst, line_data(line) + pos, len);
+} // vectorcache::read_line_data()
+
+/// ----------------------------------------------------------------------------
+
+/// Copies data into a cache line
+void vectorcache::write_line_data(unsigned line, const unsigned char *src, unsigned len, unsigned pos) {
+  memcpy(line_data(line) + pos, src, len);
+  if (m_line_views) {
+    (*m_line_views)[line]->entry.execute_callbacks(scireg_ns::SCIREG_WRITE_ACCESS, pos, len);
+  }
+} // vectorcache::write_line_data()
+
+/// ----------------------------------------------------------------------------
+
 /// Selects way to be refilled depending on replacement strategy
 unsigned int vectorcache::replacement_selector(unsigned int idx, unsigned int mode) {
 
-  std::vector<t_cache_line*>::iterator line = lookup_line(idx, 0);
+  unsigned line = lookup_line(idx, 0);
   unsigned way = 0, way_select = 0;
   uint32_t min_lru;
 
@@ -838,10 +1024,8 @@ unsigned int vectorcache::replacement_selector(unsigned int idx, unsigned int mo
       for (; way <= m_sets; line++, way++) {
 
         // The last way will never be locked.
-        uint32_t tmp_lru;
-        (*line)->tag[t_cache_line::LRU].bus_read(tmp_lru);
-        uint32_t tmp_lock;
-        (*line)->tag[t_cache_line::LRU].bus_read(tmp_lock);
+        uint32_t tmp_lru = m_lru[line];
+        uint32_t tmp_lock = m_lock[line];
         if ((tmp_lru <= min_lru) && (tmp_lock == 0)) {
           min_lru = tmp_lru;
           way_select = way;
@@ -861,7 +1045,7 @@ unsigned int vectorcache::replacement_selector(unsigned int idx, unsigned int mo
 
       for (; way <= 2; line++, way++) {
 
-        if (((*line)->tag[t_cache_line::LRR].bus_read() == 0) && ((*line)->tag[t_cache_line::LOCK].bus_read() == 0)) {
+        if ((m_lrr[line] == 0) && (m_lock[line] == 0)) {
 
           srDebug()("selected way", way)("LRR Replacement");
           way_select = way;
@@ -883,7 +1067,7 @@ unsigned int vectorcache::replacement_selector(unsigned int idx, unsigned int mo
 
       }
       // The last way will never be locked.
-      while (line[way_select]->tag[t_cache_line::LOCK].bus_read() != 0);
+      while (m_lock[line + way_select] != 0);
 
       srDebug()("selected way", way_select)("Pseudo Random Replacement");
   }
@@ -897,15 +1081,15 @@ unsigned int vectorcache::replacement_selector(unsigned int idx, unsigned int mo
 /// Updates the LRR bits for every line replacement
 void vectorcache::lrr_update(unsigned int idx, unsigned int way_select) {
 
-  std::vector<t_cache_line*>::iterator line = lookup_line(idx, 0);
+  unsigned line = lookup_line(idx, 0);
 
   // LRR may only be used for 2-way associative caches.
   for (unsigned way = 0; way < 2; line++, way++) {
 
     // Switch the lrr bit on for the selected way and off for the remaining.
-    (*line)->tag[t_cache_line::LRR].bus_write((way == way_select)? 1 : 0);
+    m_lrr[line] = (way == way_select)? 1 : 0;
 
-    srDebug()("way", way)("LRR", (*line)->tag[t_cache_line::LRR])("LRR update");
+    srDebug()("way", way)("LRR", m_lrr[line])("LRR update");
 
   }
 
@@ -916,23 +1100,21 @@ void vectorcache::lrr_update(unsigned int idx, unsigned int way_select) {
 /// Updates the LRU counters for every cache hit
 void vectorcache::lru_update(unsigned int idx, unsigned int way_select) {
 
-  std::vector<t_cache_line*>::iterator line = lookup_line(idx, 0);
-  uint32_t pivot = (*lookup_line(idx, way_select))->tag[t_cache_line::LRU].bus_read();
+  unsigned line = lookup_line(idx, 0);
+  uint32_t pivot = m_lru[line + way_select];
   unsigned lru;
 
   for (unsigned way = 0; way <= m_sets; line++, way++) {
-    lru = (*line)->tag[t_cache_line::LRU].bus_read();
+    lru = m_lru[line];
 
     // LRU: Counter for each line of a way
     if (way == way_select) {
-      (*line)->tag[t_cache_line::LRU].bus_write(m_max_lru);
-    } else if ((*line)->tag[t_cache_line::LRU].bus_read() > pivot) {
-      uint32_t tmp_lru;
-      (*line)->tag[t_cache_line::LRU].bus_read(tmp_lru);
-      (*line)->tag[t_cache_line::LRU].bus_write(tmp_lru-1);
+      m_lru[line] = m_max_lru;
+    } else if (lru > pivot) {
+      m_lru[line] = lru-1;
     }
 
-    srDebug()("way", way)("old LRU", lru)("new LRU", (*line)->tag[t_cache_line::LRU])("LRU update");
+    srDebug()("way", way)("old LRU", lru)("new LRU", m_lru[line])("LRU update");
 
   }
 
@@ -949,21 +1131,20 @@ int vectorcache::locate_line(unsigned int const tag,
   unsigned way = 0;
   bool found = false;
 
-  // Lookup all cache ways
-  for (std::vector<t_cache_line*>::iterator line = lookup_line(idx, 0);
-       way <= m_sets; line++, way++) {
+  // Compare the tags of all cache ways
+  unsigned hits = match_ways(tag, idx);
+
+  for (; hits; way++, hits >>= 1) {
 
-    // Check the cache tag
-    if ((*line)->tag[t_cache_line::ATAG].bus_read() == tag) {
+    if (hits & 1) {
 
       // Check the valid bit
-      uint32_t tmp_valid;
-      (*line)->tag[t_cache_line::VALID].bus_read(tmp_valid);
+      uint32_t tmp_valid = m_valid[lookup_line(idx, way)];
       if ((!m_new_linefetch_en && (tmp_valid & offset2valid(offset, len)) == offset2valid(offset, len))
       || (m_new_linefetch_en && (tmp_valid & 0x1))) {
 
         srDebug()("way", way)
-                 ("valid", (*line)->tag[t_cache_line::VALID])
+                 ("valid", tmp_valid)
                  ("valid mask",offset2valid(offset, len))
                  ("Cache hit in current way");
         found = true;
@@ -971,7 +1152,7 @@ int vectorcache::locate_line(unsigned int const tag,
       } else {
 
         srDebug()("way", way)
-                 ("valid", (*line)->tag[t_cache_line::VALID])
+                 ("valid", tmp_valid)
                  ("valid mask",offset2valid(offset, len))
                  ("Cache hit but invalid data in current way");
 
@@ -1007,31 +1188,41 @@ int vectorcache::update_line (unsigned const tag,
                               unsigned int * debug,
                               bool& cacheable, bool is_dbg) {
 
-    t_cache_line* line = (*lookup_line(idx, way));
+    unsigned line = lookup_line(idx, way);
 
     // Update data in cache
     // This is written generically to serve both aligned reads and non-aligned
     // writes.
-    line->entry.copy_to(data, len, offset >> 2, offset & 0x3);
+    write_line_data(line, data, len, offset);
 
     // Update tag and flags for line allocate
-    if (line->tag[t_cache_line::ATAG].bus_read() != tag) {
+    if (m_atag[line] != tag) {
 
-      line->tag[t_cache_line::ATAG].bus_write(tag);
+      m_atag[line] = tag;
 
       if (m_repl == 2) lrr_update(idx, way);
 
-      line->tag[t_cache_line::VALID].bus_write(0);
+      m_valid[line] = 0;
+
+    }
+
+    // A line turning valid must be visible to the snoop filter, also when
+    // it keeps the tag it had before a flush or snoop invalidation
+    if (!m_valid[line]) {
+
+      // Stale bits of evicted lines accumulate in the snoop filter
+      if (++m_presence_fills > (m_number_of_vectors*(m_sets+1) << 1)) {
+        presence_rebuild();
+      }
+      presence_set(get_address(tag, idx, 0));
 
     }
 
     // Update flags for line allocate or update
     if (!m_new_linefetch_en) {
-      uint32_t tmp_valid;
-      line->tag[t_cache_line::VALID].bus_read(tmp_valid);
-      line->tag[t_cache_line::VALID].bus_write(tmp_valid | offset2valid(offset, len));
+      m_valid[line] |= offset2valid(offset, len);
     } else {
-      line->tag[t_cache_line::VALID].bus_write(0x1);
+      m_valid[line] = 0x1;
     }
     if (m_repl == 1) lru_update(idx, way);
 
@@ -1060,6 +1251,25 @@ int vectorcache::update_line (unsigned const tag,
 
 /// ----------------------------------------------------------------------------
 
+/// Rebuilds the snoop filter from the valid lines
+void vectorcache::presence_rebuild() {
+
+  memset(m_presence, 0, ((1u << m_presence_bits) >> 5)*sizeof(*m_presence));
+  m_presence_fills = 0;
+
+  for (unsigned idx = 0; idx < m_number_of_vectors; idx++) {
+    for (unsigned way = 0; way <= m_sets; way++) {
+      unsigned line = lookup_line(idx, way);
+      if (m_valid[line]) {
+        presence_set(get_address(m_atag[line], idx, 0));
+      }
+    }
+  }
+
+} // vectorcache::presence_rebuild()
+
+/// ----------------------------------------------------------------------------
+
 /// Reads data from memory and inserts it into cache.
 /// Returns the allocated way, otherwise -1.
 /// Used by mem_read() and mem_write() with write-allocate.
@@ -1074,11 +1284,10 @@ int vectorcache::allocate_line (unsigned const tag,
   bool found = false;
 
   // Easiest option for replacement is using invalid cache lines.
-  for (std::vector<t_cache_line*>::iterator line = lookup_line(idx, 0);
+  for (unsigned line = lookup_line(idx, 0);
        way <= m_sets; line++, way++) {
 
-    uint32_t tmp_valid;
-    (*line)->tag[t_cache_line::VALID].bus_read(tmp_valid);
+    uint32_t tmp_valid = m_valid[line];
     if ((!m_new_linefetch_en && (tmp_valid & offset2valid(offset, len)) == 0 /* == offset2valid(offset, len) instead of 0? */)
     || (m_new_linefetch_en && (tmp_valid & 0x1) == 0)) {
 
@@ -1114,13 +1323,13 @@ void vectorcache::dbg_out(unsigned int idx) {
 
   unsigned way = 0;
 
-  for (std::vector<t_cache_line*>::iterator line = lookup_line(idx, 0);
+  for (unsigned line = lookup_line(idx, 0);
        way <= m_sets; line++, way++) {
 
     // display the tag
-    srDebug()("tag", (*line)->tag[t_cache_line::ATAG])
+    srDebug()("tag", m_atag[line])
              ("way", way)
-             ("valid", (*line)->tag[t_cache_line::VALID])
+             ("valid", m_valid[line])
              ("Diagnostic cache line display (big-endian)");
 
     // display all entries
@@ -1129,7 +1338,7 @@ void vectorcache::dbg_out(unsigned int idx) {
       std::cout << "Entry: " << j << " - ";
 
       for (unsigned k = 0; k < 4; k++) {
-        std::cout << hex << std::setw(2) << (unsigned)(*line)->entry.get_char(j, k);
+        std::cout << hex << std::setw(2) << (unsigned)line_data(line)[(j << 2) + k];
       }
 
       std::cout << " " << std::endl;
@@ -1193,6 +1402,8 @@ void vectorcache::end_of_simulation() {
   }
 
   v::report << name() << " * Bypass ops:   " << bypassops << v::endl;
+  v::report << name() << " * Snoops filtered: " << snoopfiltered << v::endl;
+  v::report << name() << " * Lines invalidated by snooping: " << snoopinvalidated << v::endl;
   v::report << name() << " ******************************************** " << v::endl;
 
 } // vectorcache::end_of_simulation()
@@ -19,6 +19,8 @@
 
 #include <vector>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include <string>
 #include <sstream>
 #include "core/common/base.h"
@@ -54,6 +56,16 @@ public:
                          unsigned int len, sc_core::sc_time * t,
                          unsigned int * debug, bool is_dbg, bool &cacheable, bool is_lock);
 
+  /// Host pointer to a valid cache line for the fetch line buffer
+  virtual const unsigned char *get_line_ptr(unsigned int address, unsigned int asi,
+                                            unsigned int &way, unsigned int &valid,
+                                            unsigned int &linesize);
+  /// Account read hits served by the fetch line buffer
+  virtual void add_read_hits(unsigned int way, uint64_t hits);
+  /// Account a read hit served by the shadow TLB
+  virtual bool read_hit(unsigned int address, unsigned int asi, unsigned int len,
+                        sc_core::sc_time * t, unsigned int * debug);
+
   /// @} Interface Data Methods
   /// --------------------------------------------------------------------------
   /// @name Interface Control Methods
@@ -92,16 +104,11 @@ public:
   }
 
   /// Get child regions mapped into this region, by returning a mapped region object representing each mapping.
-  /// The size and offset parameters can be used to constrain the range of the search
+  /// The size and offset parameters can be used to constrain the range of the search.
+  /// The line views are created on the first request.
   virtual scireg_ns::scireg_response scireg_get_child_regions(
       std::vector<scireg_ns::scireg_mapped_region>& mapped_regions,
-      sc_dt::uint64 size=sc_dt::uint64(-1), sc_dt::uint64 offset=0) const {
-   for (std::vector<scireg_ns::scireg_mapped_region*>::const_iterator i = this->mapped_regions->begin();
-       i != this->mapped_regions->end(); ++i) {
-     mapped_regions.push_back(**i);
-   }
-    return scireg_ns::SCIREG_SUCCESS;
-  }
+      sc_dt::uint64 size=sc_dt::uint64(-1), sc_dt::uint64 offset=0) const;
 
   /// @} Interface Control Methods
   /// --------------------------------------------------------------------------
@@ -130,10 +137,56 @@ protected:
   /// Updates the lrr bits for every line replacement
   void lrr_update(unsigned int idx, unsigned int set_select);
 
-  /// Reads a cache line from a given cache way.
-  /// Returns an iterator to found line (more useful than pointer for looping through ways of a given index).
-  /// Returns null for incorrect parameters.
-  inline std::vector<t_cache_line*>::iterator lookup_line(unsigned idx, unsigned way) {return (cache_mem->begin())+(idx*(m_sets+1)+way);}
+  /// Number of the line of a given cache way in the tag and data arrays.
+  /// The lines of a set are adjacent.
+  inline unsigned lookup_line(unsigned idx, unsigned way) {return idx*(m_sets+1)+way;}
+
+  /// Host pointer to the data of a line
+  inline unsigned char *line_data(unsigned line) {return m_data + line*m_bytesperline;}
+
+  /// Bit of the snoop filter for the line holding an address.
+  /// Folds the upper line address bits onto the lower ones.
+  inline unsigned presence_bit(unsigned address) {
+    unsigned line = address >> m_offset_bits;
+    return (line ^ (line >> m_presence_bits)) & ((1u << m_presence_bits) - 1);
+  }
+
+  /// Marks the line holding an address as present in the snoop filter
+  inline void presence_set(unsigned address) {
+    unsigned bit = presence_bit(address);
+    m_presence[bit >> 5] |= 1u << (bit & 31);
+  }
+
+  /// False if no line holding an address can be in the cache
+  inline bool presence_test(unsigned address) {
+    unsigned bit = presence_bit(address);
+    return (m_presence[bit >> 5] >> (bit & 31)) & 1;
+  }
+
+  /// Rebuilds the snoop filter from the valid lines
+  void presence_rebuild();
+
+  /// Returns a bit mask of the ways of a set whose tag matches.
+  /// Compares all ways at once, without early exit, so that the loop vectorizes.
+  inline unsigned match_ways(unsigned tag, unsigned idx) {
+    const unsigned *atag = m_atag + lookup_line(idx, 0);
+    unsigned hits = 0;
+    for (unsigned way = 0; way <= m_sets; way++) {
+      hits |= (unsigned)(atag[way] == tag) << way;
+    }
+    return hits;
+  }
+
+  /// True if a scireg client observes the data of a line
+  inline bool line_observed(unsigned line) {
+    return m_line_views && (*m_line_views)[line]->entry.has_callbacks();
+  }
+
+  /// Copies data out of a line and notifies scireg observers
+  void read_line_data(unsigned line, unsigned char *dst, unsigned len, unsigned pos);
+
+  /// Copies data into a line and notifies scireg observers
+  void write_line_data(unsigned line, const unsigned char *src, unsigned len, unsigned pos);
 
   /// Searches for a cache tag in all cache ways. Updates power information for reading tags.
   /// Returns found way if tag matches and data is valid, otherwise -1.
@@ -233,11 +286,20 @@ protected:
   /// [31]    Cache locking (CL) - Set if cache locking is implemented
   unsigned int CACHE_CONFIG_REG;
 
-  /// The actual cache memory
-  std::vector<t_cache_line*> *cache_mem;
+  /// The actual cache memory: one tag array per field and a single buffer
+  /// for the data of all lines, all indexed by lookup_line()
+  unsigned *m_atag;
+  unsigned *m_valid;
+  unsigned *m_lrr;
+  unsigned *m_lru;
+  unsigned *m_lock;
+  unsigned char *m_data;
+
+  /// scireg views of the cache lines, created on demand
+  mutable std::vector<t_cache_line_view*> *m_line_views;
 
   /// The children scireg_reagion_ifs
-  std::vector<scireg_ns::scireg_mapped_region*> *mapped_regions;
+  mutable std::vector<scireg_ns::scireg_mapped_region*> *mapped_regions;
 
   /// Indicates whether the cache can be put in burst mode or not
   unsigned int m_burst_en;
@@ -247,6 +309,15 @@ protected:
   /// Pseudo-random pointer
   unsigned int m_pseudo_rand;
 
+  /// Snoop filter: one bit per hashed line address, set for every
+  /// allocated line. Evictions do not clear bits, so the filter is
+  /// rebuilt from the valid lines after a number of allocations.
+  uint32_t *m_presence;
+  /// Log2 of the number of bits in the snoop filter
+  unsigned int m_presence_bits;
+  /// Lines allocated since the last rebuild of the snoop filter
+  unsigned int m_presence_fills;
+
   /// @} Data
   /// --------------------------------------------------------------------------
   /// @name Parameters
@@ -318,6 +389,12 @@ protected:
   /// Counter for bypass operations
   sr_param<uint64_t> bypassops;
 
+  /// Counter for snooped writes dropped by the snoop filter
+  sr_param<uint64_t> snoopfiltered;
+
+  /// Counter for cache lines invalidated by snooping
+  sr_param<uint64_t> snoopinvalidated;
+
   /// Enable power monitoring
   bool m_pow_mon;
 
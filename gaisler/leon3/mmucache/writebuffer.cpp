@@ -0,0 +1,110 @@
+// vim : set fileencoding=utf-8 expandtab noai ts=4 sw=4 :
+/// @addtogroup mmu_cache
+/// @{
+/// @file writebuffer.cpp
+/// Implementation of the coalescing write buffer of the data cache.
+///
+/// @date 2026
+/// @copyright All rights reserved.
+///            Any reproduction, use, distribution or disclosure of this
+///            program, without the express, prior written consent of the
+///            authors is strictly prohibited.
+/// @author agent
+///
+
+#include <string.h>
+
+#include "gaisler/leon3/mmucache/writebuffer.h"
+
+/// Constructor - buffering is off until configured
+writebuffer::writebuffer() :
+  m_stores(0),
+  m_bursts(0),
+  m_addr(0),
+  m_asi(0),
+  m_length(0),
+  m_window(4),
+  m_policy(WB_OFF) {
+
+}
+
+// Sets burst window and drain policy
+void writebuffer::configure(unsigned int depth, unsigned int policy) {
+
+  unsigned int words = 1;
+
+  // Round the window down to a power of two
+  if (depth > MAX_DEPTH) {
+    depth = MAX_DEPTH;
+  }
+  while ((words << 1) <= depth) {
+    words <<= 1;
+  }
+
+  m_window = words << 2;
+  m_policy = (policy > WB_FULL)? WB_FULL : policy;
+  m_length = 0;
+
+}
+
+// Merges a store into the buffer
+bool writebuffer::merge(unsigned int addr, unsigned int asi, const unsigned char *data, unsigned int len) {
+
+  if (m_length == 0) {
+
+    // The store must not cross the burst window
+    if ((addr & ~(m_window - 1)) != ((addr + len - 1) & ~(m_window - 1))) {
+      return false;
+    }
+
+    m_addr = addr;
+    m_asi = asi;
+
+  } else {
+
+    unsigned int window = m_addr & ~(m_window - 1);
+
+    // Only stores starting inside or right behind the buffered bytes and
+    // ending inside the window keep the burst contiguous
+    if ((addr < m_addr) || (addr > m_addr + m_length) ||
+        (addr + len > window + m_window)) {
+      return false;
+    }
+
+  }
+
+  memcpy(m_data + (addr - m_addr), data, len);
+
+  if (addr + len > m_addr + m_length) {
+    m_length = addr + len - m_addr;
+  }
+
+  m_stores++;
+  return true;
+
+}
+
+// Copies buffered bytes into the data of an overlapping read
+void writebuffer::forward(unsigned int addr, unsigned char *data, unsigned int len) const {
+
+  unsigned int start = (addr > m_addr)? addr : m_addr;
+  unsigned int end = ((addr + len) < (m_addr + m_length))? addr + len : m_addr + m_length;
+
+  if (start < end) {
+    memcpy(data + (start - addr), m_data + (start - m_addr), end - start);
+  }
+
+}
+
+// Applies a debug write to the overlapping buffered bytes
+void writebuffer::update(unsigned int addr, const unsigned char *data, unsigned int len) {
+
+  unsigned int start = (addr > m_addr)? addr : m_addr;
+  unsigned int end = ((addr + len) < (m_addr + m_length))? addr + len : m_addr + m_length;
+
+  if (start < end) {
+    memcpy(m_data + (start - m_addr), data + (start - addr), end - start);
+  }
+
+}
+/// @}
@@ -0,0 +1,139 @@
+// vim : set fileencoding=utf-8 expandtab noai ts=4 sw=4 :
+/// @addtogroup mmu_cache
+/// @{
+/// @file writebuffer.h
+/// Class definition of the coalescing write buffer of the data cache. The
+/// write buffer sits between the data cache and the AHB master and merges
+/// stores to consecutive addresses into burst transactions.
+///
+/// @date 2026
+/// @copyright All rights reserved.
+///            Any reproduction, use, distribution or disclosure of this
+///            program, without the express, prior written consent of the
+///            authors is strictly prohibited.
+/// @author agent
+///
+
+#ifndef __WRITEBUFFER_H__
+#define __WRITEBUFFER_H__
+
+#include <stdint.h>
+
+// The write buffer holds a single burst. A store is merged if it starts
+// inside or right behind the buffered bytes and does not leave the burst
+// window, an aligned block of 'depth' words. Any other store drains the
+// buffer first. The owner drains the buffer before reads and locked
+// accesses, which keeps read-after-write ordering on the bus, and whenever
+// the cpu synchronizes, so that other masters see the stores at the latest
+// at the end of the quantum. Draining splits the buffered bytes into a
+// burst of whole words and naturally aligned byte and halfword stores
+// before and after it. Buffering is off unless a policy is configured.
+// Drain policies:
+//   WB_OFF  - no buffering, every store is a transaction of its own
+//   WB_LAZY - the buffer is drained when a store does not fit
+//   WB_FULL - like WB_LAZY, but a full window is drained right away
+
+/// @brief Coalescing write buffer
+class writebuffer {
+
+ public:
+
+  /// Drain policies
+  enum t_policy { WB_OFF = 0, WB_LAZY = 1, WB_FULL = 2 };
+
+  /// Largest burst window in words
+  static const unsigned int MAX_DEPTH = 64;
+
+  writebuffer();
+
+  /// Sets the burst window in words (rounded down to a power of two) and
+  /// the drain policy
+  void configure(unsigned int depth, unsigned int policy);
+
+  /// True if stores are buffered at all
+  bool enabled() const {
+    return m_policy != WB_OFF;
+  }
+
+  /// True if no store is buffered
+  bool empty() const {
+    return m_length == 0;
+  }
+
+  /// True if the buffered bytes fill the burst window (WB_FULL only)
+  bool drain_full() const {
+    return (m_policy == WB_FULL) && (m_length == m_window);
+  }
+
+  /// Merges a store into the buffer. Returns false if the store does not
+  /// fit and the buffer has to be drained first.
+  bool merge(unsigned int addr, unsigned int asi, const unsigned char *data, unsigned int len);
+
+  /// Copies the buffered bytes overlapping a read into its data
+  void forward(unsigned int addr, unsigned char *data, unsigned int len) const;
+
+  /// Applies a debug write to the buffered bytes it overlaps
+  void update(unsigned int addr, const unsigned char *data, unsigned int len);
+
+  /// Length of the next transfer when draining remaining bytes from addr.
+  /// Whole words go out as one burst, subwords naturally aligned.
+  static unsigned int transfer_length(unsigned int addr, unsigned int remaining) {
+    if (!(addr & 0x3) && (remaining >= 4)) {
+      return remaining & ~0x3;
+    }
+    if (!(addr & 0x1) && (remaining >= 2)) {
+      return 2;
+    }
+    return 1;
+  }
+
+  /// Empties the buffer after the burst has been issued
+  void clear() {
+    m_length = 0;
+  }
+
+  /// Start address of the buffered burst
+  unsigned int address() const {
+    return m_addr;
+  }
+
+  /// ASI of the first buffered store
+  unsigned int asi() const {
+    return m_asi;
+  }
+
+  /// Length of the buffered burst in bytes
+  unsigned int length() const {
+    return m_length;
+  }
+
+  /// Buffered data
+  unsigned char *data() {
+    return m_data;
+  }
+
+  /// Number of stores taken by the buffer
+  uint64_t m_stores;
+
+  /// Number of bursts drained from the buffer
+  uint64_t m_bursts;
+
+ private:
+
+  /// Start address of the buffered bytes
+  unsigned int m_addr;
+  /// ASI of the first buffered store
+  unsigned int m_asi;
+  /// Number of buffered bytes
+  unsigned int m_length;
+  /// Size of the burst window in bytes
+  unsigned int m_window;
+  /// Drain policy
+  unsigned int m_policy;
+  /// Buffered data
+  unsigned char m_data[MAX_DEPTH * 4];
+
+};
+
+#endif // __WRITEBUFFER_H__
+/// @}
@@ -0,0 +1,123 @@
+// vim : set fileencoding=utf-8 expandtab noai ts=4 sw=4 :
+/// @addtogroup mmu_cache
+/// @{
+/// @file vectorcache_presence.cpp
+/// Checks that the snoop filter of the vectorcache sees lines which are
+/// refilled with the tag they held before a flush: a write of another bus
+/// master to such a line must invalidate it.
+///
+/// @date 2026
+/// @copyright All rights reserved.
+///            Any reproduction, use, distribution or disclosure of this
+///            program, without the express, prior written consent of the
+///            authors is strictly prohibited.
+/// @author agent
+///
+
+#include <stdint.h>
+#include <string.h>
+#include <iostream>
+
+#include "core/common/systemc.h"
+#include "core/common/sr_param.h"
+#include "core/common/sr_report.h"
+#include "gaisler/leon3/mmucache/mmu_cache_if.h"
+#include "gaisler/leon3/mmucache/dvectorcache.h"
+
+/// Memory and cache control seen by the cache under test. Stands in for
+/// both the mmu_cache and the tlb_adaptor.
+class test_memory : public mmu_cache_if {
+
+ public:
+
+  test_memory() : m_ccr(0xf), m_reads(0) {
+    memset(m_data, 0, sizeof(m_data));
+  }
+
+  unsigned int read_ccr(bool internal) {
+    return m_ccr;
+  }
+
+  bool mem_read(uint32_t addr, uint32_t asi, uint8_t * data,
+                uint32_t length, sc_core::sc_time * t,
+                uint32_t * debug, bool is_dbg, bool &cacheable, bool is_lock = false) {
+    memcpy(data, m_data + (addr % sizeof(m_data)), length);
+    m_reads++;
+    cacheable = true;
+    return true;
+  }
+
+  void mem_write(uint32_t addr, uint32_t asi, uint8_t * data,
+                 uint32_t length, sc_core::sc_time * t,
+                 uint32_t * debug, bool is_dbg, bool &cacheable, bool is_lock = false) {
+    memcpy(m_data + (addr % sizeof(m_data)), data, length);
+    cacheable = true;
+  }
+
+  /// Cache control register: data cache enabled
+  unsigned int m_ccr;
+
+  /// Number of reads which reached the memory
+  unsigned int m_reads;
+
+  /// Backing store, mirrored over the whole address space
+  uint8_t m_data[0x1000];
+
+};
+
+/// Reads one word through the cache
+static uint32_t cache_read(dvectorcache &cache, uint32_t address) {
+  uint32_t word = 0;
+  unsigned int debug = 0;
+  bool cacheable = true;
+  sc_core::sc_time delay;
+  cache.mem_read(address, 0xb, reinterpret_cast<unsigned char *>(&word), 4,
+                 &delay, &debug, false, cacheable, false);
+  return word;
+}
+
+int sc_main(int argc, char** argv) {
+  sr_report_handler::handler = sr_report_handler::default_handler;
+
+  gs::ctr::GC_Core       core;
+  gs::cnf::ConfigDatabase cnfdatabase("ConfigDatabase");
+  gs::cnf::ConfigPlugin configPlugin(&cnfdatabase);
+
+  // Direct mapped, 4kB way, 4 words per line
+  test_memory memory;
+  dvectorcache cache("dcache", &memory, &memory, 0, 1, 4, 0, 4, 0, 0, 0, 0, false);
+
+  const uint32_t address = 0x40000100;
+  uint32_t word = 0x11111111;
+  unsigned int debug = 0;
+  bool cacheable = true;
+  sc_core::sc_time delay;
+  t_snoop snoop;
+
+  memory.mem_write(address, 0xb, reinterpret_cast<uint8_t *>(&word), 4, &delay, &debug, false, cacheable);
+
+  // Allocate the line, flush it and refill it with the same tag
+  cache_read(cache, address);
+  cache.flush(&delay, &debug, false);
+  if (cache_read(cache, address) != 0x11111111 || memory.m_reads != 2) {
+    std::cerr << "Refill after flush not served from memory" << std::endl;
+    return 1;
+  }
+
+  // Another master overwrites the word and the cache snoops the write
+  word = 0x22222222;
+  memory.mem_write(address, 0xb, reinterpret_cast<uint8_t *>(&word), 4, &delay, &debug, false, cacheable);
+  snoop.master_id = 1;
+  snoop.address = address;
+  snoop.length = 4;
+  cache.snoop_invalidate(snoop, delay);
+
+  if (cache_read(cache, address) != 0x22222222 || memory.m_reads != 3) {
+    std::cerr << "Snooped write to a refilled line was filtered, stale data read" << std::endl;
+    return 1;
+  }
+
+  std::cout << "vectorcache presence test passed" << std::endl;
+  return 0;
+}
+/// @}
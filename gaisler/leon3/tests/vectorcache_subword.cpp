@@ -0,0 +1,125 @@
+// vim : set fileencoding=utf-8 expandtab noai ts=4 sw=4 :
+/// @addtogroup mmu_cache
+/// @{
+/// @file vectorcache_subword.cpp
+/// Checks that byte and halfword loads which hit in the vectorcache return
+/// the bytes at their own offset in the line, also in the last word of a
+/// line and in the last line of the cache.
+///
+/// @date 2026
+/// @author agent
+///
+
+#include <stdint.h>
+#include <string.h>
+#include <iostream>
+
+#include "core/common/systemc.h"
+#include "core/common/sr_param.h"
+#include "core/common/sr_report.h"
+#include "gaisler/leon3/mmucache/mmu_cache_if.h"
+#include "gaisler/leon3/mmucache/dvectorcache.h"
+
+/// Memory and cache control seen by the cache under test. Stands in for
+/// both the mmu_cache and the tlb_adaptor.
+class test_memory : public mmu_cache_if {
+
+ public:
+
+  test_memory() : m_ccr(0xf), m_reads(0) {
+    for (unsigned int i = 0; i < sizeof(m_data); i++) {
+      m_data[i] = (uint8_t)(i * 7 + 1);
+    }
+  }
+
+  unsigned int read_ccr(bool internal) {
+    return m_ccr;
+  }
+
+  bool mem_read(uint32_t addr, uint32_t asi, uint8_t * data,
+                uint32_t length, sc_core::sc_time * t,
+                uint32_t * debug, bool is_dbg, bool &cacheable, bool is_lock = false) {
+    memcpy(data, m_data + (addr % sizeof(m_data)), length);
+    m_reads++;
+    cacheable = true;
+    return true;
+  }
+
+  void mem_write(uint32_t addr, uint32_t asi, uint8_t * data,
+                 uint32_t length, sc_core::sc_time * t,
+                 uint32_t * debug, bool is_dbg, bool &cacheable, bool is_lock = false) {
+    memcpy(m_data + (addr % sizeof(m_data)), data, length);
+    cacheable = true;
+  }
+
+  /// Cache control register: data cache enabled
+  unsigned int m_ccr;
+
+  /// Number of reads which reached the memory
+  unsigned int m_reads;
+
+  /// Backing store, mirrored over the whole address space
+  uint8_t m_data[0x1000];
+
+};
+
+/// Loads len bytes at address through the cache and compares them with the
+/// memory. Returns false on a mismatch.
+static bool check_load(dvectorcache &cache, test_memory &memory, uint32_t address, uint32_t len) {
+  uint8_t data[4] = {0, 0, 0, 0};
+  unsigned int debug = 0;
+  bool cacheable = true;
+  sc_core::sc_time delay;
+  cache.mem_read(address, 0xb, data, len, &delay, &debug, false, cacheable, false);
+  if (memcmp(data, memory.m_data + (address % sizeof(memory.m_data)), len)) {
+    std::cerr << "Load of " << len << " bytes at 0x" << std::hex << address
+              << " returned the wrong bytes" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+/// Allocates the line at base and loads bytes and halfwords at offsets 1, 2
+/// and 3 of each of its words, which all have to hit
+static bool check_line(dvectorcache &cache, test_memory &memory, uint32_t base) {
+  unsigned int reads = memory.m_reads;
+  bool ok = check_load(cache, memory, base, 4);
+  for (uint32_t word = 0; word < 16; word += 4) {
+    for (uint32_t byt = 1; byt < 4; byt++) {
+      ok &= check_load(cache, memory, base + word + byt, 1);
+      // A halfword at offset 3 of the last word would leave the line
+      if (word + byt + 2 <= 16) {
+        ok &= check_load(cache, memory, base + word + byt, 2);
+      }
+    }
+  }
+  if (memory.m_reads != reads + 1) {
+    std::cerr << "Loads from the line at 0x" << std::hex << base
+              << " missed in the cache" << std::endl;
+    ok = false;
+  }
+  return ok;
+}
+
+int sc_main(int argc, char** argv) {
+  sr_report_handler::handler = sr_report_handler::default_handler;
+
+  gs::ctr::GC_Core       core;
+  gs::cnf::ConfigDatabase cnfdatabase("ConfigDatabase");
+  gs::cnf::ConfigPlugin configPlugin(&cnfdatabase);
+
+  // Direct mapped, 4kB way, 4 words per line
+  test_memory memory;
+  dvectorcache cache("dcache", &memory, &memory, 0, 1, 4, 0, 4, 0, 0, 0, 0, false);
+
+  bool ok = check_line(cache, memory, 0x40000100);
+  // Last line of the cache
+  ok &= check_line(cache, memory, 0x40000ff0);
+  if (!ok) {
+    return 1;
+  }
+
+  std::cout << "vectorcache subword test passed" << std::endl;
+  return 0;
+}
+/// @}
@@ -910,6 +910,8 @@ void Mctrl::mcfg1_write() {
            << " new MCFG1: " << v::uint32 << mcfg
            << " ram8,16: " << g_ram8 << "," << g_ram16 << v::endl;
   r[MCFG1].write(mcfg);
+  // Width and waitstates change the timing of direct accesses
+  ahb->invalidate_direct_mem_ptr(0, 0xFFFFFFFFull);
 }
 
 void Mctrl::mcfg2_write() {
@@ -933,6 +935,8 @@ void Mctrl::mcfg2_write() {
            << " new MCFG2: " << v::uint32 << mcfg
            << " ram8,16: " << g_ram8 << "," << g_ram16 << v::endl;
   r[MCFG2].write(mcfg);
+  // Mapping, width and waitstates of the rams may have changed
+  ahb->invalidate_direct_mem_ptr(0, 0xFFFFFFFFull);
 }
 
 Mctrl::MEMPort Mctrl::get_port(uint32_t addr) {
@@ -1068,6 +1072,13 @@ bool Mctrl::get_direct_mem_ptr(tlm::tlm_generic_payload& trans, tlm::tlm_dmi& dm
       end = port.base_addr + dmi_data.get_end_address();
       dmi_data.set_start_address(start);
       dmi_data.set_end_address(end);
+      // Fixed delay of a read (RCD for SDRAM), the words are charged by
+      // the initiator
+      if (port.dev->get_type() == MEMDevice::SDRAM) {
+        dmi_data.set_read_latency((2 + (r[MCFG2].bit(30) ? 3 : 2)) * clock_cycle);
+      } else {
+        dmi_data.set_read_latency(SC_ZERO_TIME);
+      }
     }
   }
   return result;